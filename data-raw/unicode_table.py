@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+#
+# Generate the two-stage table of character classes of the BMP used by
+# unicode_class() in src/unicode.c, from the Unicode database of Python:
+#
+#     python3 data-raw/unicode_table.py > /tmp/unicode_table.c
+#
+# and replace the part of src/unicode.c between the "generated" markers.
+#
+# Classes (2 bits, 4 characters per byte, lowest bits first):
+#     0 UNICODE_SYMBOL   anything else (including letters without case, e.g. CJK)
+#     1 UNICODE_UPPER    general category Lu or Lt
+#     2 UNICODE_LOWER    general category Ll
+#     3 UNICODE_NUMBER   general category Nd
+
+import sys
+import unicodedata
+
+BLOCK = 256
+
+def cls(c):
+    cat = unicodedata.category(chr(c))
+    if cat in ("Lu", "Lt"):
+        return 1
+    if cat == "Ll":
+        return 2
+    if cat == "Nd":
+        return 3
+    return 0
+
+blocks = []
+index = []
+for b in range(0x10000 // BLOCK):
+    packed = bytearray(BLOCK // 4)
+    for i in range(BLOCK):
+        packed[i // 4] |= cls(b * BLOCK + i) << (2 * (i % 4))
+    packed = bytes(packed)
+    if packed not in blocks:
+        blocks.append(packed)
+    index.append(blocks.index(packed))
+
+out = sys.stdout
+out.write("/* generated by data-raw/unicode_table.py from Unicode %s */\n"
+          % unicodedata.unidata_version)
+out.write("#define UNICODE_NBLOCKS (%d)\n\n" % len(blocks))
+out.write("static const unsigned char unicode_stage1[ 0x10000 / UNICODE_BLOCKSIZE ] = {\n")
+for i in range(0, len(index), 16):
+    out.write("\t" + ", ".join("%3d" % x for x in index[i:i + 16]) + ",\n")
+out.write("};\n\n")
+out.write("static const unsigned char unicode_stage2[ UNICODE_NBLOCKS ][ UNICODE_BLOCKSIZE / 4 ] = {\n")
+for n, blk in enumerate(blocks):
+    out.write("\t{ /* %d */\n" % n)
+    for i in range(0, len(blk), 16):
+        out.write("\t\t" + ", ".join("0x%02x" % x for x in blk[i:i + 16]) + ",\n")
+    out.write("\t},\n")
+out.write("};\n")
+out.write("/* end of generated part */\n")
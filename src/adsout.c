@@ -37,8 +37,7 @@
 // The journals are now obtained from the R call.
 // extern const char *journals[];
 // extern const int njournals;
-extern char **journals;
-extern int njournals;
+// (Georgi) 2026-10-17: and are passed in pm->ctx, see bibl_context in bibutils.h
 
 /*****************************************************
  PUBLIC: int adsout_initparams()
@@ -502,7 +501,7 @@ get_firstinitial( fields *in )
 }
 
 static int
-get_journalabbr( fields *in )
+get_journalabbr( fields *in, char **journals, int njournals )
 {
 	char *jrnl;
 	int n, j;
@@ -519,11 +518,12 @@ get_journalabbr( fields *in )
 }
 
 static void
-append_Rtag( fields *in, char *adstag, int type, fields *out, int *status )
+append_Rtag( fields *in, char *adstag, int type, fields *out, int *status, bibl_context *ctx )
 {
 	char outstr[20], ch;
 	int n, i, fstatus;
 	long long page;
+	char **journals = ctx->journals;
 
 	strcpy( outstr, "..................." );
 
@@ -533,7 +533,7 @@ append_Rtag( fields *in, char *adstag, int type, fields *out, int *status )
 	if ( n!=FIELDS_NOTFOUND ) output_4digit_value( outstr, atoi( fields_value( in, n, FIELDS_CHRP ) ) );
 
 	/** JJJJ */
-	n = get_journalabbr( in );
+	n = get_journalabbr( in, journals, ctx->njournals );
 	if ( n!=-1 ) {
 		i = 0;
 		while ( i<5 && journals[n][i]!=' ' && journals[n][i]!='\t' ) {
@@ -681,7 +681,7 @@ adsout_assemble( fields *in, fields *out, param *pm, unsigned long refnum )
 	fields_clear_used( in );
 	type = get_type( in );
 
-	append_Rtag   ( in, "%R", type, out, &status );
+	append_Rtag   ( in, "%R", type, out, &status, pm->ctx );
 	append_people ( in, "AUTHOR", "AUTHOR:ASIS", "AUTHOR:CORP", "%A", LEVEL_MAIN, out, &status );
 	append_people ( in, "EDITOR", "EDITOR:ASIS", "EDITOR:CORP", "%E", LEVEL_ANY,  out, &status );
 	append_easy   ( in, "TITLE",	"%T", LEVEL_ANY, out, &status );
@@ -0,0 +1,296 @@
+/*
+ * any2any.c
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * The code in this file is based on xxx2yyy utilities by Chris Putnam 2003-2020.
+ * Reponsibility for any bugs introduced in this adaptation lies with GNB.
+ *
+ * Program and source code released under the GPL version 2
+ *
+ */
+
+/* Direct conversion between two non-XML formats.
+ *
+ * any2xml_main() followed by xml2any_main() writes all references to a
+ * temporary MODS XML file and then reads and parses it again.  Here the
+ * 'fields' produced by the convertf of the input format are passed
+ * straight to the assemblef/writef of the output format, i.e. the same
+ * route taken by bib2be_main() for bibentry output.
+ *
+ * The name of the 'program', argv[0], is of the form "in2out", e.g.
+ * "bib2ris" or "nbib2end", with the same names for the formats as those
+ * used by any2xml_main() and xml2any_main().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <R.h>
+
+#include "bibutils.h"
+#include "bibformats.h"
+#include "bibprog.h"
+#include "args.h"
+#include "bibentrysexp.h"
+
+static void
+any2any_initparams_in( param *p, const char *informat, const char *progname )
+{
+	if ( strcmp( informat, "bib" ) == 0 ) {
+		bibtexin_initparams( p, progname );
+	} else if ( strcmp( informat, "biblatex" ) == 0 ) {
+		biblatexin_initparams( p, progname );
+	} else if ( strcmp( informat, "copac" ) == 0 ) {
+		copacin_initparams( p, progname );
+	} else if ( strcmp( informat, "ebi" ) == 0 ) {
+		ebiin_initparams( p, progname );
+	} else if ( strcmp( informat, "end" ) == 0 ) {
+		endin_initparams( p, progname );
+	} else if ( strcmp( informat, "endx" ) == 0 ) {
+		endxmlin_initparams( p, progname );
+	} else if ( strcmp( informat, "isi" ) == 0 ) {
+		isiin_initparams( p, progname );
+	} else if ( strcmp( informat, "med" ) == 0 ) {
+		medin_initparams( p, progname );
+	} else if ( strcmp( informat, "nbib" ) == 0 ) {
+		nbibin_initparams( p, progname );
+	} else if ( strcmp( informat, "ris" ) == 0 ) {
+		risin_initparams( p, progname );
+	} else if ( strcmp( informat, "wordbib" ) == 0 ) {
+		wordin_initparams( p, progname );
+	} else if ( strcmp( informat, "ads" ) == 0 ) {
+		error("import from ADS abstracts format not implemented");
+	} else
+		error("cannot deduce input format from name %s", progname);
+}
+
+static void
+any2any_initparams_out( param *p, const char *outformat, const char *progname )
+{
+	if ( strcmp( outformat, "bib" ) == 0 ) {
+		bibtexout_initparams( p, progname );
+	} else if ( strcmp( outformat, "biblatex" ) == 0 ) {
+		biblatexout_initparams( p, progname );
+	} else if ( strcmp( outformat, "end" ) == 0 ) {
+		endout_initparams( p, progname );
+	} else if ( strcmp( outformat, "isi" ) == 0 ) {
+		isiout_initparams( p, progname );
+	} else if ( strcmp( outformat, "nbib" ) == 0 ) {
+		nbibout_initparams( p, progname );
+	} else if ( strcmp( outformat, "ris" ) == 0 ) {
+		risout_initparams( p, progname );
+	} else if ( strcmp( outformat, "wordbib" ) == 0 ) {
+		wordout_initparams( p, progname );
+	} else if ( strcmp( outformat, "ads" ) == 0 ) {
+		adsout_initparams( p, progname );
+	} else if ( strcmp( outformat, "bibentry" ) == 0 ) {
+		bibentryout_initparams( p, progname );
+		// see the corresponding comment in xml2any_main()
+		p->ctx->latex_escapes_only = 1;
+		p->ctx->tex_chars_only = 1;
+	} else {
+		bibl_freeparams( p );
+		if ( strcmp( outformat, "copac" ) == 0 )
+			error("export to copac format not implemented");
+		else if ( strcmp( outformat, "ebi" ) == 0 )
+			error("export to EBI XML format not implemented");
+		else if ( strcmp( outformat, "endx" ) == 0 )
+			error("export to Endnote XML format not implemented");
+		else if ( strcmp( outformat, "med" ) == 0 )
+			error("export to Medline XML format not implemented");
+		else
+			error("cannot deduce output format from name %s", progname);
+	}
+}
+
+/* The options are the union of those processed by tomods_processargs()
+ * for the input and process_args() in xml2any.c for the output.  "-nl"
+ * is passed by bibConvert() to both halves of the two-step conversion,
+ * so here it switches off latex on input and, for bibtex and biblatex,
+ * on output.  "-d" goes only to the first half, where it drops the key
+ * from the MODS XML.  "--stream" requests bibl_stream() (see bibcore.c)
+ * instead of bibl_read()/bibl_write().
+ */
+static void
+process_any2any_args( int *argc, char *argv[], param *p, int *stream )
+{
+	int i, j, subtract, status;
+
+	i = 1;
+	while ( i<*argc ) {
+		subtract = 0;
+		if ( args_match( argv[i], "--journals", "" ) ) {
+			p->ctx->njournals = *argc - i - 1;
+			p->ctx->journals = argv + i + 1;
+			*argc = i;
+			break;
+		} else if ( args_match( argv[i], "-h", "--help" ) ) {
+			REprintf( "%s: converts between two bibliography formats without "
+				  "the MODS XML intermediate\n", p->progname );
+			subtract = 1;
+		} else if ( args_match( argv[i], "-v", "--version" ) ) {
+			args_tellversion( p->progname );
+			subtract = 1;
+		} else if ( args_match( argv[i], "-a", "--add-refcount" ) ) {
+			p->addcount = 1;
+			subtract = 1;
+		} else if ( args_match( argv[i], "-s", "--single-refperfile" ) ) {
+			p->singlerefperfile = 1;
+			subtract = 1;
+		} else if ( args_match( argv[i], "-nl", "--no-latex" ) ) {
+			p->latexin = 0;
+			if ( p->writeformat==BIBL_BIBTEXOUT || p->writeformat==BIBL_BIBLATEXOUT )
+				p->latexout = 0;
+			subtract = 1;
+		} else if ( args_match( argv[i], "--convert_latex_escapes", "" ) ) {
+			p->ctx->latex_escapes_only = 1;  // see also tomods.c and bib2be.c
+			p->ctx->tex_chars_only = 1;
+			p->latexin = 0;
+			subtract = 1;
+		} else if ( args_match( argv[i], "-nt", "--nosplit-title" ) ) {
+			p->nosplittitle = 1;
+			subtract = 1;
+		} else if ( args_match( argv[i], "-c", "--corporation-file" ) ) {
+			if ( i+1 >= *argc ) error("%s: option -c takes the argument of the file", p->progname);
+			status = bibl_readcorps( p, argv[i+1] );
+			if ( status == BIBL_ERR_MEMERR )
+				error("%s: Memory error when reading --corporation-file '%s'", p->progname, argv[i+1]);
+			else if ( status == BIBL_ERR_CANTOPEN )
+				REprintf( "%s: Cannot read --corporation-file '%s'\n", p->progname, argv[i+1] );
+			subtract = 2;
+		} else if ( args_match( argv[i], "-as", "--asis" ) ) {
+			if ( i+1 >= *argc ) error("%s: option -as takes the argument of the file", p->progname);
+			status = bibl_readasis( p, argv[i+1] );
+			if ( status == BIBL_ERR_MEMERR )
+				error("%s: Memory error when reading --asis file '%s'", p->progname, argv[i+1]);
+			else if ( status == BIBL_ERR_CANTOPEN )
+				REprintf( "%s: Cannot read --asis file '%s'\n", p->progname, argv[i+1] );
+			subtract = 2;
+		} else if ( args_match( argv[i], "-fc", "--finalcomma" ) ) {
+			p->format_opts |= BIBL_FORMAT_BIBOUT_FINALCOMMA;
+			subtract = 1;
+		} else if ( args_match( argv[i], "-sd", "--singledash" ) ) {
+			p->format_opts |= BIBL_FORMAT_BIBOUT_SINGLEDASH;
+			subtract = 1;
+		} else if ( args_match( argv[i], "-b", "--brackets" ) ) {
+			p->format_opts |= BIBL_FORMAT_BIBOUT_BRACKETS;
+			subtract = 1;
+		} else if ( args_match( argv[i], "-w", "--whitespace" ) ) {
+			p->format_opts |= BIBL_FORMAT_BIBOUT_WHITESPACE;
+			subtract = 1;
+		} else if ( args_match( argv[i], "-sk", "--strictkey" ) ) {
+			p->format_opts |= BIBL_FORMAT_BIBOUT_STRICTKEY;
+			subtract = 1;
+		} else if ( args_match( argv[i], "-U", "--uppercase" ) ) {
+			p->format_opts |= BIBL_FORMAT_BIBOUT_UPPERCASE;
+			subtract = 1;
+		} else if ( args_match( argv[i], "-at", "--abbreviated-titles" ) ) {
+			p->format_opts |= BIBL_FORMAT_BIBOUT_SHORTTITLE;
+			subtract = 1;
+		} else if ( args_match( argv[i], "-d", "--drop-key" ) ) {
+			p->format_opts |= BIBL_FORMAT_MODSOUT_DROPKEY;
+			subtract = 1;
+		} else if ( args_match( argv[i], "-nb", "--no-bom" ) ) {
+			p->utf8bom = 0;
+			subtract = 1;
+		} else if ( args_match( argv[i], "--verbose", "" ) ) {
+			if ( p->verbose<1 ) p->verbose = 1;
+			subtract = 1;
+		} else if ( args_match( argv[i], "--debug", "" ) ) {
+			p->verbose = 3;
+			subtract = 1;
+		} else if ( args_match( argv[i], "--stream", "" ) ) {
+			*stream = 1;
+			subtract = 1;
+		}
+		if ( subtract ) {
+			for ( j=i+subtract; j<*argc; ++j )
+				argv[j-subtract] = argv[j];
+			*argc -= subtract;
+		} else {
+			if ( argv[i][0]=='-' ) REprintf( "(any2any.c) Warning: Did not recognize potential command-line argument %s\n", argv[i] );
+			i++;
+		}
+	}
+}
+
+static void
+any2any_setup( int *argc, char *argv[], param *p, bibl_context *ctx, int *stream )
+{
+	const char *progname = argv[0];
+	char informat[32], *outformat;
+	size_t len;
+
+	p->ctx = ctx;
+	p->nthreads = 1;
+	p->mapfiles = 0;
+	p->direct = 1;
+
+	outformat = strchr( progname, '2' );
+	len = ( outformat ) ? (size_t)( outformat - progname ) : 0;
+	if ( len==0 || len>=sizeof( informat ) || outformat[1]=='\0' )
+		error("cannot deduce input and output formats from name %s", progname);
+	strncpy( informat, progname, len );
+	informat[len] = '\0';
+	outformat++;
+
+	any2any_initparams_in( p, informat, progname );
+	any2any_initparams_out( p, outformat, progname );
+
+	process_charsets( argc, argv, p );
+	process_nthreads( argc, argv, p );
+	process_mapfiles( argc, argv, p );
+	*stream = 0;
+	process_any2any_args( argc, argv, p, stream );
+}
+
+void
+any2any_main( int *argcin, char *argv[], char *outfile[], double *nref )
+{
+	int argc = *argcin, stream;
+	param p;
+	bibl_context ctx;
+
+	bibl_initcontext( &ctx );
+	any2any_setup( &argc, argv, &p, &ctx, &stream );
+
+	if ( stream )
+		*nref = bibprog_stream( argc, argv, &p, outfile );
+	else
+		*nref = bibprog( argc, argv, &p, outfile );
+
+	bibl_freeparams( &p );
+	bibl_freecontext( &ctx );
+
+	*argcin = argc;
+}
+
+/* like any2any_main() for output to bibentry ("in2bibentry") but returns the
+ * bibentry() calls as an expression vector (see bibentrysexp.c)
+ */
+SEXP
+any2any_bibentry( SEXP argvin )
+{
+	int argc;
+	char **argv = bibentry_sexp_argv( argvin, &argc );
+	param p;
+	bibl_context ctx;
+	SEXP res;
+	int stream; // ignored here, the result is in memory anyway
+
+	if ( !strstr( argv[0], "2bibentry" ) )
+		error("any2any_bibentry: the output format must be bibentry, got %s", argv[0]);
+
+	bibl_initcontext( &ctx );
+	any2any_setup( &argc, argv, &p, &ctx, &stream );
+
+	PROTECT( res = bibprog_bibentry( argc, argv, &p ) );
+
+	bibl_freeparams( &p );
+	bibl_freecontext( &ctx );
+
+	UNPROTECT( 1 );
+	return res;
+}
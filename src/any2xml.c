@@ -23,9 +23,6 @@
 #include "tomods.h"
 #include "bibprog.h"
 
-extern int convert_latex_escapes_only;
-extern void bibdirectin_more_cleanf( void );
-
 char *help0[] = {
 		 /* bib2xml */
 		 "Converts a Bibtex reference file into MODS XML\n\n",
@@ -82,7 +79,15 @@ any2xml_main( int *argcin, char *argv[], char *outfile[], double *nref)
   const char *progname = argv[0];
 
 	param p;
+	bibl_context ctx;
 	int ihelp;
+
+	bibl_initcontext( &ctx );
+	p.ctx = &ctx;
+	p.nthreads = 1;
+	p.mapfiles = 0;
+	p.direct = 0;
+
 	if(strcmp(progname, "bib2xml") == 0){
 	  bibtexin_initparams( &p, progname );
 	  ihelp = 0;
@@ -129,9 +134,7 @@ any2xml_main( int *argcin, char *argv[], char *outfile[], double *nref)
 	*nref = bibprog( argc, argv, &p, outfile );
 
 	bibl_freeparams( &p );
-	if(strcmp(progname, "bib2xml") == 0){ // TODO: this probably should be removed
-	  convert_latex_escapes_only = 0;
-	}
+	bibl_freecontext( &ctx );
 
 	*argcin = argc;
 }
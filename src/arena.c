@@ -0,0 +1,99 @@
+/*
+ * arena.c
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * Source code released under the GPL version 2
+ *
+ * Implements a region allocator. The allocations are carved from blocks of
+ * at least ARENA_BLOCKSIZE bytes (a larger request gets a block of its own)
+ * and all blocks are freed together by arena_free(). An arena is not
+ * thread safe, the caller has to serialise the calls to arena_alloc().
+ *
+ */
+#include <stdlib.h>
+#include "arena.h"
+
+#define ARENA_BLOCKSIZE (65536)
+
+/* alignment of the allocations, enough for pointers, longs and doubles */
+#define ARENA_ALIGN     (sizeof( double ) > sizeof( void * ) ? sizeof( double ) : sizeof( void * ))
+
+#define arena_roundup( n ) ( ( (n) + ARENA_ALIGN - 1 ) / ARENA_ALIGN * ARENA_ALIGN )
+
+/* the data of a block start after the (rounded up) header */
+#define arena_header      arena_roundup( sizeof( arena_block ) )
+#define arena_data( b )   ( (char *) (b) + arena_header )
+
+void
+arena_init( arena *a )
+{
+	a->head      = NULL;
+	a->blocksize = ARENA_BLOCKSIZE;
+}
+
+void
+arena_free( arena *a )
+{
+	arena_block *b, *next;
+
+	for ( b=a->head; b; b=next ) {
+		next = b->next;
+		free( b );
+	}
+
+	arena_init( a );
+}
+
+arena *
+arena_new( void )
+{
+	arena *a = ( arena * ) malloc( sizeof( arena ) );
+	if ( a ) arena_init( a );
+	return a;
+}
+
+void
+arena_delete( arena *a )
+{
+	arena_free( a );
+	free( a );
+}
+
+/* returns NULL on memory error */
+void *
+arena_alloc( arena *a, size_t size )
+{
+	arena_block *b;
+	size_t bsize;
+	void *p;
+
+	size = arena_roundup( size ? size : 1 );
+
+	b = a->head;
+	if ( !b || b->size - b->used < size ) {
+
+		bsize = ( size > a->blocksize ) ? size : a->blocksize;
+
+		b = ( arena_block * ) malloc( arena_header + bsize );
+		if ( !b ) return NULL;
+		b->size = bsize;
+		b->used = 0;
+
+		/* a block for a single large allocation goes behind the current
+		 * one so that the rest of the current one is still used
+		 */
+		if ( a->head && bsize > a->blocksize ) {
+			b->next = a->head->next;
+			a->head->next = b;
+		} else {
+			b->next = a->head;
+			a->head = b;
+		}
+	}
+
+	p = arena_data( b ) + b->used;
+	b->used += size;
+
+	return p;
+}
@@ -0,0 +1,33 @@
+/*
+ * arena.h
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * Source code released under the GPL version 2
+ *
+ */
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/* region allocator: memory is taken from large blocks and released all at
+ * once by arena_free(); there is no way to free a single allocation
+ */
+typedef struct arena_block {
+	struct arena_block *next;
+	size_t size, used;
+} arena_block;
+
+typedef struct arena {
+	arena_block *head;
+	size_t blocksize;
+} arena;
+
+void   arena_init  ( arena *a );
+void   arena_free  ( arena *a );
+arena *arena_new   ( void );
+void   arena_delete( arena *a );
+void  *arena_alloc ( arena *a, size_t size );
+
+#endif
@@ -126,3 +126,39 @@ process_charsets( int *argc, char *argv[], param *p )
 	}
 }
 
+
+/* Georgi: "--nthreads N", the number of threads for the per-reference stages
+ * of the conversion (see bibthread.c). Removed from argv, as the charsets
+ * above, since it is common to all programs.
+ */
+void
+process_nthreads( int *argc, char *argv[], param *p )
+{
+	int i, j, n;
+	i = 1;
+	while ( i<*argc ) {
+		if ( args_match( argv[i], "", "--nthreads" ) ) {
+			n = atoi( args_next( *argc, argv, i, p->progname, NULL, "--nthreads" ) );
+			p->nthreads = ( n > 1 ) ? n : 1;
+			for ( j=i+2; j<*argc; ++j )
+				argv[j-2] = argv[j];
+			*argc -= 2;
+		} else i++;
+	}
+}
+
+/* Georgi: "--mmap", map regular input files into memory (see freader_map()) */
+void
+process_mapfiles( int *argc, char *argv[], param *p )
+{
+	int i, j;
+	i = 1;
+	while ( i<*argc ) {
+		if ( args_match( argv[i], "", "--mmap" ) ) {
+			p->mapfiles = 1;
+			for ( j=i+1; j<*argc; ++j )
+				argv[j-1] = argv[j];
+			*argc -= 1;
+		} else i++;
+	}
+}
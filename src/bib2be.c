@@ -20,13 +20,9 @@
 #include "bibprog.h"
 
 #include "args.h"
-
-extern int convert_latex_escapes_only;
-extern int export_tex_chars_only;
-extern int rdpack_patch_for_i_acute_variant;
+#include "bibentrysexp.h"
 
 extern int bibtexdirectin_initparams( param *pm, const char *progname );
-extern void bibdirectin_more_cleanf( void );
 extern int bibentrydirectout_initparams( param *pm, const char *progname );
 
 char *helpBE[] = {
@@ -61,16 +57,16 @@ process_direct_args( int *argc, char *argv[], param *p, const char *progname[] )
 	       subtract = 1;
 	  } else if ( args_match( argv[i], "--convert_latex_escapes", "" ) ) { // Georgi
 	       p->latexin = 0; // like --keep-tex-chars
-	       convert_latex_escapes_only = 1;
+	       p->ctx->latex_escapes_only = 1;
 	       p->latexout = 0;
 	       subtract = 1;
 	  } else if ( args_match( argv[i], "--export_tex_chars", "" ) ) { // Georgi
 	       p->latexin = 0; // like --keep-tex-chars
-	       export_tex_chars_only = 1;
+	       p->ctx->tex_chars_only = 1;
 	       p->latexout = 1;
 	       subtract = 1;
 	  } else if ( args_match( argv[i], "--Rdpack", "" ) ) { // new 2021-10-13
-	       rdpack_patch_for_i_acute_variant = 1;
+	       p->ctx->rdpack_i_acute = 1;
 	       subtract = 1;
 	  } else if ( args_match( argv[i], "-nl", "--no-latex" ) ) {
 	       p->latexout = 0;
@@ -127,38 +123,52 @@ process_direct_args( int *argc, char *argv[], param *p, const char *progname[] )
      }
 }
 
-// xml2any_main( int *argc, char *argv[], char *outfile[], double *nref )
-void
-bib2be_main( int *argcin, char *argv[], char *outfile[], double *nref)
+static void
+bib2be_setup( int *argc, char *argv[], param *p, bibl_context *ctx )
 {
-     int argc = *argcin;
-     // const char *progname = progname_in[0];
      const char *progname = argv[0];
 
-     // REprintf("argc: %d\n", argc);
-     // REprintf("argv[0]: %s\n", argv[0]);
-     // REprintf("argv[1]: %s\n", argv[1]);
-  
-     param p;
-     // int ihelp;
-
-     bibtexdirectin_initparams( &p, progname );
+     p->ctx = ctx;
+     p->nthreads = 1;
+     p->mapfiles = 0;
+     p->direct = 0;
+     bibtexdirectin_initparams( p, progname );
      // ihelp = 0;
 
      // modsout_initparams( &p, progname );
      // tomods_processargs( &argc, argv, &p, help0[ihelp], help0[ihelp + 1] );
 
      // bibentryout_initparams( &p, progname ); // this works, kind of
-     bibentrydirectout_initparams( &p, progname );
+     bibentrydirectout_initparams( p, progname );
 	
-     process_charsets( &argc, argv, &p );
+     process_charsets( argc, argv, p );
+     process_nthreads( argc, argv, p );
+     process_mapfiles( argc, argv, p );
 
      // !!! TODO: this needs to be sorted out! !!!
      //
-     process_direct_args( &argc, argv, &p, &progname );  // process_args( &argc, argv, &p );
+     process_direct_args( argc, argv, p, &progname );  // process_args( &argc, argv, &p );
 
      //Georgi
      //REprintf("OOOOh: p.latexout: %d, p.charsetout: %d\n", p.latexout, p.charsetout );
+}
+
+// xml2any_main( int *argc, char *argv[], char *outfile[], double *nref )
+void
+bib2be_main( int *argcin, char *argv[], char *outfile[], double *nref)
+{
+     int argc = *argcin;
+
+     // REprintf("argc: %d\n", argc);
+     // REprintf("argv[0]: %s\n", argv[0]);
+     // REprintf("argv[1]: %s\n", argv[1]);
+  
+     param p;
+     bibl_context ctx;
+     // int ihelp;
+
+     bibl_initcontext( &ctx );
+     bib2be_setup( &argc, argv, &p, &ctx );
 	
      *nref = bibprog( argc, argv, &p, outfile );
      // *nref = bibprog( argc[0], argv, &p, outfile );   // bibprog( argc, argv, &p );
@@ -167,9 +177,31 @@ bib2be_main( int *argcin, char *argv[], char *outfile[], double *nref)
      // REprintf( "processed %g references.\n", *nref );
 
      bibl_freeparams( &p );
-
-     bibdirectin_more_cleanf();
+     bibl_freecontext( &ctx );
 	
      *argcin = argc;
      // return EXIT_SUCCESS;
 }
+
+// 2026-10-17 new: like bib2be_main() but returns the bibentry() calls as an
+//     expression vector, without the intermediate R source file
+SEXP
+bib2be_bibentry( SEXP argvin )
+{
+     int argc;
+     char **argv = bibentry_sexp_argv( argvin, &argc );
+     param p;
+     bibl_context ctx;
+     SEXP res;
+
+     bibl_initcontext( &ctx );
+     bib2be_setup( &argc, argv, &p, &ctx );
+
+     PROTECT( res = bibprog_bibentry( argc, argv, &p ) );
+
+     bibl_freeparams( &p );
+     bibl_freecontext( &ctx );
+
+     UNPROTECT( 1 );
+     return res;
+}
@@ -12,6 +12,7 @@
  */
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "bibutils.h"
 
 /* internal includes */
@@ -19,6 +20,9 @@
 #include "charsets.h"
 #include "str_conv.h"
 #include "is_ws.h"
+#include "intlist.h"
+#include "bibthread.h"
+#include "bibformats.h"
 
 /* illegal modes to pass in, but use internally for consistency */
 #define BIBL_INTERNALIN   (BIBL_LASTIN+1)
@@ -27,6 +31,11 @@
 #define debug_set( p ) ( (p)->verbose > 1 )
 #define verbose_set( p ) ( (p)->verbose )
 
+/* Georgi: the number of threads for the per-reference stages (see
+ * bibthread.c); the debugging output is done serially.
+ */
+#define nthreads_set( p ) ( debug_set( p ) ? 1 : (p)->nthreads )
+
 static void
 report_params( const char *f, param *p )
 {
@@ -152,6 +161,11 @@ bibl_duplicateparams( param *np, param *op )
 	np->all       = op->all;
 	np->nall      = op->nall;
 
+	np->ctx       = op->ctx; /* shared, not copied */
+	np->nthreads  = op->nthreads;
+	np->mapfiles  = op->mapfiles;
+	np->direct    = op->direct;
+
 	return BIBL_OK;
 }
 
@@ -205,6 +219,51 @@ bibl_freeparams( param *p )
 	}
 }
 
+/* Georgi: the context of a conversion, see bibl_context in bibutils.h.
+ * One context is used for all files of a conversion (the @STRING macros
+ * of a bibtex file are visible in the following ones, as before).
+ */
+void
+bibl_initcontext( bibl_context *ctx )
+{
+	slist_init( &(ctx->find) );
+	slist_init( &(ctx->replace) );
+	ctx->latex_escapes_only = 0;
+	ctx->tex_chars_only     = 0;
+	ctx->rdpack_i_acute     = 0;
+	ctx->journals           = NULL;
+	ctx->njournals          = 0;
+	ctx->xml_pns            = NULL;
+	ctx->quiet              = 0;
+}
+
+void
+bibl_freecontext( bibl_context *ctx )
+{
+	slist_free( &(ctx->find) );
+	slist_free( &(ctx->replace) );
+	bibl_initcontext( ctx );
+}
+
+/* the values of the latexin and latexout arguments of str_convert() for
+ * the conversions done with 'p'
+ */
+int
+bibl_latexin( param *p )
+{
+	if ( !p->latexin ) return 0;
+	if ( p->ctx->latex_escapes_only ) return STR_CONV_LATEX_ESCAPES;
+	return 1;
+}
+
+int
+bibl_latexout( param *p )
+{
+	if ( !p->latexout ) return 0;
+	if ( p->ctx->tex_chars_only ) return STR_CONV_LATEX_ESCAPES;
+	return 1;
+}
+
 int
 bibl_readasis( param *p, char *f )
 {
@@ -462,14 +521,16 @@ out:
 static int
 read_refs( FILE *fp, bibl *bin, char *filename, param *p )
 {
-	int refnum = 0, bufpos = 0, ret=BIBL_OK, fcharset;/* = CHARSET_UNKNOWN;*/
+	int refnum = 0, ret=BIBL_OK, fcharset;/* = CHARSET_UNKNOWN;*/
 	str reference, line;
-	char buf[256]="";
+	freader fr;
 	fields *ref;
 
 	str_init( &reference );
 	str_init( &line );
-	while ( p->readf( fp, buf, sizeof(buf), &bufpos, &line, &reference, &fcharset ) ) {
+	freader_init( &fr, fp );
+	if ( p->mapfiles ) freader_map( &fr );
+	while ( p->readf( &fr, &line, &reference, &fcharset, p ) ) {
 		if ( reference.len==0 ) continue;
 		ref = fields_new();
 		if ( !ref ) {
@@ -500,8 +561,14 @@ read_refs( FILE *fp, bibl *bin, char *filename, param *p )
 			}
 		}
 	}
+	if ( fr.status!=FREADER_OK ) {
+		ret = BIBL_ERR_MEMERR;
+		bibl_free( bin );
+		goto out;
+	}
 	if ( p->charsetin==CHARSET_UNICODE ) p->utf8in = 1;
 out:
+	freader_free( &fr );
 	str_free( &line );
 	str_free( &reference );
 	return ret;
@@ -543,8 +610,8 @@ bibl_fixcharsetdata( fields *ref, param *p )
 				p->charsetout, 0, p->utf8out, p->xmlout );
 		} else {
 			ok = str_convert( data,
-				p->charsetin,  p->latexin,  p->utf8in,  p->xmlin,
-				p->charsetout, p->latexout, p->utf8out, p->xmlout );
+				p->charsetin,  bibl_latexin( p ),  p->utf8in,  p->xmlin,
+				p->charsetout, bibl_latexout( p ), p->utf8out, p->xmlout );
 		}
 
 		if ( !ok ) return BIBL_ERR_MEMERR;
@@ -553,6 +620,18 @@ bibl_fixcharsetdata( fields *ref, param *p )
 	return BIBL_OK;
 }
 
+typedef struct {
+	bibl *b;
+	param *p;
+} fixcharsets_data;
+
+static int
+bibl_fixcharsets_one( long i, void *data )
+{
+	fixcharsets_data *d = ( fixcharsets_data * ) data;
+	return bibl_fixcharsetdata( d->b->ref[i], d->p );
+}
+
 /* bibl_fixcharsets()
  *
  * returns BIBL_OK or BIBL_ERR_MEMERR
@@ -560,15 +639,12 @@ bibl_fixcharsetdata( fields *ref, param *p )
 static int
 bibl_fixcharsets( bibl *b, param *p )
 {
-	int status;
-	long i;
+	fixcharsets_data d;
 
-	for ( i=0; i<b->n; ++i ) {
-		status = bibl_fixcharsetdata( b->ref[i], p );
-		if ( status!=BIBL_OK ) return status;
-	}
+	d.b = b;
+	d.p = p;
 
-	return BIBL_OK;
+	return bibl_parallel( b->n, nthreads_set( p ), bibl_fixcharsets_one, &d, NULL );
 }
 
 static int
@@ -594,7 +670,7 @@ bibl_addcount( bibl *b )
 
 	}
 
-	return BIBL_OK;
+	return bibl_reindex( b );
 }
 
 static int
@@ -679,23 +755,43 @@ get_citekeys( bibl *bin, slist *citekeys )
 	return BIBL_OK;
 }
 
+/* Georgi: dup[j] is set to the position of the first reference with the
+ * same citekey as reference j (if there is more than one such reference),
+ * next[j] to the following one with that citekey (or -1). Returns the number
+ * of duplicates or -1 on memory error.
+ */
 static int
-identify_duplicates( bibl *b, slist *citekeys, int *dup )
+identify_duplicates( bibl *b, slist *citekeys, int *dup, int *next )
 {
-	int i, j, ndup = 0;
-
-	for ( i=0; i<citekeys->n-1; ++i ) {
-		if ( dup[i]!=-1 ) continue;
-		for ( j=i+1; j<citekeys->n; ++j ) {
-			if ( !strcmp( slist_cstr( citekeys, i ),
-			              slist_cstr( citekeys, j ) ) ) {
-					dup[i] = i;
-					dup[j] = i;
-					ndup++;
+	int i, first, ndup = 0;
+	int *last;
+	strhash seen;
+
+	last = ( int * ) malloc( sizeof( int ) * citekeys->n );
+	if ( !last ) return -1;
+
+	strhash_init( &seen );
+
+	for ( i=0; i<citekeys->n; ++i ) {
+		first = strhash_find( &seen, slist_cstr( citekeys, i ) );
+		if ( first==STRHASH_NOTFOUND ) {
+			if ( strhash_add( &seen, slist_cstr( citekeys, i ), i )!=STRHASH_OK ) {
+				ndup = -1;
+				goto out;
 			}
+			last[i] = i;
+			continue;
 		}
+		dup[first] = first;
+		dup[i] = first;
+		next[ last[first] ] = i;
+		last[first] = i;
+		ndup++;
 	}
 
+out:
+	strhash_free( &seen );
+	free( last );
 	return ndup;
 }
 
@@ -717,7 +813,7 @@ build_new_citekey( int nsame, str *old_citekey, str *new_citekey )
 }
 
 static int
-resolve_duplicates( bibl *b, slist *citekeys, int *dup )
+resolve_duplicates( bibl *b, slist *citekeys, int *dup, int *next )
 {
 	int nsame, n, i, j, status = BIBL_OK;
 	str new_citekey, *ref_citekey;
@@ -726,15 +822,11 @@ resolve_duplicates( bibl *b, slist *citekeys, int *dup )
 
 	for ( i=0; i<citekeys->n; ++i ) {
 
-		if ( dup[i]==-1 ) continue;
+		if ( dup[i]!=i ) continue;
 
 		nsame = 0;
 
-		for ( j=i; j<citekeys->n; ++j ) {
-
-			if ( dup[j]!=i ) continue;
-
-			dup[j] = -1;
+		for ( j=i; j!=-1; j=next[j] ) {
 
 			status = build_new_citekey( nsame, slist_str( citekeys, j ), &new_citekey );
 			if ( status!=BIBL_OK ) goto out;
@@ -758,17 +850,26 @@ out:
 static int
 identify_and_resolve_duplicate_citekeys( bibl *b, slist *citekeys )
 {
-	int i, *dup, ndup, status=BIBL_OK;
+	int i, *dup, *next, ndup, status=BIBL_OK;
 
-	dup = ( int * ) malloc( sizeof( int ) * citekeys->n );
-	if ( !dup ) return BIBL_ERR_MEMERR;
-	for ( i=0; i<citekeys->n; ++i ) dup[i] = -1;
+	if ( citekeys->n==0 ) return BIBL_OK;
+
+	dup  = ( int * ) malloc( sizeof( int ) * citekeys->n );
+	next = ( int * ) malloc( sizeof( int ) * citekeys->n );
+	if ( !dup || !next ) {
+		status = BIBL_ERR_MEMERR;
+		goto out;
+	}
+	for ( i=0; i<citekeys->n; ++i ) dup[i] = next[i] = -1;
 
-	ndup = identify_duplicates( b, citekeys, dup );
+	ndup = identify_duplicates( b, citekeys, dup, next );
 
-	if ( ndup ) status = resolve_duplicates( b, citekeys, dup );
+	if ( ndup<0 ) status = BIBL_ERR_MEMERR;
+	else if ( ndup ) status = resolve_duplicates( b, citekeys, dup, next );
 
-	free( dup );
+out:
+	if ( dup )  free( dup );
+	if ( next ) free( next );
 	return status;
 }
 
@@ -784,6 +885,9 @@ uniqueify_citekeys( bibl *bin )
 	if ( status!=BIBL_OK ) goto out;
 
 	status = identify_and_resolve_duplicate_citekeys( bin, &citekeys );
+	if ( status!=BIBL_OK ) goto out;
+
+	status = bibl_reindex( bin );
 out:
 	slist_free( &citekeys );
 	return status;
@@ -796,38 +900,156 @@ clean_refs( bibl *bin, param *p )
 	else return BIBL_OK;
 }
 
-static int 
-convert_refs( bibl *bin, char *fname, bibl *bout, param *p )
+/* Georgi: the direct conversion (any2any.c) gives the output format the
+ * references as they would come back from the MODS XML of the two-step
+ * conversion (see modsout_direct() in modsout.c), after which xml2any makes
+ * the citekeys unique again.
+ */
+typedef struct {
+	bibl *b;
+	param *p;
+} direct_data;
+
+static int
+direct_ref( long i, void *data )
 {
-	int reftype = 0, status;
-	fields *rin, *rout;
+	direct_data *d = ( direct_data * ) data;
+	fields *out;
+	int status;
+
+	out = fields_new();
+	if ( !out ) return BIBL_ERR_MEMERR;
+
+	status = modsout_direct( d->b->ref[i], out, d->p );
+	if ( status!=BIBL_OK ) {
+		fields_delete( out );
+		return status;
+	}
+
+	fields_delete( d->b->ref[i] );
+	d->b->ref[i] = out;
+	return BIBL_OK;
+}
+
+static int
+direct_refs( bibl *b, param *p )
+{
+	direct_data d;
+	int status;
 	long i;
 
-	for ( i=0; i<bin->n; ++i ) {
+	d.b = b;
+	d.p = p;
+	if ( nthreads_set( p ) <= 1 ) {
+		for ( i=0; i<b->n; ++i ) {
+			status = direct_ref( i, &d );
+			if ( status!=BIBL_OK ) return status;
+		}
+	} else {
+		status = bibl_parallel( b->n, p->nthreads, direct_ref, &d, NULL );
+		if ( status!=BIBL_OK ) return status;
+	}
+
+	status = bibl_reindex( b );
+	if ( status!=BIBL_OK ) return status;
 
-		rin = bin->ref[i];
+	return uniqueify_citekeys( b );
+}
 
-		rout = fields_new();
-		if ( !rout ) return BIBL_ERR_MEMERR;
+/* Georgi: the conversion of a single reference, without adding it to the
+ * output; doesn't touch anything shared, so can be run on several threads
+ */
+static int
+convert_ref_fields( fields *rin, char *fname, long refnum, fields *rout, param *p )
+{
+	int reftype = 0, status;
 
-		if ( p->typef ) reftype = p->typef( rin, fname, i+1, p );
+	if ( p->typef ) reftype = p->typef( rin, fname, refnum, p );
 
-		status = p->convertf( rin, rout, reftype, p );
+	status = p->convertf( rin, rout, reftype, p );
 
+	if ( status!=BIBL_OK ) return status;
+
+	if ( p->all ) {
+		status = process_alwaysadd( rout, reftype, p );
+		if ( status!=BIBL_OK ) return status;
+		status = process_defaultadd( rout, reftype, p );
 		if ( status!=BIBL_OK ) return status;
+	}
 
-		if ( p->all ) {
-			status = process_alwaysadd( rout, reftype, p );
-			if ( status!=BIBL_OK ) return status;
-			status = process_defaultadd( rout, reftype, p );
+	return BIBL_OK;
+}
+
+/* Georgi: the body of the loop in convert_refs(), separate for bibl_stream() */
+static int
+convert_ref( fields *rin, char *fname, long refnum, bibl *bout, param *p )
+{
+	int status;
+	fields *rout;
+
+	rout = fields_new();
+	if ( !rout ) return BIBL_ERR_MEMERR;
+
+	status = convert_ref_fields( rin, fname, refnum, rout, p );
+	if ( status!=BIBL_OK ) return status;
+
+	return bibl_addref( bout, rout );
+}
+
+typedef struct {
+	bibl *bin;
+	char *fname;
+	fields **rout;
+	param *p;
+} convert_data;
+
+static int
+convert_refs_one( long i, void *data )
+{
+	convert_data *d = ( convert_data * ) data;
+
+	d->rout[i] = fields_new();
+	if ( !d->rout[i] ) return BIBL_ERR_MEMERR;
+
+	return convert_ref_fields( d->bin->ref[i], d->fname, i+1, d->rout[i], d->p );
+}
+
+/* With several threads the references are converted in parallel and then
+ * added to 'bout' in their original order.
+ */
+static int 
+convert_refs( bibl *bin, char *fname, bibl *bout, param *p )
+{
+	convert_data d;
+	int status = BIBL_OK;
+	long i;
+
+	if ( nthreads_set( p ) <= 1 ) {
+		for ( i=0; i<bin->n; ++i ) {
+			status = convert_ref( bin->ref[i], fname, i+1, bout, p );
 			if ( status!=BIBL_OK ) return status;
 		}
+		return BIBL_OK;
+	}
 
-		status = bibl_addref( bout, rout );
-		if ( status!=BIBL_OK ) return status;
+	d.bin   = bin;
+	d.fname = fname;
+	d.p     = p;
+	d.rout  = ( fields ** ) calloc( bin->n, sizeof( fields * ) );
+	if ( !d.rout ) return BIBL_ERR_MEMERR;
+
+	status = bibl_parallel( bin->n, p->nthreads, convert_refs_one, &d, NULL );
+
+	for ( i=0; i<bin->n; ++i ) {
+		if ( status==BIBL_OK ) {
+			status = bibl_addref( bout, d.rout[i] );
+			if ( status==BIBL_OK ) continue;
+		}
+		if ( d.rout[i] ) fields_delete( d.rout[i] );
 	}
 
-	return BIBL_OK;
+	free( d.rout );
+	return status;
 }
 
 int
@@ -839,7 +1061,7 @@ bibl_read( bibl *b, FILE *fp, char *filename, param *p )
 
 	if ( !b )  return BIBL_ERR_BADINPUT;
 	if ( !fp ) return BIBL_ERR_BADINPUT;
-	if ( !p )  return BIBL_ERR_BADINPUT;
+	if ( !p || !p->ctx ) return BIBL_ERR_BADINPUT;
 
 	if ( bibl_illegalinmode( p->readformat ) ) {
 	  if ( debug_set( p ) ) report_params( "bibl_read", p );
@@ -907,6 +1129,12 @@ bibl_read( bibl *b, FILE *fp, char *filename, param *p )
 		if ( debug_set( &read_params ) ) bibl_verbose( &bin, "post_uniqueify_citekeys", "for bibl_read" );
 	}
 
+	if ( read_params.direct ) {
+		status = direct_refs( b, &read_params );
+		if ( status!=BIBL_OK ) goto out;
+		if ( debug_set( &read_params ) ) bibl_verbose( b, "post_direct_refs", "for bibl_read" );
+	}
+
 out:
 
 	bibl_free( &bin );
@@ -984,6 +1212,94 @@ bibl_writeeachfp( FILE *fp, bibl *b, param *p )
 	return BIBL_OK;
 }
 
+/* Georgi: the references are assembled in blocks of this many per thread */
+#define BIBL_ASSEMBLE_BLOCK (256)
+
+typedef struct {
+	bibl *b;
+	long first;
+	fields *out;
+	param *p;
+} assemble_data;
+
+static int
+bibl_assemble_one( long i, void *data )
+{
+	assemble_data *d = ( assemble_data * ) data;
+	return d->p->assemblef( d->b->ref[ d->first + i ], &(d->out[i]), d->p, d->first + i );
+}
+
+/* Run p->assemblef on several threads, a block of references at a time,
+ * and pass the results to 'f' from this thread, in the original order.
+ * As in the serial loops below, the references before a failed one are
+ * still passed to 'f'.
+ */
+static int
+bibl_assemble_parallel( bibl *b, param *p,
+	int (*f)( fields *in, fields *out, void *data, unsigned long refnum ),
+	void *data )
+{
+	int status = BIBL_OK, fstatus = BIBL_OK;
+	assemble_data d;
+	long i, n, nok, nblock;
+
+	nblock = BIBL_ASSEMBLE_BLOCK * (long) p->nthreads;
+	if ( nblock > b->n ) nblock = b->n;
+	if ( nblock < 1 ) return BIBL_OK;
+
+	d.b   = b;
+	d.p   = p;
+	d.out = ( fields * ) malloc( sizeof( fields ) * nblock );
+	if ( !d.out ) return BIBL_ERR_MEMERR;
+	for ( i=0; i<nblock; ++i ) fields_init( &(d.out[i]) );
+
+	for ( d.first=0; d.first<b->n; d.first+=nblock ) {
+		n = b->n - d.first;
+		if ( n > nblock ) n = nblock;
+
+		status = bibl_parallel( n, p->nthreads, bibl_assemble_one, &d, &nok );
+
+		for ( i=0; i<nok && fstatus==BIBL_OK; ++i )
+			fstatus = f( b->ref[ d.first + i ], &(d.out[i]), data, d.first + i );
+
+		for ( i=0; i<n; ++i ) fields_free( &(d.out[i]) );
+
+		if ( fstatus!=BIBL_OK ) status = fstatus;
+		if ( status!=BIBL_OK ) break;
+	}
+
+	free( d.out );
+	return status;
+}
+
+typedef struct {
+	FILE *fp;
+	param *p;
+} writefp_data;
+
+static int
+bibl_writefp_one( fields *in, fields *out, void *data, unsigned long refnum )
+{
+	writefp_data *d = ( writefp_data * ) data;
+	return d->p->writef( out, d->fp, d->p, refnum );
+}
+
+static int
+bibl_writefp_parallel( FILE *fp, bibl *b, param *p )
+{
+	writefp_data d;
+	int status;
+
+	d.fp = fp;
+	d.p  = p;
+
+	if ( p->headerf ) p->headerf( fp, p );
+	status = bibl_assemble_parallel( b, p, bibl_writefp_one, &d );
+	if ( p->footerf ) p->footerf( fp );
+
+	return status;
+}
+
 static int
 bibl_writefp( FILE *fp, bibl *b, param *p )
 {
@@ -991,6 +1307,9 @@ bibl_writefp( FILE *fp, bibl *b, param *p )
 	fields out, *use = &out;
 	long i;
 
+	if ( p->assemblef && nthreads_set( p ) > 1 )
+		return bibl_writefp_parallel( fp, b, p );
+
 	fields_init( &out );
 
 	if ( debug_set( p ) && p->assemblef ) {
@@ -1034,7 +1353,7 @@ bibl_write( bibl *b, FILE *fp, param *p )
 	param lp;
 
 	if ( !b ) return BIBL_ERR_BADINPUT;
-	if ( !p ) return BIBL_ERR_BADINPUT;
+	if ( !p || !p->ctx ) return BIBL_ERR_BADINPUT;
 	if ( bibl_illegaloutmode( p->writeformat ) ) return BIBL_ERR_BADINPUT;
 	if ( !fp && !p->singlerefperfile ) return BIBL_ERR_BADINPUT;
 
@@ -1061,3 +1380,474 @@ out:
 	bibl_freeparams( &lp );
 	return status;
 }
+
+/* bibl_assemble()
+ *
+ * Georgi: like bibl_write() but, instead of writing them to a file, pass
+ * the assembled references to 'f' (used to create the bibentry objects
+ * directly, see bibentrysexp.c). 'in' is the reference after the charset
+ * conversion, 'out' is the output of p->assemblef (or 'in' if there is no
+ * assemblef).
+ */
+int
+bibl_assemble( bibl *b, param *p,
+	       int (*f)( fields *in, fields *out, void *data, unsigned long refnum ),
+	       void *data )
+{
+	int status;
+	fields out, *use = &out;
+	param lp;
+	long i;
+
+	if ( !b ) return BIBL_ERR_BADINPUT;
+	if ( !p || !p->ctx || !f ) return BIBL_ERR_BADINPUT;
+	if ( bibl_illegaloutmode( p->writeformat ) ) return BIBL_ERR_BADINPUT;
+
+	status = bibl_setwriteparams( &lp, p );
+	if ( status!=BIBL_OK ) return status;
+
+	if ( debug_set( p ) ) report_params( "bibl_assemble", &lp );
+
+	status = bibl_fixcharsets( b, &lp );
+	if ( status!=BIBL_OK ) goto out;
+
+	if ( debug_set( p ) ) bibl_verbose( b, "post-fixcharsets", "for bibl_assemble" );
+
+	if ( lp.assemblef && nthreads_set( p ) > 1 ) {
+		status = bibl_assemble_parallel( b, &lp, f, data );
+		goto out;
+	}
+
+	fields_init( &out );
+
+	for ( i=0; i<b->n; ++i ) {
+		if ( lp.assemblef ) {
+			fields_free( &out );
+			status = lp.assemblef( b->ref[i], &out, &lp, i );
+			if ( status!=BIBL_OK ) break;
+			if ( debug_set( p ) ) bibl_verbose_reference( &out, "", i+1 );
+		} else {
+			use = b->ref[i];
+		}
+
+		status = f( b->ref[i], use, data, i );
+		if ( status!=BIBL_OK ) break;
+	}
+
+	fields_free( &out );
+out:
+	bibl_freeparams( &lp );
+	return status;
+}
+
+/* citekey of a reference in bibl_stream(), cf. uniqueify_citekeys() */
+static int
+bibl_stream_citekey( fields *ref, long refnum, strhash *keys, intlist *nsame, int addcount )
+{
+	int n, status = BIBL_OK;
+	str newkey, *key;
+	char buf[512];
+	long k;
+
+	n = fields_find( ref, "REFNUM", LEVEL_ANY );
+	if ( n==FIELDS_NOTFOUND ) n = generate_citekey( ref, refnum );
+	if ( n==FIELDS_NOTFOUND ) return BIBL_ERR_MEMERR;
+
+	key = fields_value( ref, n, FIELDS_STRP_NOUSE );
+
+	if ( key->len > 0 ) {
+		k = strhash_find( keys, str_cstr( key ) );
+		if ( k!=STRHASH_NOTFOUND ) {
+			intlist_set( nsame, k, intlist_get( nsame, k ) + 1 );
+			str_init( &newkey );
+			status = build_new_citekey( intlist_get( nsame, k ), key, &newkey );
+			if ( status==BIBL_OK ) {
+				str_strcpy( key, &newkey );
+				if ( str_memerr( key ) ) status = BIBL_ERR_MEMERR;
+			}
+			str_free( &newkey );
+			if ( status!=BIBL_OK ) return status;
+		} else {
+			if ( strhash_add( keys, str_cstr( key ), nsame->n )!=STRHASH_OK ) return BIBL_ERR_MEMERR;
+			if ( intlist_add( nsame, 0 )!=INTLIST_OK ) return BIBL_ERR_MEMERR;
+		}
+	}
+
+	/* as bibl_addcount() */
+	if ( addcount ) {
+		n = fields_find( ref, "REFNUM", LEVEL_MAIN );
+		if ( n!=FIELDS_NOTFOUND ) {
+			snprintf( buf, 512, "_%ld", refnum );
+			str_strcatc( fields_value( ref, n, FIELDS_STRP_NOUSE ), buf );
+			if ( str_memerr( fields_value( ref, n, FIELDS_STRP_NOUSE ) ) )
+				return BIBL_ERR_MEMERR;
+		}
+	}
+
+	return BIBL_OK;
+}
+
+/* the formats whose cleanf resolves crossrefs, see bibtexin_crossref() */
+static int
+bibl_stream_hascrossrefs( param *rp )
+{
+	return ( rp->readformat==BIBL_BIBTEXIN || rp->readformat==BIBL_BIBLATEXIN );
+}
+
+/* keep a copy of ref in targets if a crossref points to it */
+static int
+bibl_stream_keeptarget( fields *ref, strhash *wanted, bibl *targets )
+{
+	fields *copy;
+	char *key;
+	int n;
+
+	n = fields_find( ref, "REFNUM", LEVEL_ANY );
+	if ( n==FIELDS_NOTFOUND ) return BIBL_OK;
+	key = ( char * ) fields_value( ref, n, FIELDS_CHRP_NOUSE );
+	if ( strhash_find( wanted, key )==STRHASH_NOTFOUND ) return BIBL_OK;
+	if ( bibl_findref( targets, key )!=-1 ) return BIBL_OK;
+
+	copy = fields_dupl( ref );
+	if ( !copy ) return BIBL_ERR_MEMERR;
+	if ( bibl_addref( targets, copy )!=BIBL_OK ) {
+		fields_delete( copy );
+		return BIBL_ERR_MEMERR;
+	}
+	return BIBL_OK;
+}
+
+/* bibl_stream_prescan()
+ *
+ * Georgi: a first pass over the input of bibl_stream() for the formats with
+ * crossrefs. The keys the crossrefs point to are collected in 'wanted' and
+ * the targets following a reference pointing to them (the usual order in
+ * bibtex files) are kept in 'targets'. A target preceding its first
+ * reference is picked up by bibl_stream() itself.
+ *
+ * The @STRING macros are restored afterwards, so that the second pass sees
+ * them in the order of the input, and the warnings of the parser are not
+ * given twice.
+ */
+static int
+bibl_stream_prescan( int nfiles, char *files[], param *rp, strhash *wanted, bibl *targets )
+{
+	int status = BIBL_OK, fcharset, n, i;
+	str reference, line;
+	slist find, replace;
+	bibl_context *ctx = rp->ctx;
+	freader fr;
+	fields *ref;
+	long refnum = 0;
+	FILE *fp;
+
+	strs_init( &reference, &line, NULL );
+	slists_init( &find, &replace, NULL );
+	if ( slist_copy( &find, &(ctx->find) )!=SLIST_OK ||
+	     slist_copy( &replace, &(ctx->replace) )!=SLIST_OK ) {
+		status = BIBL_ERR_MEMERR;
+		goto out;
+	}
+	ctx->quiet = 1;
+
+	for ( i=0; i<nfiles && status==BIBL_OK; ++i ) {
+		fp = fopen( files[i], "r" );
+		if ( !fp ) continue;
+
+		freader_init( &fr, fp );
+		if ( rp->mapfiles ) freader_map( &fr );
+		str_empty( &line );
+		str_empty( &reference );
+
+		while ( rp->readf( &fr, &line, &reference, &fcharset, rp ) ) {
+			if ( reference.len==0 ) continue;
+
+			ref = fields_new();
+			if ( !ref ) { status = BIBL_ERR_MEMERR; break; }
+
+			if ( rp->processf( ref, reference.data, files[i], refnum+1, rp ) ) {
+				refnum++;
+				n = fields_find( ref, "CROSSREF", LEVEL_ANY );
+				if ( n!=FIELDS_NOTFOUND &&
+				     strhash_add( wanted, fields_value( ref, n, FIELDS_CHRP_NOUSE ), 0 )!=STRHASH_OK )
+					status = BIBL_ERR_MEMERR;
+				if ( status==BIBL_OK )
+					status = bibl_stream_keeptarget( ref, wanted, targets );
+			}
+			fields_delete( ref );
+			str_empty( &reference );
+			if ( status!=BIBL_OK ) break;
+		}
+
+		if ( status==BIBL_OK && fr.status!=FREADER_OK ) status = BIBL_ERR_MEMERR;
+		freader_free( &fr );
+		fclose( fp );
+	}
+
+	ctx->quiet = 0;
+	if ( slist_copy( &(ctx->find), &find )!=SLIST_OK ||
+	     slist_copy( &(ctx->replace), &replace )!=SLIST_OK )
+		status = BIBL_ERR_MEMERR;
+out:
+	slists_free( &find, &replace, NULL );
+	strs_free( &reference, &line, NULL );
+	return status;
+}
+
+/* add to 'one' copies of the crossref targets of its references, a target
+ * with a crossref bringing its own
+ */
+static int
+bibl_stream_addtargets( bibl *one, bibl *targets )
+{
+	fields *copy;
+	char *key;
+	long i, t;
+	int n;
+
+	for ( i=0; i<one->n; ++i ) {
+		n = fields_find( one->ref[i], "CROSSREF", LEVEL_ANY );
+		if ( n==FIELDS_NOTFOUND ) continue;
+		key = ( char * ) fields_value( one->ref[i], n, FIELDS_CHRP_NOUSE );
+		if ( bibl_findref( one, key )!=-1 ) continue;
+		t = bibl_findref( targets, key );
+		if ( t==-1 ) continue; /* bibtexin_crossref() will complain */
+		copy = fields_dupl( targets->ref[t] );
+		if ( !copy ) return BIBL_ERR_MEMERR;
+		if ( bibl_addref( one, copy )!=BIBL_OK ) {
+			fields_delete( copy );
+			return BIBL_ERR_MEMERR;
+		}
+	}
+	return BIBL_OK;
+}
+
+/* drop the targets added by bibl_stream_addtargets() */
+static int
+bibl_stream_droptargets( bibl *one )
+{
+	long i;
+
+	if ( one->n < 2 ) return BIBL_OK;
+	for ( i=1; i<one->n; ++i )
+		fields_delete( one->ref[i] );
+	one->n = 1;
+	return bibl_reindex( one );
+}
+
+/* the single reference in 'one' through the rest of bibl_read() and bibl_write() */
+static int
+bibl_stream_one( bibl *one, char *filename, long refnum, param *rp, param *wp,
+		 bibl *targets, strhash *keys, intlist *nsame, FILE *outfp )
+{
+	int status = BIBL_OK;
+	fields out, *ref, *use = &out;
+	direct_data d;
+	bibl conv;
+	FILE *fp;
+
+	bibl_init( &conv );
+	fields_init( &out );
+
+	if ( !rp->output_raw || ( rp->output_raw & BIBL_RAW_WITHCLEAN ) ) {
+		status = bibl_stream_addtargets( one, targets );
+		if ( status!=BIBL_OK ) goto out;
+		status = clean_refs( one, rp );
+		if ( status!=BIBL_OK ) goto out;
+		status = bibl_stream_droptargets( one );
+		if ( status!=BIBL_OK ) goto out;
+	}
+
+	if ( !rp->output_raw || ( rp->output_raw & BIBL_RAW_WITHCHARCONVERT ) ) {
+		status = bibl_fixcharsets( one, rp );
+		if ( status!=BIBL_OK ) goto out;
+	}
+
+	if ( !rp->output_raw ) {
+		/* cleanf could have dropped the reference */
+		if ( one->n==0 ) goto out;
+		status = convert_ref( one->ref[0], filename, refnum, &conv, rp );
+		if ( status!=BIBL_OK ) goto out;
+	} else {
+		status = bibl_copy( &conv, one );
+		if ( status!=BIBL_OK ) goto out;
+	}
+
+	if ( conv.n==0 ) goto out;
+
+	if ( !rp->output_raw || ( rp->output_raw & BIBL_RAW_WITHMAKEREFID ) ) {
+		status = bibl_stream_citekey( conv.ref[0], refnum, keys, nsame, rp->addcount );
+		if ( status!=BIBL_OK ) goto out;
+	}
+
+	if ( rp->direct ) {
+		d.b = &conv;
+		d.p = rp;
+		status = direct_ref( 0, &d );
+		if ( status!=BIBL_OK ) goto out;
+	}
+	ref = conv.ref[0];
+
+	/* the output part, as in bibl_write() */
+	status = bibl_fixcharsetdata( ref, wp );
+	if ( status!=BIBL_OK ) goto out;
+
+	if ( wp->assemblef ) {
+		status = wp->assemblef( ref, &out, wp, refnum-1 );
+		if ( status!=BIBL_OK ) goto out;
+		if ( debug_set( wp ) ) bibl_verbose_reference( &out, "", refnum );
+	} else {
+		use = ref;
+	}
+
+	if ( wp->singlerefperfile ) {
+		fp = singlerefname( ref, refnum-1, wp->writeformat );
+		if ( !fp ) { status = BIBL_ERR_CANTOPEN; goto out; }
+		if ( wp->headerf ) wp->headerf( fp, wp );
+		status = wp->writef( use, fp, wp, refnum-1 );
+		if ( wp->footerf ) wp->footerf( fp );
+		fclose( fp );
+	} else {
+		status = wp->writef( use, outfp, wp, refnum-1 );
+	}
+
+out:
+	fields_free( &out );
+	bibl_free( &conv );
+	return status;
+}
+
+/* bibl_stream()
+ *
+ * Georgi: bounded memory alternative to bibl_read() followed by
+ * bibl_write(). Each reference is read, processed, cleaned, charset
+ * converted, converted, assembled and written before the next one is
+ * read, so only one reference is in memory at any time.
+ *
+ * The passes of bibl_read() which need all references are replaced as
+ * follows:
+ *
+ *   - cleanf sees the current reference and copies of its crossref
+ *     targets (bibtex, biblatex). The targets are found by a first pass
+ *     over the input, bibl_stream_prescan(), and are kept in memory;
+ *
+ *   - citekeys are made unique using the keys seen so far:
+ *     the first occurrence of a key is kept as is and the subsequent ones
+ *     get suffixes 'b', 'c', ... (uniqueify_citekeys() adds suffixes to
+ *     all of them, starting with 'a');
+ *
+ *   - a charset declared in the file takes effect from the reference
+ *     following the declaration (usually at the start of the file anyway).
+ *
+ * 'files' are the nfiles input files, 'outfp' the output. On return *nref
+ * contains the number of references read (cleanf may drop some of them).
+ */
+int
+bibl_stream( int nfiles, char *files[], FILE *outfp, param *p, long *nref )
+{
+	int status, ret = BIBL_OK, fcharset, i;
+	param rp, wp;
+	str reference, line;
+	freader fr;
+	strhash keys, wanted;
+	intlist nsame;
+	bibl one, targets;
+	fields *ref;
+	FILE *fp;
+	long refnum = 0;
+
+	*nref = 0;
+
+	if ( !p || !p->ctx ) return BIBL_ERR_BADINPUT;
+	if ( bibl_illegalinmode( p->readformat ) ) return BIBL_ERR_BADINPUT;
+	if ( bibl_illegaloutmode( p->writeformat ) ) return BIBL_ERR_BADINPUT;
+	if ( !outfp && !p->singlerefperfile ) return BIBL_ERR_BADINPUT;
+
+	status = bibl_setreadparams( &rp, p );
+	if ( status!=BIBL_OK ) return status;
+	status = bibl_setwriteparams( &wp, p );
+	if ( status!=BIBL_OK ) {
+		bibl_freeparams( &rp );
+		return status;
+	}
+
+	if ( debug_set( p ) ) {
+		report_params( "bibl_stream (read)", &rp );
+		report_params( "bibl_stream (write)", &wp );
+	}
+
+	strs_init( &reference, &line, NULL );
+	strhash_init( &keys );
+	strhash_init( &wanted );
+	intlist_init( &nsame );
+	bibl_init( &one );
+	bibl_init( &targets );
+
+	if ( bibl_stream_hascrossrefs( &rp ) )
+		ret = bibl_stream_prescan( nfiles, files, &rp, &wanted, &targets );
+
+	if ( !wp.singlerefperfile && wp.headerf ) wp.headerf( outfp, &wp );
+
+	for ( i=0; i<nfiles && ret==BIBL_OK; ++i ) {
+		fp = fopen( files[i], "r" );
+		if ( !fp ) continue;
+
+		freader_init( &fr, fp );
+		if ( rp.mapfiles ) freader_map( &fr );
+		str_empty( &line );
+		str_empty( &reference );
+
+		while ( rp.readf( &fr, &line, &reference, &fcharset, &rp ) ) {
+			if ( fcharset!=CHARSET_UNKNOWN && rp.charsetin_src!=BIBL_SRC_USER ) {
+				/* as in read_refs() */
+				rp.charsetin_src = BIBL_SRC_FILE;
+				rp.charsetin = fcharset;
+				if ( fcharset!=CHARSET_UNICODE ) rp.utf8in = 0;
+			}
+			if ( rp.charsetin==CHARSET_UNICODE ) rp.utf8in = 1;
+
+			if ( reference.len==0 ) continue;
+
+			ref = fields_new();
+			if ( !ref ) { ret = BIBL_ERR_MEMERR; break; }
+
+			if ( rp.processf( ref, reference.data, files[i], refnum+1, &rp ) ) {
+				/* a crossref target before its first reference */
+				if ( wanted.n ) {
+					ret = bibl_stream_keeptarget( ref, &wanted, &targets );
+					if ( ret!=BIBL_OK ) { fields_delete( ref ); break; }
+				}
+				ret = bibl_addref( &one, ref );
+				if ( ret!=BIBL_OK ) { fields_delete( ref ); break; }
+				refnum++;
+				ret = bibl_stream_one( &one, files[i], refnum, &rp, &wp,
+						       &targets, &keys, &nsame, outfp );
+				bibl_free( &one );
+				if ( ret!=BIBL_OK ) break;
+			} else {
+				fields_delete( ref );
+			}
+			str_empty( &reference );
+		}
+
+		if ( ret==BIBL_OK && fr.status!=FREADER_OK ) ret = BIBL_ERR_MEMERR;
+		freader_free( &fr );
+		fclose( fp );
+	}
+
+	if ( !wp.singlerefperfile && wp.footerf ) wp.footerf( outfp );
+
+	*nref = refnum;
+
+	bibl_free( &targets );
+	bibl_free( &one );
+	intlist_free( &nsame );
+	strhash_free( &wanted );
+	strhash_free( &keys );
+	strs_free( &reference, &line, NULL );
+	bibl_freeparams( &wp );
+	bibl_freeparams( &rp );
+
+	return ret;
+}
+
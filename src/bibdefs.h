@@ -10,6 +10,7 @@
 #define BIBDEFS_H
 
 #include <R.h>
+#include "bibthread.h"
 
 
 
@@ -0,0 +1,320 @@
+/*
+ * bibentrysexp.c
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * Program and source code released under the GPL version 2
+ *
+ */
+
+/* Create the bibentry() calls for the references directly as R objects.
+ *
+ * bibentrydirectout_write() (common_be_bed.c) writes R source code which
+ * readBibentry() then parses and evaluates.  Here the arguments of the
+ * bibentry() calls are created directly from the assembled references:
+ * character strings for the fields and 'person' objects (as created by
+ * person()) for author, editor and translator.  No temporary file and no
+ * call to the R parser are involved.
+ *
+ * The result is an expression vector with one call to bibentry() for each
+ * reference.  The calls themselves are evaluated on the R side, where the
+ * handling of invalid entries (argument 'extra') and of a user supplied
+ * 'fbibentry' is done by the same code as for the R source (see
+ * bibentry_exprs_eval() in R/bibentry.R).
+ */
+#include <string.h>
+#include <ctype.h>
+
+#include "bibutils.h"
+#include "bibprog.h"
+#include "fields.h"
+#include "bibentrysexp.h"
+
+/* the same as in the calls of append_people_be() from bibentryout_assemble()
+ * and bibentrydirectout_assemble()
+ */
+typedef struct {
+	const char *bibtag, *tag, *ctag, *atag;
+	int level;
+} be_people_tags;
+
+static be_people_tags people_tags[] = {
+	{ "author",     "AUTHOR",     "AUTHOR:CORP",     "AUTHOR:ASIS",     LEVEL_MAIN },
+	{ "editor",     "EDITOR",     "EDITOR:CORP",     "EDITOR:ASIS",     LEVEL_ANY  },
+	{ "translator", "TRANSLATOR", "TRANSLATOR:CORP", "TRANSLATOR:ASIS", LEVEL_ANY  },
+};
+static const int npeople_tags = sizeof( people_tags ) / sizeof( people_tags[0] );
+
+/* copy the elements of character vector 'argv' to a char* array, as .C()
+ * does for the *_main() functions (the strings are modified by the argument
+ * processing functions)
+ */
+char **
+bibentry_sexp_argv( SEXP argv, int *argc )
+{
+	char **res;
+	const char *s;
+	int i;
+
+	if ( !isString( argv ) || LENGTH( argv ) < 1 )
+		error( "'argv' must be a non-empty character vector" );
+
+	*argc = LENGTH( argv );
+	res = (char **) R_alloc( *argc + 1, sizeof( char * ) );
+	for ( i=0; i<*argc; ++i ) {
+		s = translateChar( STRING_ELT( argv, i ) );
+		res[i] = (char *) R_alloc( strlen( s ) + 1, sizeof( char ) );
+		strcpy( res[i], s );
+	}
+	res[*argc] = NULL;
+
+	return res;
+}
+
+static SEXP
+be_mkchar( const char *s, int len )
+{
+	if ( len < 0 ) len = strlen( s );
+	return mkCharLenCE( s, len, CE_UTF8 );
+}
+
+static SEXP
+be_mkstring( const char *s )
+{
+	return ScalarString( be_mkchar( s, -1 ) );
+}
+
+/* one element of a 'person' object, with the components in the order used
+ * by person(); 'given' and 'family' should be protected by the caller
+ */
+static SEXP
+be_person1( SEXP given, SEXP family )
+{
+	static const char *nms[] = { "given", "family", "role", "email", "comment" };
+	SEXP res, names;
+	int i;
+
+	PROTECT( res = allocVector( VECSXP, 5 ) );
+	SET_VECTOR_ELT( res, 0, given );
+	SET_VECTOR_ELT( res, 1, family );
+
+	PROTECT( names = allocVector( STRSXP, 5 ) );
+	for ( i=0; i<5; ++i )
+		SET_STRING_ELT( names, i, mkChar( nms[i] ) );
+	setAttrib( res, R_NamesSymbol, names );
+
+	UNPROTECT( 2 );
+	return res;
+}
+
+/* 'p' is a parsed name, 'family|given|given||suffix', split it in the same
+ * way as name_build_bibentry_direct() (common_be_bed.c) does
+ */
+static SEXP
+be_person_name( const char *p )
+{
+	const char *suffix, *stopat, *q;
+	const char **start;
+	int *len, nseg, nalloc, i, flen;
+	char *fam;
+	SEXP given, family, res;
+
+	suffix = strstr( p, "||" );
+	if ( suffix ) stopat = suffix;
+	else stopat = strchr( p, '\0' );
+
+	nalloc = 1;
+	for ( q=p; q!=stopat; ++q )
+		if ( *q=='|' ) nalloc++;
+	start = (const char **) R_alloc( nalloc, sizeof( const char * ) );
+	len   = (int *) R_alloc( nalloc, sizeof( int ) );
+
+	nseg = 0;
+	while ( p != stopat ) {
+		start[nseg] = p;
+		while ( p!=stopat && *p!='|' ) p++;
+		len[nseg] = p - start[nseg];
+		if ( p!=stopat && *p=='|' ) p++;
+		nseg++;
+	}
+
+	if ( nseg==0 ) { /* shouldn't happen */
+		start[0] = p;
+		len[0] = 0;
+		nseg = 1;
+	}
+
+	/* the suffix goes to the family name but only if there is a given name */
+	if ( nseg>1 && suffix ) {
+		flen = len[0] + 1 + strlen( suffix + 2 );
+		fam = R_alloc( flen + 1, sizeof( char ) );
+		memcpy( fam, start[0], len[0] );
+		fam[len[0]] = ' ';
+		strcpy( fam + len[0] + 1, suffix + 2 );
+		PROTECT( family = ScalarString( be_mkchar( fam, flen ) ) );
+	} else {
+		PROTECT( family = ScalarString( be_mkchar( start[0], len[0] ) ) );
+	}
+
+	if ( nseg>1 ) {
+		PROTECT( given = allocVector( STRSXP, nseg - 1 ) );
+		for ( i=1; i<nseg; ++i )
+			SET_STRING_ELT( given, i-1, be_mkchar( start[i], len[i] ) );
+	} else {
+		PROTECT( given = R_NilValue );
+	}
+
+	res = be_person1( given, family );
+
+	UNPROTECT( 2 );
+	return res;
+}
+
+/* the people for one of the entries of people_tags[], as a 'person' object */
+static SEXP
+be_people( fields *in, be_people_tags *pt )
+{
+	int i, n, npeople;
+	char *tag;
+	SEXP res, family, cls;
+
+	npeople = 0;
+	for ( i=0; i<in->n; ++i ) {
+		if ( pt->level!=LEVEL_ANY && in->level[i]!=pt->level ) continue;
+		tag = fields_tag( in, i, FIELDS_CHRP_NOUSE );
+		if ( !strcasecmp( tag, pt->tag ) || !strcasecmp( tag, pt->ctag ) ||
+		     !strcasecmp( tag, pt->atag ) )
+			npeople++;
+	}
+
+	PROTECT( res = allocVector( VECSXP, npeople ) );
+	n = 0;
+	for ( i=0; i<in->n && n<npeople; ++i ) {
+		if ( pt->level!=LEVEL_ANY && in->level[i]!=pt->level ) continue;
+		tag = fields_tag( in, i, FIELDS_CHRP_NOUSE );
+		if ( !strcasecmp( tag, pt->tag ) ) {
+			SET_VECTOR_ELT( res, n++,
+					be_person_name( fields_value( in, i, FIELDS_CHRP ) ) );
+		} else if ( !strcasecmp( tag, pt->ctag ) || !strcasecmp( tag, pt->atag ) ) {
+			PROTECT( family = be_mkstring( fields_value( in, i, FIELDS_CHRP ) ) );
+			SET_VECTOR_ELT( res, n++, be_person1( R_NilValue, family ) );
+			UNPROTECT( 1 );
+		}
+	}
+
+	PROTECT( cls = mkString( "person" ) );
+	setAttrib( res, R_ClassSymbol, cls );
+
+	UNPROTECT( 2 );
+	return res;
+}
+
+typedef struct {
+	SEXP exprs;
+	SEXP fun;
+} be_data;
+
+/* create the call to bibentry() for one reference, the counterpart of
+ * bibentrydirectout_write()
+ */
+static int
+be_addcall( fields *in, fields *out, void *data, unsigned long refnum )
+{
+	be_data *d = (be_data *) data;
+	SEXP args, a, val, call;
+	char *tag, *value, *s;
+	int i, j, k, len;
+
+	PROTECT( args = allocList( out->n ) );
+	a = args;
+
+	/* bibtype, capitalised as by bibentrydirectout_write() */
+	value = (char *) fields_value( out, 0, FIELDS_CHRP );
+	len = ( value ) ? strlen( value ) : 0;
+	s = R_alloc( len + 1, sizeof( char ) );
+	for ( i=0; i<len; ++i )
+		s[i] = ( i==0 ) ? toupper( (unsigned char) value[i] ) : tolower( (unsigned char) value[i] );
+	s[len] = '\0';
+	SETCAR( a, be_mkstring( s ) );
+	SET_TAG( a, install( "bibtype" ) );
+	a = CDR( a );
+
+	/* key */
+	if ( out->n > 1 ) {
+		SETCAR( a, be_mkstring( (char *) fields_value( out, 1, FIELDS_CHRP ) ) );
+		SET_TAG( a, install( "key" ) );
+		a = CDR( a );
+	}
+
+	for ( j=2; j<out->n; ++j ) {
+		tag   = (char *) fields_tag( out, j, FIELDS_CHRP );
+		value = (char *) fields_value( out, j, FIELDS_CHRP );
+
+		for ( k=0; k<npeople_tags; ++k )
+			if ( !strcmp( tag, people_tags[k].bibtag ) ) break;
+
+		if ( k < npeople_tags ) {
+			val = be_people( in, &people_tags[k] );
+		} else if ( !strcmp( tag, "other" ) ) {
+			/* append_key() puts c(key = "value") here */
+			i = fields_find( in, "KEY", LEVEL_ANY );
+			PROTECT( val = be_mkstring( ( i!=FIELDS_NOTFOUND ) ?
+						    (char *) fields_value( in, i, FIELDS_CHRP ) : "" ) );
+			setAttrib( val, R_NamesSymbol, mkString( "key" ) );
+			UNPROTECT( 1 );
+		} else {
+			val = be_mkstring( value );
+		}
+		SETCAR( a, val );
+
+		/* tags of fields unknown to bibutils come quoted, see
+		 * append_simple_quoted_tag() in bibentrydirectout.c
+		 */
+		len = strlen( tag );
+		if ( len>=2 && tag[0]=='\"' && tag[len-1]=='\"' ) {
+			s = R_alloc( len - 1, sizeof( char ) );
+			memcpy( s, tag + 1, len - 2 );
+			s[len-2] = '\0';
+			SET_TAG( a, install( s ) );
+		} else {
+			SET_TAG( a, install( tag ) );
+		}
+		a = CDR( a );
+	}
+
+	PROTECT( call = lcons( d->fun, args ) );
+	SET_VECTOR_ELT( d->exprs, refnum, call );
+
+	UNPROTECT( 2 );
+	return BIBL_OK;
+}
+
+/* like bibprog() but returns an expression vector containing bibentry()
+ * calls, instead of writing them to a file. 'p' should be set up for output
+ * with bibentryout_initparams() or bibentrydirectout_initparams().
+ */
+SEXP
+bibprog_bibentry( int argc, char *argv[], param *p )
+{
+	bibl b;
+	be_data d;
+	int status;
+
+	bibl_init( &b );
+	bibprog_read( argc, argv, p, &b );
+
+	PROTECT( d.exprs = allocVector( EXPRSXP, b.n ) );
+	d.fun = install( "bibentry" );
+
+	status = bibl_assemble( &b, p, be_addcall, &d );
+
+	bibl_free( &b );
+
+	if ( status!=BIBL_OK ) {
+		bibl_reporterr( status );
+		error( "conversion to bibentry failed" );
+	}
+
+	UNPROTECT( 1 );
+	return d.exprs;
+}
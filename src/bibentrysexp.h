@@ -0,0 +1,20 @@
+/*
+ * bibentrysexp.h
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * Program and source code released under the GPL version 2
+ *
+ */
+#ifndef BIBENTRYSEXP_H
+#define BIBENTRYSEXP_H
+
+#include <R.h>
+#include <Rinternals.h>
+
+#include "bibutils.h"
+
+char **bibentry_sexp_argv( SEXP argv, int *argc );
+SEXP   bibprog_bibentry( int argc, char *argv[], param *p );
+
+#endif
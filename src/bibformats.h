@@ -35,6 +35,9 @@ int wordin_initparams     ( param *pm, const char *progname );
 int wordout_initparams    ( param *pm, const char *progname );
 
 int bibentryout_initparams( param *pm, const char *progname ); //Georgi
+
+/* Georgi: the fields read back from the MODS XML of a reference, see modsout.c */
+int modsout_direct( fields *in, fields *out, param *p );
 #endif
 
 
@@ -17,6 +17,22 @@ bibl_init( bibl *b )
 {
 	b->n   = b->max = 0L;
 	b->ref = NULL;
+	strhash_init( &(b->keys) );
+}
+
+/* add the citekey of b->ref[i], if any, to the index */
+static int
+bibl_indexref( bibl *b, long i )
+{
+	int n;
+
+	n = fields_find( b->ref[i], "refnum", LEVEL_ANY );
+	if ( n==FIELDS_NOTFOUND ) return BIBL_OK;
+
+	if ( strhash_add( &(b->keys), fields_value( b->ref[i], n, FIELDS_CHRP_NOUSE ), i )!=STRHASH_OK )
+		return BIBL_ERR_MEMERR;
+
+	return BIBL_OK;
 }
 
 static int
@@ -60,6 +76,9 @@ bibl_addref( bibl *b, fields *ref )
 	if ( status==BIBL_OK ) {
 		b->ref[ b->n ] = ref;
 		b->n++;
+		status = bibl_indexref( b, b->n - 1 );
+		/* on failure the caller still owns ref */
+		if ( status!=BIBL_OK ) b->n--;
 	}
 	return status;
 }
@@ -73,6 +92,7 @@ bibl_free( bibl *b )
 		fields_delete( b->ref[i] );
 
 	free( b->ref );
+	strhash_free( &(b->keys) );
 
 	bibl_init( b );
 }
@@ -101,24 +121,36 @@ bibl_copy( bibl *bout, bibl *bin )
 	return BIBL_OK;
 }
 
-/* bibl_findref()
+/* bibl_reindex()
  *
- * returns position of reference matching citekey, else -1
+ * rebuilds the citekey index, returns BIBL_OK or BIBL_ERR_MEMERR
  */
-long
-bibl_findref( bibl *bin, const char *citekey )
+int
+bibl_reindex( bibl *b )
 {
+	int status;
 	long i;
-	int n;
 
-	for ( i=0; i<bin->n; ++i ) {
+	strhash_empty( &(b->keys) );
 
-		n = fields_find( bin->ref[i], "refnum", LEVEL_ANY );
-		if ( n==FIELDS_NOTFOUND ) continue;
+	for ( i=0; i<b->n; ++i ) {
+		status = bibl_indexref( b, i );
+		if ( status!=BIBL_OK ) return status;
+	}
 
-		if ( !strcmp( fields_value( bin->ref[i], n, FIELDS_CHRP_NOUSE ), citekey ) ) return i;
+	return BIBL_OK;
+}
 
-	}
+/* bibl_findref()
+ *
+ * returns position of the first reference matching citekey, else -1
+ */
+long
+bibl_findref( bibl *bin, const char *citekey )
+{
+	long i;
+
+	i = strhash_find( &(bin->keys), citekey );
 
-	return -1;
+	return ( i==STRHASH_NOTFOUND ) ? -1 : i;
 }
@@ -13,11 +13,17 @@
 #include "str.h"
 #include "fields.h"
 #include "reftypes.h"
+#include "strhash.h"
 
+/* Georgi: 'keys' maps the citekeys (REFNUM) to the positions of the
+ * references. It is updated by bibl_addref(); code changing the citekeys of
+ * references already in the list should call bibl_reindex() afterwards.
+ */
 typedef struct {
 	long n;
 	long max;
 	fields **ref;
+	strhash keys;
 } bibl;
 
 void bibl_init( bibl *b );
@@ -25,6 +31,7 @@ int  bibl_addref( bibl *b, fields *ref );
 void bibl_free( bibl *b );
 int  bibl_copy( bibl *bout, bibl *bin );
 long bibl_findref( bibl *bin, const char *citekey );
+int  bibl_reindex( bibl *b );
 
 #endif
 
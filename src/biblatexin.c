@@ -30,9 +30,6 @@
 extern variants biblatex_all[];
 extern int biblatex_nall;
 
-extern slist find;
-extern slist replace;
-
 /*****************************************************
  PUBLIC: void biblatexin_initparams()
 *****************************************************/
@@ -68,11 +65,6 @@ biblatexin_initparams( param *pm, const char *progname )
 	slist_init( &(pm->asis) );
 	slist_init( &(pm->corps) );
 
- 	// TODO: these probably should be made parameters, as the others above;
-	//       note that 'find' and 'replace' work in tandem, so both need to be cleared.
-	slist_free( &find );
-	slist_free( &replace );
-
 	if ( !progname ) pm->progname = NULL;
 	else {
 		pm->progname = strdup( progname );
@@ -128,6 +120,7 @@ biblatexin_processf( fields *bibin, const char *data, const char *filename, long
 	currloc.progname = p->progname;
 	currloc.filename = filename;
 	currloc.nref     = nref;
+	currloc.ctx      = p->ctx;
 
 	if ( !strncasecmp( data, "@STRING", 7 ) ) {
 	  process_string( data+7, &currloc );   // TODO: use currloc
@@ -11,39 +11,50 @@
 #include "bibutils.h"
 #include "bibprog.h"
 
-//Georgi
-// void
-double
-bibprog( int argc, char *argv[], param *p, char *outfile[] )
+/* Georgi: read the references from the files argv[1], ..., argv[argc-1]
+ *         (stdin if there are none) into 'b'; taken out of bibprog() to
+ *         be used also by bibprog_bibentry() (bibentrysexp.c).
+ */
+void
+bibprog_read( int argc, char *argv[], param *p, bibl *b )
 {
 	FILE *fp;
-	bibl b;
 	int err, i;
-	// REprintf("(bibprog) start of bibprog!\n");
 
-	// Georgi
-	FILE *fout;
-	// fout = fopen("bbbbb.bib", "w");
-	fout = fopen(outfile[0], "w");
-	
-	bibl_init( &b );
-	// REprintf("(bibprog) before bibl_read!\n");
 	if ( argc<2 ) {
 	    REprintf("(bibprog) args < 2\n");
 
-		err = bibl_read( &b, stdin, "stdin", p );
+		err = bibl_read( b, stdin, "stdin", p );
 		if ( err ) bibl_reporterr( err ); 
 	} else {
 	        // REprintf("(bibprog) args >= 2\n");
 		for ( i=1; i<argc; ++i ) {
 			fp = fopen( argv[i], "r" );
 			if ( fp ) {
-				err = bibl_read( &b, fp, argv[i], p );
+				err = bibl_read( b, fp, argv[i], p );
 				if ( err ) bibl_reporterr( err );
 				fclose( fp );
 			}
 		} 
 	}
+}
+
+//Georgi
+// void
+double
+bibprog( int argc, char *argv[], param *p, char *outfile[] )
+{
+	bibl b;
+	// REprintf("(bibprog) start of bibprog!\n");
+
+	// Georgi
+	FILE *fout;
+	// fout = fopen("bbbbb.bib", "w");
+	fout = fopen(outfile[0], "w");
+	
+	bibl_init( &b );
+	// REprintf("(bibprog) before bibl_read!\n");
+	bibprog_read( argc, argv, p, &b );
 	// REprintf("(bibprog) after bibl_read!\n");
 	
 	// Georgi: for testing
@@ -69,8 +80,27 @@ bibprog( int argc, char *argv[], param *p, char *outfile[] )
 	return val; 
 }
 
+/* Georgi: like bibprog() but with bibl_stream(), i.e. each reference is
+ *         written out before the next one is read
+ */
+double
+bibprog_stream( int argc, char *argv[], param *p, char *outfile[] )
+{
+	FILE *fout;
+	long n = 0;
+	int err;
 
+	fout = fopen( outfile[0], "w" );
+	if ( !fout ) {
+		REprintf( "(bibprog_stream) cannot open file %s\n", outfile[0] );
+		return 0.0;
+	}
 
+	err = bibl_stream( argc - 1, argv + 1, fout, p, &n );
+	if ( err ) bibl_reporterr( err );
 
+	fflush( fout );
+	fclose( fout );
 
-
+	return (double) n;
+}
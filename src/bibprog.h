@@ -15,5 +15,7 @@
 // Georgi
 //void bibprog( int argc, char *argv[], param *p, char *outfile[] );
 double bibprog( int argc, char *argv[], param *p, char *outfile[] );
+double bibprog_stream( int argc, char *argv[], param *p, char *outfile[] );
+void bibprog_read( int argc, char *argv[], param *p, bibl *b );
 
 #endif
@@ -30,13 +30,6 @@
 #include "common_bt_btd_blt.h"
 #include "common_bt_btd.h"
 
-extern slist find;
-extern slist replace;
-
-extern int rdpack_patch_for_i_acute_variant;
-extern int convert_latex_escapes_only; // Georgi
-extern int export_tex_chars_only;      // Georgi
-
 /*****************************************************
  PUBLIC: void bibtexdirectin_initparams()
 *****************************************************/
@@ -70,10 +63,6 @@ bibtexdirectin_initparams( param *pm, const char *progname )
 	slist_init( &(pm->asis) );
 	slist_init( &(pm->corps) );
 
-	//    note that 'find' and 'replace' work in tandem, so both need to be cleared.
-	// slist_free( &find );
-	// slist_free( &replace );
-
 	if ( !progname ) pm->progname = NULL;
 	else {
 		pm->progname = strdup( progname );
@@ -83,20 +72,6 @@ bibtexdirectin_initparams( param *pm, const char *progname )
 	return BIBL_OK;
 }
 
-// Georgi
-// void (*more_cleanf)()
-void bibdirectin_more_cleanf( void )
-{
-  // TODO: these probably should be made parameters, as the others above;
-  //       note that 'find' and 'replace' work in tandem, so both need to be cleared.
-  slist_free( &find );
-  slist_free( &replace );
-  convert_latex_escapes_only = 0;
-  export_tex_chars_only = 0;
-  rdpack_patch_for_i_acute_variant = 0;
-
-}
-
 /*****************************************************
  PUBLIC: void bibtexdirectin_cleanf()
 *****************************************************/
@@ -142,15 +117,15 @@ bibtexdirectin_cleanref( fields *bibin, param *pm )
 
 	  // }
 
-	  if(convert_latex_escapes_only) { // convert
+	  if(pm->ctx->latex_escapes_only) { // convert
 	       str_convert( value,
 			    // pm->charsetin,  pm->latexin,  pm->utf8in,  pm->xmlin,
-			    pm->charsetin,  1,  pm->utf8in,  pm->xmlin,
+			    pm->charsetin,  STR_CONV_LATEX_ESCAPES,  pm->utf8in,  pm->xmlin,
 			    // pm->charsetout, pm->latexout, pm->utf8out, pm->xmlout );
 			    pm->charsetout, 0, pm->utf8out, pm->xmlout );
 	  }
 	
-	  if(rdpack_patch_for_i_acute_variant) {
+	  if(pm->ctx->rdpack_i_acute) {
 	    // This may introduce {{\\'\\i}} if \\'i was already in braces.
 	    // In names this doesn't matter since braces are removed anyway.
 	    // In other fields the superfluous braces probably don't matter either
@@ -175,7 +150,7 @@ bibtexdirectin_cleanref( fields *bibin, param *pm )
 	  }
 	  else {
 	    //   status = bibtex_cleanvalue( value );
-	    if(rdpack_patch_for_i_acute_variant) {
+	    if(pm->ctx->rdpack_i_acute) {
 	      str_findreplace(value, "{{\\'\\i}}",  "{\\'\\i}");
 	    }
 	    //   if ( status!=BIBL_OK ) goto out;
@@ -29,12 +29,6 @@
 #include "common_bt_btd_blt.h"
 #include "common_bt_btd.h"
 
-extern slist find;
-extern slist replace;
-
-extern int convert_latex_escapes_only;
-
-
 /*****************************************************
  PUBLIC: void bibtexin_initparams()
 *****************************************************/
@@ -73,10 +67,6 @@ bibtexin_initparams( param *pm, const char *progname )
 	slist_init( &(pm->asis) );
 	slist_init( &(pm->corps) );
 
-	//    note that 'find' and 'replace' work in tandem, so both need to be cleared.
-	slist_free( &find );
-	slist_free( &replace );
-
 	if ( !progname ) pm->progname = NULL;
 	else {
 		pm->progname = strdup( progname );
@@ -139,10 +129,10 @@ bibtexin_cleanref( fields *bibin, param *pm )
 	  // for latex escape characters, initially done for 'direct'
 	  //
 	  // this if(convert_latex_escapes_only) block copied from bibtexdirectin_cleanref
-	  if(convert_latex_escapes_only) { // convert
+	  if(pm->ctx->latex_escapes_only) { // convert
 	       str_convert( value,
 			    // pm->charsetin,  pm->latexin,  pm->utf8in,  pm->xmlin,
-			    pm->charsetin,  1,  pm->utf8in,  pm->xmlin,
+			    pm->charsetin,  STR_CONV_LATEX_ESCAPES,  pm->utf8in,  pm->xmlin,
 			    // pm->charsetout, pm->latexout, pm->utf8out, pm->xmlout );
 			    pm->charsetout, 0, pm->utf8out, pm->xmlout );
 	  }
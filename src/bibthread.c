@@ -0,0 +1,135 @@
+/*
+ * bibthread.c
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * Source code released under the GPL version 2
+ *
+ */
+
+/* Run the per-reference stages of a conversion (bibl_fixcharsets(),
+ * convert_refs() and the assemblef of the output format, see bibcore.c)
+ * on several threads.
+ *
+ * bibl_parallel( n, nthreads, f, data ) calls f( i, data ) for i = 0,...,n-1
+ * and returns the first status (in the order of 'i') which is not BIBL_OK.
+ * If 'nok' is not NULL, *nok is set to the number of calls before that one
+ * (n if all calls succeeded).
+ * With nthreads <= 1, or if the package was compiled without OpenMP, this
+ * is a plain loop stopping at the first error.
+ *
+ * Otherwise the calls are spread over the threads.  Each call gets its own
+ * message buffer, so whatever f() prints with REprintf() is kept until all
+ * calls are done and then printed in the order of 'i', up to and including
+ * the first call that failed.  Hence the messages are exactly those printed
+ * by the serial loop.  The calls after the first failure are still made, so
+ * f() should not do anything that cannot be undone by the caller.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <R.h>
+#include <R_ext/Print.h>
+
+#include "bibdefs.h"
+#include "str.h"
+#include "bibthread.h"
+
+/* the real thing, see the #define in bibthread.h */
+#undef REprintf
+
+static str *bibl_msgbuf = NULL;
+#ifdef _OPENMP
+#pragma omp threadprivate( bibl_msgbuf )
+#endif
+
+void
+bibl_REprintf( const char *fmt, ... )
+{
+	char buf[512], *s = buf;
+	va_list ap, aq;
+	int n;
+
+	va_start( ap, fmt );
+
+	if ( !bibl_msgbuf ) {
+		REvprintf( fmt, ap );
+		va_end( ap );
+		return;
+	}
+
+	va_copy( aq, ap );
+	n = vsnprintf( buf, sizeof( buf ), fmt, ap );
+	if ( n >= (int) sizeof( buf ) ) {
+		s = ( char * ) malloc( n + 1 );
+		if ( s ) vsnprintf( s, n + 1, fmt, aq );
+	}
+	va_end( aq );
+	va_end( ap );
+
+	if ( s && n > 0 ) str_strcatc( bibl_msgbuf, s );
+	if ( s != buf ) free( s );
+}
+
+int
+bibl_parallel( long n, int nthreads, int (*f)( long i, void *data ), void *data,
+	       long *nok )
+{
+	int status = BIBL_OK;
+	long i;
+
+#if defined( _OPENMP ) && !defined( STR_SMALL )
+	/* with STR_SMALL the str functions report a failed allocation with
+	 * error(), which is not allowed on the threads, see str.c */
+	int *st;
+	str *msg;
+
+	if ( nthreads > 1 && n > 1 ) {
+		st  = ( int * ) malloc( sizeof( int ) * n );
+		msg = ( str * ) malloc( sizeof( str ) * n );
+		if ( !st || !msg ) {
+			if ( st ) free( st );
+			if ( msg ) free( msg );
+			if ( nok ) *nok = 0;
+			return BIBL_ERR_MEMERR;
+		}
+		for ( i=0; i<n; ++i ) str_init( &(msg[i]) );
+
+#pragma omp parallel for num_threads( nthreads ) schedule( dynamic, 16 )
+		for ( i=0; i<n; ++i ) {
+			bibl_msgbuf = &(msg[i]);
+			st[i] = f( i, data );
+			bibl_msgbuf = NULL;
+		}
+
+		for ( i=0; i<n; ++i ) {
+			if ( str_has_value( &(msg[i]) ) )
+				REprintf( "%s", str_cstr( &(msg[i]) ) );
+			if ( st[i]!=BIBL_OK ) {
+				status = st[i];
+				break;
+			}
+		}
+
+		if ( nok ) *nok = i;
+
+		for ( i=0; i<n; ++i ) str_free( &(msg[i]) );
+		free( msg );
+		free( st );
+		return status;
+	}
+#endif
+
+	for ( i=0; i<n; ++i ) {
+		status = f( i, data );
+		if ( status!=BIBL_OK ) break;
+	}
+	if ( nok ) *nok = i;
+
+	return status;
+}
@@ -0,0 +1,56 @@
+/*
+ * bibthread.h
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * Source code released under the GPL version 2
+ *
+ */
+#ifndef BIBTHREAD_H
+#define BIBTHREAD_H
+
+/* Georgi: the R API, including REprintf(), may only be called from the main
+ * thread.  The messages printed while bibl_parallel() is running are
+ * collected per reference and printed afterwards, in the order of the
+ * references, so that the output is the same as for serial processing.
+ *
+ * This file should be included after R.h (bibdefs.h and fields.h do this).
+ */
+void bibl_REprintf( const char *fmt, ... );
+#define REprintf bibl_REprintf
+
+int  bibl_parallel( long n, int nthreads, int (*f)( long i, void *data ), void *data,
+		    long *nok );
+
+/* Georgi: the tables built on first use (tagatom.c, charsets.c, gb18030.c,
+ * latex.c, entities.c, str_conv.c) are shared by the threads. Each is
+ * published by bibl_store_release( p, v ), after the table is complete and
+ * inside the critical section building it, and read by
+ * bibl_load_acquire( v, p ), which sets v to p. A thread seeing the new
+ * value sees the whole table.
+ *
+ * The gcc/clang builtins are used where available, otherwise OpenMP atomics
+ * with flushes. Without OpenMP there are no threads.
+ */
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define bibl_load_acquire( v, p )  (v) = __atomic_load_n( &(p), __ATOMIC_ACQUIRE )
+#define bibl_store_release( p, v ) __atomic_store_n( &(p), (v), __ATOMIC_RELEASE )
+#elif defined( _OPENMP )
+#define bibl_load_acquire( v, p ) \
+do { \
+	_Pragma( "omp atomic read" ) \
+	(v) = (p); \
+	_Pragma( "omp flush" ) \
+} while ( 0 )
+#define bibl_store_release( p, v ) \
+do { \
+	_Pragma( "omp flush" ) \
+	_Pragma( "omp atomic write" ) \
+	(p) = (v); \
+} while ( 0 )
+#else
+#define bibl_load_acquire( v, p )  (v) = (p)
+#define bibl_store_release( p, v ) (p) = (v)
+#endif
+
+#endif
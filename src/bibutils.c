@@ -16,6 +16,12 @@ bibl_initparams( param *p, int readmode, int writemode, char *progname )
 {
 	int status;
 
+	/* the caller should set p->ctx, see bibl_initcontext() */
+	p->ctx = NULL;
+	p->nthreads = 1;
+	p->mapfiles = 0;
+	p->direct = 0;
+
 	switch ( readmode ) {
 	case BIBL_BIBTEXIN:     status = bibtexin_initparams  ( p, progname ); break;
 	case BIBL_BIBLATEXIN:   status = biblatexin_initparams( p, progname ); break;
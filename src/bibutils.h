@@ -20,6 +20,7 @@ extern "C" {
 #include "slist.h"
 #include "charsets.h"
 #include "str_conv.h"
+#include "freader.h"
 
 #define BIBL_FIRSTIN      (100)
 #define BIBL_MODSIN       (BIBL_FIRSTIN)
@@ -81,6 +82,24 @@ extern "C" {
 
 typedef unsigned char uchar;
 
+/* Georgi: the state of a single conversion.  This used to be kept in global
+ * variables (find/replace in common_bt_btd_blt.c, xml_pns in xml.c,
+ * journals/njournals in xml2any.c and the flags below), so two conversions
+ * could not run at the same time.  It is created by the caller (see e.g.
+ * xml2any_main()) and reached from the callbacks through param->ctx.
+ */
+typedef struct bibl_context {
+	slist find;    /* bibtex @STRING macros seen so far */
+	slist replace; /* ...and their values */
+	uchar latex_escapes_only; /* was convert_latex_escapes_only (latex.c) */
+	uchar tex_chars_only;     /* was export_tex_chars_only (str_conv.c) */
+	uchar rdpack_i_acute;     /* was rdpack_patch_for_i_acute_variant (name.c) */
+	char **journals;          /* journal abbreviations for adsout */
+	int  njournals;
+	char *xml_pns;            /* namespace prefix of the MODS input, or NULL */
+	uchar quiet;              /* no parser warnings, see bibl_stream() */
+} bibl_context;
+
 typedef struct param {
 
 	int readformat;
@@ -111,8 +130,12 @@ typedef struct param {
 
 	char *progname;
 
+	bibl_context *ctx; /* Georgi: conversion state, see above */
+	int nthreads;      /* Georgi: threads for the per-reference stages, see bibthread.c */
+	int mapfiles;      /* Georgi: map input files into memory, see freader_map() */
+	int direct;        /* Georgi: converting without MODS XML, see any2any.c */
 
-        int  (*readf)(FILE*,char*,int,int*,str*,str*,int*);
+        int  (*readf)(freader*,str*,str*,int*,struct param*);
         int  (*processf)(fields*,const char*,const char*,long,struct param*);
         int  (*cleanf)(bibl*,struct param*);
         int  (*typef) (fields*,const char*,int,struct param*);
@@ -129,12 +152,20 @@ typedef struct param {
 
 int  bibl_initparams( param *p, int readmode, int writemode, char *progname );
 void bibl_freeparams( param *p );
+void bibl_initcontext( bibl_context *ctx );
+void bibl_freecontext( bibl_context *ctx );
+int  bibl_latexin( param *p );
+int  bibl_latexout( param *p );
 int  bibl_readasis( param *p, char *filename );
 int  bibl_addtoasis( param *p, char *entry );
 int  bibl_readcorps( param *p, char *filename );
 int  bibl_addtocorps( param *p, char *entry );
 int  bibl_read( bibl *b, FILE *fp, char *filename, param *p );
 int  bibl_write( bibl *b, FILE *fp, param *p );
+int  bibl_stream( int nfiles, char *files[], FILE *outfp, param *p, long *nref );
+int  bibl_assemble( bibl *b, param *p,
+		    int (*f)( fields *in, fields *out, void *data, unsigned long refnum ),
+		    void *data );
 void bibl_reporterr( int err );
 
 #ifdef __cplusplus
@@ -15,6 +15,7 @@
 
 
 #include "charsets.h"
+#include "bibthread.h"
 
 #define ARRAYSIZE( a )     ( sizeof(a) / sizeof(a[0]) )
 #define ARRAYSTART( a )    ( &(a[0]) )
@@ -34628,11 +34629,97 @@ charset_lookupchar( int charsetin, char c )
 	return allcharconvert[charsetin].table[uc].unicode;
 }
 
+/* Georgi: reverse maps for charset_lookupuni()
+ *
+ * Built on first use for each charset: pages of 256 code points of the BMP,
+ * indexed by the code point divided by 256 (NULL for pages without entries),
+ * holding the output byte plus 1 (0 if there is none). The first entry of
+ * the table wins, as with the linear search they replace. The maps are
+ * shared by the threads of bibl_parallel() (see bibthread.c) and never freed.
+ */
+#define CHARSET_NPAGES   (256)
+#define CHARSET_PAGESIZE (256)
+
+typedef struct charset_reverse {
+	unsigned short *page[ CHARSET_NPAGES ];
+} charset_reverse;
+
+static charset_reverse *charset_reverses[ ARRAYSIZE( allcharconvert ) ];
+
+static void
+charset_reverse_delete( charset_reverse *r )
+{
+	int i;
+	for ( i=0; i<CHARSET_NPAGES; ++i )
+		if ( r->page[i] ) free( r->page[i] );
+	free( r );
+}
+
+static charset_reverse *
+charset_reverse_build( int n )
+{
+	unsigned int u, p;
+	charset_reverse *r;
+	int i;
+
+	r = ( charset_reverse * ) calloc( 1, sizeof( charset_reverse ) );
+	if ( !r ) return NULL;
+
+	for ( i=0; i<allcharconvert[n].ntable; ++i ) {
+		u = allcharconvert[n].table[i].unicode;
+		if ( u >= CHARSET_NPAGES * CHARSET_PAGESIZE ) continue;
+		p = u / CHARSET_PAGESIZE;
+		if ( !r->page[p] ) {
+			r->page[p] = ( unsigned short * ) calloc( CHARSET_PAGESIZE, sizeof( unsigned short ) );
+			if ( !r->page[p] ) {
+				charset_reverse_delete( r );
+				return NULL;
+			}
+		}
+		if ( !r->page[p][ u % CHARSET_PAGESIZE ] )
+			r->page[p][ u % CHARSET_PAGESIZE ] = allcharconvert[n].table[i].index + 1;
+	}
+
+	return r;
+}
+
+/* NULL only on memory error */
+static charset_reverse *
+charset_reverse_get( int n )
+{
+	charset_reverse *r;
+
+	bibl_load_acquire( r, charset_reverses[n] );
+	if ( !r ) {
+#ifdef _OPENMP
+#pragma omp critical ( charset_reverse )
+#endif
+		{
+			r = charset_reverses[n];
+			if ( !r ) {
+				r = charset_reverse_build( n );
+				if ( r ) bibl_store_release( charset_reverses[n], r );
+			}
+		}
+	}
+
+	return r;
+}
+
 unsigned int
 charset_lookupuni( int charsetout, unsigned int unicode )
 {
+	charset_reverse *r;
+	unsigned short *page;
 	int i;
 	if ( charsetout==CHARSET_UNICODE ) return unicode;
+	r = charset_reverse_get( charsetout );
+	if ( r && unicode < CHARSET_NPAGES * CHARSET_PAGESIZE ) {
+		page = r->page[ unicode / CHARSET_PAGESIZE ];
+		if ( page && page[ unicode % CHARSET_PAGESIZE ] )
+			return page[ unicode % CHARSET_PAGESIZE ] - 1;
+		return '?';
+	}
 	for ( i=0; i<allcharconvert[charsetout].ntable; ++i ) {
 		if ( unicode == allcharconvert[charsetout].table[i].unicode )
 			return allcharconvert[charsetout].table[i].index;
@@ -124,9 +124,9 @@ append_people_be( fields *in, char *tag, char *ctag, char *atag,
 	npeople = 0;
 	for ( i=0; i<in->n; ++i ) {
 		if ( level!=LEVEL_ANY && in->level[i]!=level ) continue;
-		person = ( strcasecmp( in->tag[i].data, tag ) == 0 );
-		corp   = ( strcasecmp( in->tag[i].data, ctag ) == 0 );
-		asis   = ( strcasecmp( in->tag[i].data, atag ) == 0 );
+		person = ( fields_match_casetag( in, i, tag ) );
+		corp   = ( fields_match_casetag( in, i, ctag ) );
+		asis   = ( fields_match_casetag( in, i, atag ) );
 		if ( person || corp || asis ) {
 			// if ( npeople>0 ) {
 			// 	if ( format_opts & BIBL_FORMAT_BIBOUT_WHITESPACE )
@@ -18,9 +18,6 @@
 
 #include "common_bt_btd_blt.h"
 
-extern slist find;
-extern slist replace;
-
 /* process_ref()
  *
  */
@@ -72,6 +69,7 @@ bibtexin_processf( fields *bibin, const char *data, const char *filename, long n
 	currloc.progname = pm->progname;
 	currloc.filename = filename;
 	currloc.nref     = nref;
+	currloc.ctx      = pm->ctx;
 
 	if ( !strncasecmp( data, "@STRING", 7 ) ) {
 		process_string( data+7, &currloc );
@@ -206,7 +204,7 @@ bibtex_person_tokenize( fields *bibin, int m, param *pm, slist *tokens )
     // !!!
     // REprintf("\ns before str_convert: %s\n", s->data);
     // ok = str_convert( s, pm->charsetin,  1, pm->utf8in,  pm->xmlin,
-    ok = str_convert( s, pm->charsetin,  pm->latexin, pm->utf8in,  pm->xmlin,
+    ok = str_convert( s, pm->charsetin,  bibl_latexin( pm ), pm->utf8in,  pm->xmlin,
 		      // Georgi: change arg. latexout to 1
 		      // TODO: make it argument to this function?
 		      //       it should depend on --no-latex
@@ -11,71 +11,63 @@
  *
  */
 #include <ctype.h>
+#include <string.h>
 #include "slist.h"
 #include "is_ws.h"
 
 #include "common_bt_btd_blt.h"
 
-slist find    = { 0, 0, 0, NULL };
-slist replace = { 0, 0, 0, NULL };
-
 static char *dummy_id = "dummyid";
 
 /*****************************************************
  PUBLIC: int bibtexdirectin_readf()
 *****************************************************/
 
-/*
- * readf can "read too far", so we store this information in line, thus
- * the next new text is in line, either from having read too far or
- * from the next chunk obtained via str_fget()
- *
- * return 1 on success, 0 on error/end-of-file
- *
- */
-static int
-readmore( FILE *fp, char *buf, int bufsize, int *bufpos, str *line )
-{
-	if ( line->len ) return 1;
-	else return str_fget( fp, buf, bufsize, bufpos, line );
-}
-
 /*
  * readf()
  *
  * returns zero if cannot get reference and hit end of-file
  * returns 1 if last reference in file, 2 if reference within file
+ *
+ * Georgi: the lines are taken from the reader as spans, without copying
+ *         them. readf can "read too far" (the line starting the next
+ *         reference), this line is pushed back with freader_unread().
+ *         The lines of the reference are added with freader_addline(),
+ *         which copies runs of lines in one go if the file is mapped.
+ *
+ *         'line' is not used (it kept the line read too far).
  */
 int
-bibtexin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset )
+bibtexin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm )
 {
 	int haveref = 0;
-	const char *p;
+	const char *p, *q;
+	unsigned long n;
 	*fcharset = CHARSET_UNKNOWN;
-	while ( haveref!=2 && readmore( fp, buf, bufsize, bufpos, line ) ) {
-		if ( line->len == 0 ) continue; /* blank line */
-		p = &(line->data[0]);
+	while ( haveref!=2 && freader_nextline( fr, &p, &n, NULL ) ) {
+		if ( n == 0 ) continue; /* blank line */
+		/* as for a C string, the line ends at a NUL character */
+		q = memchr( p, '\0', n );
+		if ( q ) n = q - p;
 		/* Recognize UTF8 BOM */
-		if ( line->len > 2 && 
+		if ( n > 2 &&
 				(unsigned char)(p[0])==0xEF &&
 				(unsigned char)(p[1])==0xBB &&
 				(unsigned char)(p[2])==0xBF ) {
 			*fcharset = CHARSET_UNICODE;
 			p += 3;
+			n -= 3;
 		}
-		p = skip_ws( p );
-		if ( *p == '%' ) { /* commented out line */
-			str_empty( line );
-			continue;
+		while ( n && is_ws( *p ) ) {
+			p++;
+			n--;
 		}
-		if ( *p == '@' ) haveref++;
-		if ( haveref && haveref<2 ) {
-			str_strcatc( reference, p );
-			str_addchar( reference, '\n' );
-			str_empty( line );
-		} else if ( !haveref ) str_empty( line );
-	
+		if ( n && *p == '%' ) continue; /* commented out line */
+		if ( n && *p == '@' ) haveref++;
+		if ( haveref==1 ) freader_addline( fr, reference, p, n );
+		else if ( haveref==2 ) freader_unread( fr, 0 );
 	}
+	freader_flush( fr );
 	return haveref;
 }
 
@@ -284,10 +276,10 @@ bibtex_data( const char *p, slist *tokens, loc *currloc )
 		p++;
 	}
 out:
-	if ( nbraces!=0 ) {
+	if ( nbraces!=0 && !currloc->ctx->quiet ) {
 	  REprintf( "%s: Mismatch in number of braces in file %s in reference %ld.\n", currloc->progname, currloc->filename, currloc->nref );
 	}
-	if ( nquotes!=0 ) {
+	if ( nquotes!=0 && !currloc->ctx->quiet ) {
 	  REprintf( "%s: Mismatch in number of quotes in file %s in reference %ld.\n", currloc->progname, currloc->filename, currloc->nref );
 	}
 	if ( str_has_value( &token ) ) {
@@ -334,7 +326,7 @@ static char *months_names[12] = {
  * do bibtex string replacement for data tokens
  */
 static int
-replace_strings( slist *tokens )
+replace_strings( slist *tokens, bibl_context *ctx )
 {
   int i, n,   m1;
 	str *s;
@@ -349,8 +341,8 @@ replace_strings( slist *tokens )
 		/* ...skip if token is string concatentation symbol */
 		if ( !str_strcmpc( s, "#" ) ) continue;
 
-		n = slist_find( &find, s );
-		if ( slist_wasnotfound( &find, n ) ) {
+		n = slist_find( &(ctx->find), s );
+		if ( slist_wasnotfound( &(ctx->find), n ) ) {
 		  // 2025-11-02 Georgi - warn about undefined bibtex @string's assume that a
 		  //   bibtex name defined by @string cannot start with a digit.  This is to
 		  //   avoid false alarm for things like year = 2025 or number = 3, since
@@ -366,7 +358,7 @@ replace_strings( slist *tokens )
 		  continue;
 		}
 
-		str_strcpy( s, slist_str( &replace, n ) );
+		str_strcpy( s, slist_str( &(ctx->replace), n ) );
 		if ( str_memerr( s ) ) return BIBL_ERR_MEMERR;
 
 	}
@@ -389,8 +381,9 @@ string_concatenate( slist *tokens, loc *currloc )
 		}
 
 		if ( i==0 || i==tokens->n-1 ) {
-			REprintf( "%s: Warning: Stray string concatenation ('#' character) in file %s reference %ld\n",
-					currloc->progname, currloc->filename, currloc->nref );
+			if ( !currloc->ctx->quiet )
+				REprintf( "%s: Warning: Stray string concatenation ('#' character) in file %s reference %ld\n",
+						currloc->progname, currloc->filename, currloc->nref );
 			status = slist_remove( tokens, i );
 			if ( status!=SLIST_OK ) return BIBL_ERR_MEMERR;
 			continue;
@@ -456,7 +449,7 @@ process_bibtexline( const char *p, str *tag, str *data, uchar stripquotes, loc *
 	}
 
 	if ( p ) {
-		status = replace_strings( &tokens );
+		status = replace_strings( &tokens, currloc->ctx );
 		if ( status!=BIBL_OK ) p = NULL;
 	}
 
@@ -520,6 +513,7 @@ int
 process_string( const char *p, loc *currloc )
 {
 	int n, status = BIBL_OK;
+	slist *find, *replace;
 	str s1, s2, *t;
 	strs_init( &s1, &s2, NULL );
 	while ( *p && *p!='{' && *p!='(' ) p++;
@@ -535,15 +529,17 @@ process_string( const char *p, loc *currloc )
 		str_strcpyc( &s2, "" );
 	}
 	if ( str_has_value( &s1 ) ) {
-		n = slist_find( &find, &s1 );
+		find    = &(currloc->ctx->find);
+		replace = &(currloc->ctx->replace);
+		n = slist_find( find, &s1 );
 		if ( n==-1 ) {
-			status = slist_add_ret( &find, &s1, BIBL_OK, BIBL_ERR_MEMERR );
+			status = slist_add_ret( find, &s1, BIBL_OK, BIBL_ERR_MEMERR );
 			if ( status!=BIBL_OK ) goto out;
-			status = slist_add_ret( &replace, &s2, BIBL_OK, BIBL_ERR_MEMERR );
+			status = slist_add_ret( replace, &s2, BIBL_OK, BIBL_ERR_MEMERR );
 			if ( status!=BIBL_OK ) goto out;
 		} else {
-			if ( str_has_value( &s2 ) ) t = slist_set( &replace, n, &s2 );
-			else t = slist_setc( &replace, n, "" );
+			if ( str_has_value( &s2 ) ) t = slist_set( replace, n, &s2 );
+			else t = slist_setc( replace, n, "" );
 			if ( t==NULL ) { status = BIBL_ERR_MEMERR; goto out; }
 		}
 	}
@@ -600,6 +596,10 @@ bibtexin_crossref( bibl *bin, param *p )
 	fields *bibref, *bibcross;
 	long i;
 
+	/* Georgi: the cleanf may have changed the citekeys since bibl_addref() */
+	status = bibl_reindex( bin );
+	if ( status!=BIBL_OK ) return status;
+
 	for ( i=0; i<bin->n; ++i ) {
 		bibref = bin->ref[i];
 		n = fields_find( bibref, "CROSSREF", LEVEL_ANY );
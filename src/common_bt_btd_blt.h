@@ -24,6 +24,7 @@ typedef struct loc {
 	const char *progname;
 	const char *filename;
 	long nref;
+	bibl_context *ctx; /* Georgi: for the @STRING macros (find/replace) */
 } loc;
 
 #define KEEP_QUOTES  (0)
@@ -34,7 +35,7 @@ typedef struct loc {
 #define ESCAPED_BRACES (2)
 
 
-int bibtexin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset );
+int bibtexin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm );
 
 const char *process_bibtexid( const char *p, str *id );
 
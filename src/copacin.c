@@ -29,7 +29,7 @@ extern int copac_nall;
  PUBLIC: void copacin_initparams()
 *****************************************************/
 
-static int copacin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset );
+static int copacin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm );
 static int copacin_processf( fields *bibin, const char *p, const char *filename, long nref, param *pm );
 static int copacin_convertf( fields *bibin, fields *info, int reftype, param *pm );
 
@@ -89,19 +89,19 @@ copacin_istag( const char *buf )
 	return 1; 
 }
 static int
-readmore( FILE *fp, char *buf, int bufsize, int *bufpos, str *line )
+readmore( freader *fr, str *line )
 {
 	if ( line->len ) return 1;
-	else return str_fget( fp, buf, bufsize, bufpos, line );
+	else return freader_getline( fr, line );
 }
 
 static int
-copacin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset )
+copacin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm )
 {
 	int haveref = 0, inref=0;
 	char *p;
 	*fcharset = CHARSET_UNKNOWN;
-	while ( !haveref && readmore( fp, buf, bufsize, bufpos, line ) ) {
+	while ( !haveref && readmore( fr, line ) ) {
 		/* blank line separates */
 		if ( line->data==NULL ) continue;
 		if ( inref && line->len==0 ) haveref=1; 
@@ -16,9 +16,10 @@
 #include "marc_auth.h"
 #include "xml.h"
 #include "xml_encoding.h"
+#include "xml_split.h"
 #include "bibformats.h"
 
-static int ebiin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset );
+static int ebiin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm );
 static int ebiin_processf( fields *ebiin, const char *data, const char *filename, long nref, param *p );
 
 
@@ -63,36 +64,13 @@ ebiin_initparams( param *pm, const char *progname )
 /*****************************************************
  PUBLIC: int ebiin_readf()
 *****************************************************/
+static char *ebiin_tags[] = { "Publication" };
+
 static int
-ebiin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset )
+ebiin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm )
 {
-	int haveref = 0, inref = 0, file_charset = CHARSET_UNKNOWN, m;
-	char *startptr = NULL, *endptr;
-	str tmp;
-	str_init( &tmp );
-	while ( !haveref && str_fget( fp, buf, bufsize, bufpos, line ) ) {
-		if ( line->data ) {
-			m = xml_getencoding( line );
-			if ( m!=CHARSET_UNKNOWN ) file_charset = m;
-		}
-		if ( str_has_value( line ) )
-			startptr = xml_find_start( str_cstr( line ), "Publication" );
-		if ( startptr || inref ) {
-			if ( inref ) str_strcat( &tmp, line );
-			else {
-				str_strcatc( &tmp, startptr );
-				inref = 1;
-			}
-			endptr = xml_find_end( str_cstr( &tmp ), "Publication" );
-			if ( endptr ) {
-				str_segcpy( reference, str_cstr( &tmp ), endptr );
-				haveref = 1;
-			}
-		}
-	}
-	str_free( &tmp );
-	*fcharset = file_charset;
-	return haveref;
+	int ntag;
+	return xml_split_record( fr, ebiin_tags, 1, XML_SPLIT_JOINLINES, reference, &ntag, fcharset );
 }
 
 /*****************************************************
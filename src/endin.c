@@ -27,7 +27,7 @@ extern int end_nall;
  PUBLIC: void endin_initparams()
 *****************************************************/
 
-static int endin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset );
+static int endin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm );
 static int endin_processf( fields *endin, const char *p, const char *filename, long nref, param *pm );
 int endin_typef( fields *endin, const char *filename, int nrefs, param *p );
 int endin_convertf( fields *endin, fields *info, int reftype, param *p );
@@ -90,20 +90,20 @@ endin_istag( const char *buf )
 }
 
 static int
-readmore( FILE *fp, char *buf, int bufsize, int *bufpos, str *line )
+readmore( freader *fr, str *line )
 {
 	if ( line->len ) return 1;
-	else return str_fget( fp, buf, bufsize, bufpos, line );
+	else return freader_getline( fr, line );
 }
 
 static int
-endin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset )
+endin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm )
 {
 	int haveref = 0, inref = 0;
 	unsigned char *up;
 	char *p;
 	*fcharset = CHARSET_UNKNOWN;
-	while ( !haveref && readmore( fp, buf, bufsize, bufpos, line ) ) {
+	while ( !haveref && readmore( fr, line ) ) {
 
 		if ( !line->data ) continue;
 		p = &(line->data[0]);
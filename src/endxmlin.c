@@ -14,6 +14,7 @@
 #include "name.h"
 #include "xml.h"
 #include "xml_encoding.h"
+#include "xml_split.h"
 #include "reftypes.h"
 #include "bibformats.h"
 
@@ -25,7 +26,7 @@ typedef struct {
 extern variants end_all[];
 extern int end_nall;
 
-static int endxmlin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset );
+static int endxmlin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm );
 static int endxmlin_processf( fields *endin, const char *p, const char *filename, long nref, param *pm );
 extern int endin_typef( fields *endin, const char *filename, int nrefs, param *p );
 extern int endin_convertf( fields *endin, fields *info, int reftype, param *p );
@@ -73,73 +74,13 @@ endxmlin_initparams( param *pm, const char *progname )
  PUBLIC: int endxmlin_readf()
 *****************************************************/
 
-static int
-xml_readmore( FILE *fp, char *buf, int bufsize, int *bufpos )
-{
-	if ( !feof( fp ) && fgets( buf, bufsize, fp ) ) return 0;
-	return 1;
-}
+static char *endxmlin_tags[] = { "RECORD" };
 
 static int
-endxmlin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset )
+endxmlin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm )
 {
-	int haveref = 0, inref = 0, done = 0, file_charset = CHARSET_UNKNOWN, m;
-	char *startptr = NULL, *endptr = NULL;
-	str tmp;
-
-	str_init( &tmp );
-
-	while ( !haveref && !done ) {
-
-		if ( str_is_empty( line ) ) {
-			done = xml_readmore( fp, buf, bufsize, bufpos );
-			str_strcatc( line, buf );
-		}
-
-		if ( !inref ) {
-			startptr = xml_find_start( str_cstr( line ), "RECORD" );
-			if ( startptr ) inref = 1;
-		}
-		else {
-			endptr = xml_find_end( str_cstr( line ), "RECORD" );
-		}
-
-		/* If no <record> tag, we can trim up to last 8 bytes */
-		/* Emptying string can lose fragments of <record> tag */
-		if ( !startptr ) {
-			if ( line->len > 8 ) {
-				int n = 8;
-				char *p = &(line->data[line->len-1]);
-				while ( *p && n ) { p--; n--; }
-				str_segdel( line, line->data, p );
-			}
-		}
-
-		/* ...entire reference is not in line, read more */
-		if ( !startptr || !endptr ) {
-			done = xml_readmore( fp, buf, bufsize, bufpos );
-			str_strcatc( line, buf );
-		}
-		/* ...we can reallocate in str_strcat; must re-find the tags */
-		else {
-			startptr = xml_find_start( str_cstr( line ), "RECORD" );
-			endptr   = xml_find_end  ( str_cstr( line ), "RECORD" );
-			str_segcpy( reference, startptr, endptr );
-			/* clear out information in line */
-			str_strcpyc( &tmp, endptr );
-			str_strcpy( line, &tmp );
-			haveref = 1;
-		}
-
-		m = xml_getencoding( line );
-		if ( m!=CHARSET_UNKNOWN ) file_charset = m;
-
-	}
-
-	str_free( &tmp );
-	*fcharset = file_charset;
-
-	return haveref;
+	int ntag;
+	return xml_split_record( fr, endxmlin_tags, 1, XML_SPLIT_KEEPEOL, reference, &ntag, fcharset );
 }
 
 /*****************************************************
@@ -10,6 +10,7 @@
 #include <string.h>
 #include <ctype.h>
 #include "entities.h"
+#include "bibthread.h"
 
 /* HTML 4.0 entities */
 
@@ -282,30 +283,144 @@ entities html_entities[] = {
 };
 
 
+/* Georgi: hash tables of the names in html_entities[]
+ *
+ * The names used to be compared with each entry in turn, ignoring case, so
+ * that e.g. "&eacute;" was found as "&Eacute;" (which comes first). Now the
+ * name between '&' and ';' is looked up in entities_exact[] and only if it
+ * is not there in entities_nocase[], keyed on the lower case name. The
+ * slots hold the position in html_entities[] plus 1 (0 if empty), the first
+ * entry wins. Filled on first use, under a critical section since they are
+ * shared by the threads of bibl_parallel() (see bibthread.c).
+ */
+#define ENTITIES_HASHSIZE (1024)   /* power of 2, > 2 * number of entities */
+#define ENTITIES_MAXNAME  (17)     /* html[20] holds '&', the name, ';' and '\0' */
+
+static unsigned short entities_exact[ ENTITIES_HASHSIZE ];
+static unsigned short entities_nocase[ ENTITIES_HASHSIZE ];
+static int entities_built = 0;
+
 static unsigned int
-decode_html_entity( char *s, unsigned int *pi, int *err )
+entities_hash( const char *name, int len, int nocase )
+{
+	unsigned int h = 2166136261U;
+	int i;
+	for ( i=0; i<len; ++i ) {
+		h ^= ( unsigned char ) ( nocase ? tolower( (unsigned char)name[i] ) : name[i] );
+		h *= 16777619U;
+	}
+	return h & ( ENTITIES_HASHSIZE - 1 );
+}
+
+/* does the name of html_entities[n] equal name[0..len-1]? */
+static int
+entities_match( int n, const char *name, int len, int nocase )
+{
+	const char *e = &(html_entities[n].html[1]);
+	if ( nocase ) {
+		if ( strncasecmp( e, name, len ) ) return 0;
+	} else {
+		if ( strncmp( e, name, len ) ) return 0;
+	}
+	return e[len]==';';
+}
+
+static void
+entities_add( unsigned short *table, int n, int nocase )
+{
+	const char *name = &(html_entities[n].html[1]);
+	unsigned int h;
+	int len;
+
+	len = strchr( name, ';' ) - name;
+	h = entities_hash( name, len, nocase );
+	while ( table[h] ) {
+		if ( entities_match( table[h]-1, name, len, nocase ) ) return;
+		h = ( h + 1 ) & ( ENTITIES_HASHSIZE - 1 );
+	}
+	table[h] = n + 1;
+}
+
+static void
+entities_build( void )
 {
 	int nhtml_entities = sizeof( html_entities ) / sizeof( entities );
-	char *e;
-	int i, n=-1, len;
-	for ( i=0; i<nhtml_entities && n==-1; ++i ) {
-		e = &(html_entities[i].html[0]);
-		len = strlen( e );
-		if ( !strncasecmp( &(s[*pi]), e, len ) ) {
-			n = i;
-			*pi += len;
+	int i, built;
+
+	bibl_load_acquire( built, entities_built );
+	if ( built ) return;
+#ifdef _OPENMP
+#pragma omp critical ( entities_build )
+#endif
+	{
+		if ( !entities_built ) {
+			for ( i=0; i<nhtml_entities; ++i ) {
+				entities_add( entities_exact, i, 0 );
+				entities_add( entities_nocase, i, 1 );
+			}
+			bibl_store_release( entities_built, 1 );
 		}
 	}
+}
+
+/* position of the entity in html_entities[], -1 if it is not there */
+static int
+entities_find( const unsigned short *table, const char *name, int len, int nocase )
+{
+	unsigned int h = entities_hash( name, len, nocase );
+	while ( table[h] ) {
+		if ( entities_match( table[h]-1, name, len, nocase ) ) return table[h]-1;
+		h = ( h + 1 ) & ( ENTITIES_HASHSIZE - 1 );
+	}
+	return -1;
+}
+
+static unsigned int
+decode_html_entity( char *s, unsigned int *pi, int *err )
+{
+	char *name = &(s[*pi+1]);
+	int n=-1, len;
+
+	for ( len=0; len<=ENTITIES_MAXNAME && name[len] && name[len]!=';'; ++len )
+		;
+	if ( len>0 && len<=ENTITIES_MAXNAME && name[len]==';' ) {
+		entities_build();
+		n = entities_find( entities_exact, name, len, 0 );
+		if ( n==-1 ) n = entities_find( entities_nocase, name, len, 1 );
+	}
 	if ( n==-1 ) {
 		*err = 1;
 		return '&';
 	} else {
 		*err = 0;
+		*pi += len + 2;
 		return html_entities[n].unicode;
 	}
 }
 
 
+/* value of the hexadecimal digits, XX for other characters */
+#define XX (0xFF)
+static const unsigned char entities_digit[256] = {
+	XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+	XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+	XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, XX, XX, XX, XX, XX, XX,
+	XX, 10, 11, 12, 13, 14, 15, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+	XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+	XX, 10, 11, 12, 13, 14, 15, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+	XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+	XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+	XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+	XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+	XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+	XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+	XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+	XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+	XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+};
+#undef XX
+
 /*
  * decode decimal entity
  *
@@ -317,8 +432,7 @@ decode_decimal_entity( char *s, unsigned int *pi, int *err )
 {
 	unsigned int c = 0, d;
 	int i = *pi, j = 2;
-	while ( isdigit( (unsigned char)s[i+j] ) ) {
-		d = s[i+j] - '0';
+	while ( ( d = entities_digit[ (unsigned char)s[i+j] ] ) < 10 ) {
 		c = 10 * c + d;
 		j++;
 	}
@@ -338,9 +452,7 @@ decode_hex_entity( char *s, unsigned int *pi, int *err )
 {
 	unsigned int c = 0, d;
 	int i = *pi, j = 3;
-	while ( isxdigit( (unsigned char)s[i+j] ) ) {
-		if ( isdigit( (unsigned char)s[i+j] ) ) d = s[i+j]-'0';
-		else d = toupper((unsigned char)s[i+j])-'A' + 10;
+	while ( ( d = entities_digit[ (unsigned char)s[i+j] ] ) < 16 ) {
 		c = 16 * c + d;
 		j++;
 	}
@@ -10,19 +10,27 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <ctype.h>
 #include "fields.h"
+#include "tagatom.h"
 
 #define FIELDS_MIN_ALLOC (20)
 
+/* Georgi: fields with at least this many entries get a hash set for the
+ * duplicate checks of FIELDS_NO_DUPS, see is_duplicate_entry()
+ */
+#define FIELDS_DUPS_MIN  (16)
+
 /* private helper macros to access fields
  *
  * These skip all of the error checking and used flag manipulation
  * of the fields functions, so they are faster. However, they should
  * only be used in internal code that knows that the index is valid.
  */
-#define _fields_tag(f,i)            &((f)->tag[(i)])
-#define _fields_tag_char(f,i)       str_cstr( &((f)->tag[(i)]) )
-#define _fields_tag_notempty(f,i)   str_has_value( &((f)->tag[(i)]) )
+#define _fields_tag(f,i)            tagatom_str( (f)->tag[(i)] )
+#define _fields_tag_char(f,i)       str_cstr( tagatom_str( (f)->tag[(i)] ) )
+#define _fields_tag_notempty(f,i)   str_has_value( tagatom_str( (f)->tag[(i)] ) )
+#define _fields_tag_case(f,i)       tagatom_case( (f)->tag[(i)] )
 #define _fields_value(f,i)          &((f)->value[(i)])
 #define _fields_value_char(f,i)     str_cstr( &((f)->value[(i)]) )
 #define _fields_value_notempty(f,i) str_has_value( &((f)->value[(i)]) )
@@ -39,9 +47,11 @@ fields_new( void )
 void
 fields_init( fields *f )
 {
-	f->used  = f->level = NULL;
-	f->tag   = f->value = NULL;
+	f->used  = f->level = f->tag = NULL;
+	f->value = NULL;
 	f->max   = f->n     = 0;
+	f->dups  = NULL;
+	f->ndups = 0;
 }
 
 void
@@ -49,14 +59,13 @@ fields_free( fields *f )
 {
 	int i;
 
-	for ( i=0; i<f->max; ++i ) {
-		str_free( _fields_tag( f, i ) );
+	for ( i=0; i<f->max; ++i )
 		str_free( _fields_value( f, i ) );
-	}
 	if ( f->tag )   free( f->tag );
 	if ( f->value ) free( f->value );
 	if ( f->used )  free( f->used );
 	if ( f->level ) free( f->level );
+	if ( f->dups )  free( f->dups );
 
 	fields_init( f );
 }
@@ -68,13 +77,79 @@ fields_delete( fields *f )
 	free( f );
 }
 
+/* Georgi: the hash set of the entries used by is_duplicate_entry()
+ *
+ * Open addressing with linear probing; a slot holds the index of an
+ * entry plus one, 0 is empty. The set is built when a FIELDS_NO_DUPS add
+ * finds at least FIELDS_DUPS_MIN entries, kept up to date by the adds and
+ * dropped by everything else that can change an entry (fields_remove(),
+ * fields_replace_or_add(), handing out a str* to a value), to be rebuilt
+ * by the next FIELDS_NO_DUPS add. A hit is always confirmed by comparing
+ * the entry, so the hash only needs to be the same for entries that
+ * compare equal.
+ */
+static unsigned int
+fields_dups_hash( int tagcase, const char *value, int level )
+{
+	unsigned int h = 2166136261u;
+
+	h = ( h ^ (unsigned int) level   ) * 16777619u;
+	h = ( h ^ (unsigned int) tagcase ) * 16777619u;
+	if ( value ) {
+		while ( *value ) {
+			h = ( h ^ (unsigned int) tolower( (unsigned char) *value ) ) * 16777619u;
+			value++;
+		}
+	}
+
+	return h;
+}
+
+static void
+fields_dups_drop( fields *f )
+{
+	if ( f->dups ) free( f->dups );
+	f->dups  = NULL;
+	f->ndups = 0;
+}
+
+static void
+fields_dups_insert( fields *f, int n )
+{
+	unsigned int mask = f->ndups - 1, i;
+
+	i = fields_dups_hash( _fields_tag_case( f, n ), _fields_value_char( f, n ), _fields_level( f, n ) ) & mask;
+	while ( f->dups[i] ) i = ( i + 1 ) & mask;
+	f->dups[i] = n + 1;
+}
+
+/* on failure to allocate there is simply no set and the checks are linear */
+static int
+fields_dups_build( fields *f )
+{
+	int i, size = 64;
+
+	fields_dups_drop( f );
+
+	while ( size < 2 * ( f->n + 1 ) ) size *= 2;
+	f->dups = ( int * ) calloc( size, sizeof( int ) );
+	if ( !f->dups ) return 0;
+	f->ndups = size;
+
+	for ( i=0; i<f->n; ++i )
+		fields_dups_insert( f, i );
+
+	return 1;
+}
+
 int
 fields_remove( fields *f, int n )
 {
 	int i;
 	if ( n<0 || n>= f->n ) return FIELDS_ERR_MEMERR;
+	fields_dups_drop( f );
 	for ( i=n+1; i<f->n; ++i ) {
-		str_strcpy( _fields_tag  ( f, i-1 ), _fields_tag  ( f, i ) );
+		f->tag[i-1] = f->tag[i];
 		str_strcpy( _fields_value( f, i-1 ), _fields_value( f, i ) );
 		f->used[i-1]  = f->used[i];
 		f->level[i-1] = f->level[i];
@@ -87,16 +162,14 @@ static void
 initialize_new_tag_data_pairs( fields *f, int start, int end )
 {
 	int i;
-	for ( i=start; i<end; ++i ) {
-		str_init( _fields_tag( f, i ) );
+	for ( i=start; i<end; ++i )
 		str_init( _fields_value( f, i ) );
-	}
 }
 
 static int
 fields_alloc( fields *f, int alloc )
 {
-	f->tag   = (str *) malloc( sizeof(str) * alloc );
+	f->tag   = (int *) malloc( sizeof(int) * alloc );
 	f->value = (str *) malloc( sizeof(str) * alloc );
 	f->used  = (int *) calloc( alloc, sizeof(int) );
 	f->level = (int *) calloc( alloc, sizeof(int) );
@@ -120,14 +193,14 @@ fields_alloc( fields *f, int alloc )
 static int
 fields_realloc( fields *f )
 {
-	int *newused, *newlevel;
-	str *newtags, *newvalue;
-	int alloc;
+	int *newtags, *newused, *newlevel;
+	str *newvalue;
+	int i, alloc;
 
 	alloc = f->max * 2;
 	if ( alloc < f->max ) return FIELDS_ERR_MEMERR; /* integer overflow */
 
-	newtags  = (str*) realloc( f->tag,   sizeof(str) * alloc );
+	newtags  = (int*) realloc( f->tag,   sizeof(int) * alloc );
 	newvalue = (str*) realloc( f->value, sizeof(str) * alloc );
 	newused  = (int*) realloc( f->used,  sizeof(int) * alloc );
 	newlevel = (int*) realloc( f->level, sizeof(int) * alloc );
@@ -137,7 +210,11 @@ fields_realloc( fields *f )
 	 * reallocation prior to failing on memory error
 	 */
 	if ( newtags )  f->tag   = newtags;
-	if ( newvalue ) f->value = newvalue;
+	if ( newvalue ) {
+		f->value = newvalue;
+		for ( i=0; i<f->max; ++i )
+			str_relocate( _fields_value( f, i ) );
+	}
 	if ( newused )  f->used  = newused;
 	if ( newlevel ) f->level = newlevel;
 
@@ -161,13 +238,28 @@ ensure_space( fields *f )
 }
 
 static int
-is_duplicate_entry( fields *f, const char *tag, const char *value, int level )
+is_duplicate_entry( fields *f, int tagcase, const char *value, int level )
 {
+	unsigned int mask, j;
 	int i;
 
+	if ( f->n >= FIELDS_DUPS_MIN && ( f->dups || fields_dups_build( f ) ) ) {
+		mask = f->ndups - 1;
+		j = fields_dups_hash( tagcase, value, level ) & mask;
+		while ( f->dups[j] ) {
+			i = f->dups[j] - 1;
+			j = ( j + 1 ) & mask;
+			if ( _fields_level( f, i ) != level ) continue;
+			if ( _fields_tag_case( f, i ) != tagcase ) continue;
+			if ( strcasecmp( _fields_value_char( f, i ), value ) ) continue;
+			return 1;
+		}
+		return 0;
+	}
+
 	for ( i=0; i<f->n; i++ ) {
 		if ( _fields_level( f, i ) != level ) continue;
-		if ( strcasecmp( _fields_tag_char( f, i ),   tag   ) ) continue;
+		if ( _fields_tag_case( f, i ) != tagcase ) continue;
 		if ( strcasecmp( _fields_value_char( f, i ), value ) ) continue;
 		return 1;
 	}
@@ -175,16 +267,14 @@ is_duplicate_entry( fields *f, const char *tag, const char *value, int level )
 	return 0;
 }
 
-int
-_fields_add( fields *f, const char *tag, const char *value, int level, int mode )
+/* add an entry with an interned tag, see tagatom.c */
+static int
+fields_add_atom( fields *f, int atom, const char *value, int level, int mode )
 {
 	int n, status;
 
-	/* Don't add incomplete entry */
-	if ( !tag || !value ) return FIELDS_OK;
-
 	/* Don't add duplicate entry if FIELDS_NO_DUPS */
-	if ( mode == FIELDS_NO_DUPS && is_duplicate_entry( f, tag, value, level ) )
+	if ( mode == FIELDS_NO_DUPS && is_duplicate_entry( f, tagatom_case( atom ), value, level ) )
 		return FIELDS_OK;
 
 	status = ensure_space( f );
@@ -193,17 +283,49 @@ _fields_add( fields *f, const char *tag, const char *value, int level, int mode
 	n = f->n;
 	f->used[ n ]  = 0;
 	f->level[ n ] = level;
-	str_strcpyc( _fields_tag( f, n ),   tag   );
+	f->tag[ n ]   = atom;
 	str_strcpyc( _fields_value( f, n ), value );
 
-	if ( str_memerr( &(f->tag[n]) ) || str_memerr( &(f->value[n] ) ) )
+	if ( str_memerr( &(f->value[n] ) ) )
 		return FIELDS_ERR_MEMERR;
 
 	f->n++;
 
+	if ( f->dups ) {
+		if ( 2 * f->n > f->ndups ) fields_dups_build( f );
+		else fields_dups_insert( f, n );
+	}
+
 	return FIELDS_OK;
 }
 
+int
+_fields_add( fields *f, const char *tag, const char *value, int level, int mode )
+{
+	int atom;
+
+	/* Don't add incomplete entry */
+	if ( !tag || !value ) return FIELDS_OK;
+
+	atom = tagatom_intern( tag );
+	if ( atom < 0 ) return FIELDS_ERR_MEMERR;
+
+	/* Georgi: a short value of f itself is in the small buffer of its str
+	 * (see str.h), which moves if the arrays of f are reallocated
+	 */
+	if ( f->value && (const char *) value >= (const char *) f->value &&
+	     (const char *) value <  (const char *) ( f->value + f->max ) ) {
+		str tmp;
+		int status;
+		str_initstrc( &tmp, value );
+		status = fields_add_atom( f, atom, str_cstr( &tmp ), level, mode );
+		str_free( &tmp );
+		return status;
+	}
+
+	return fields_add_atom( f, atom, value, level, mode );
+}
+
 int
 _fields_add_suffix( fields *f, const char *tag, const char *suffix, const char *value, int level, int mode )
 {
@@ -256,7 +378,7 @@ fields_dupl( fields *in )
 		value = _fields_value_char( in, i );
 		level = _fields_level( in, i );
 		if ( tag && value ) {
-			status = fields_add_can_dup( out, tag, value, level );
+			status = fields_add_atom( out, in->tag[i], value, level, FIELDS_CAN_DUP );
 			if ( status!=FIELDS_OK ) {
 				fields_delete( out );
 				return NULL;
@@ -289,17 +411,27 @@ fields_match_level( fields *f, int n, int level )
 int
 fields_match_tag( fields *f, int n, const char *tag )
 {
-	if ( !strcmp( _fields_tag_char( f, n ), tag ) ) return 1;
+	if ( f->tag[n] == tagatom_find( tag ) ) return 1;
 	return 0;
 }
 
 int
 fields_match_casetag( fields *f, int n, const char *tag )
 {
-	if ( !strcasecmp( _fields_tag_char( f, n ), tag ) ) return 1;
+	if ( _fields_tag_case( f, n ) == tagatom_findcase( tag ) ) return 1;
 	return 0;
 }
 
+/* the matching functions below with the case id of the tag (see tagatom.c)
+ * computed once by the caller
+ */
+static int
+fields_match_case_level( fields *f, int n, int tagcase, int level )
+{
+	if ( level!=LEVEL_ANY && _fields_level( f, n )!=level ) return 0;
+	return ( _fields_tag_case( f, n ) == tagcase );
+}
+
 int
 fields_match_tag_level( fields *f, int n, const char *tag, int level )
 {
@@ -322,10 +454,13 @@ fields_match_casetag_level( fields *f, int n, const char *tag, int level )
 int
 fields_find( fields *f, const char *tag, int level )
 {
-	int i;
+	int i, tagcase;
+
+	tagcase = tagatom_findcase( tag );
+	if ( tagcase==TAGATOM_NOTFOUND ) return FIELDS_NOTFOUND;
 
 	for ( i=0; i<f->n; ++i ) {
-		if ( !fields_match_casetag_level( f, i, tag, level ) )
+		if ( !fields_match_case_level( f, i, tagcase, level ) )
 			continue;
 		if ( str_has_value( _fields_value( f, i ) ) ) return i;
 		else {
@@ -384,6 +519,7 @@ fields_replace_or_add( fields *f, const char *tag, const char *value, int level
 		return fields_add( f, tag, value, level );
 	}
 	else {
+		fields_dups_drop( f );
 		str_strcpyc( _fields_value( f, n ), value );
 		if ( str_memerr( _fields_value( f, n ) ) ) return FIELDS_ERR_MEMERR;
 		return FIELDS_OK;
@@ -454,6 +590,7 @@ fields_value( fields *f, int n, int mode )
 		fields_set_used( f, n );
 
 	if ( mode & FIELDS_STRP_FLAG ) {
+		fields_dups_drop( f ); /* the value may be changed */
 		return ( void * ) _fields_value( f, n );
 	}
 	else if ( mode & FIELDS_POSP_FLAG ) {
@@ -500,12 +637,14 @@ fields_level( fields *f, int n )
 void *
 fields_findv( fields *f, int level, int mode, const char *tag )
 {
-	int i, found = FIELDS_NOTFOUND;
+	int i, tagcase, found = FIELDS_NOTFOUND;
+
+	tagcase = tagatom_findcase( tag );
+	if ( tagcase==TAGATOM_NOTFOUND ) return NULL;
 
 	for ( i=0; i<f->n; ++i ) {
 
-		if ( !fields_match_level( f, i, level ) ) continue;
-		if ( !fields_match_casetag( f, i, tag ) ) continue;
+		if ( !fields_match_case_level( f, i, tagcase, level ) ) continue;
 
 		if ( _fields_value_notempty( f, i ) ) {
 			found = i;
@@ -560,12 +699,14 @@ fields_findv_each_add( fields *f, int mode, int n, vplist *a )
 int
 fields_findv_each( fields *f, int level, int mode, vplist *a, const char *tag )
 {
-	int i, status;
+	int i, tagcase, status;
+
+	tagcase = tagatom_findcase( tag );
+	if ( tagcase==TAGATOM_NOTFOUND ) return FIELDS_OK;
 
 	for ( i=0; i<f->n; ++i ) {
 
-		if ( !fields_match_level( f, i, level ) ) continue;
-		if ( !fields_match_casetag( f, i, tag ) ) continue;
+		if ( !fields_match_case_level( f, i, tagcase, level ) ) continue;
 
 		if ( _fields_value_notempty( f, i ) ) {
 			status = fields_findv_each_add( f, mode, i, a );
@@ -584,27 +725,34 @@ fields_findv_each( fields *f, int level, int mode, vplist *a, const char *tag )
 	return FIELDS_OK;
 }
 
+#define FIELDS_MAX_EACHOF (32)
+
+/* the case ids of the tags; the ones not interned (see tagatom.c) can't
+ * match anything and are skipped
+ */
 static int
-fields_build_tags( va_list argp, vplist *tags )
+fields_build_tags( va_list argp, int *tags, int *ntags )
 {
-	int status;
+	int tagcase;
 	char *tag;
 
+	*ntags = 0;
 	while ( ( tag = ( char * ) va_arg( argp, char * ) ) ) {
-		status = vplist_add( tags, tag );
-		if ( status!=VPLIST_OK ) return FIELDS_ERR_MEMERR;
+		if ( *ntags==FIELDS_MAX_EACHOF ) return FIELDS_ERR_MEMERR;
+		tagcase = tagatom_findcase( tag );
+		if ( tagcase!=TAGATOM_NOTFOUND ) tags[ (*ntags)++ ] = tagcase;
 	}
 
 	return FIELDS_OK;
 }
 
 static int
-fields_match_casetags( fields *f, int n, vplist *tags )
+fields_match_casetags( fields *f, int n, int *tags, int ntags )
 {
-	int i;
+	int i, tagcase = _fields_tag_case( f, n );
 
-	for ( i=0; i<tags->n; ++i )
-		if ( fields_match_casetag( f, n, vplist_get( tags, i ) ) ) return 1;
+	for ( i=0; i<ntags; ++i )
+		if ( tagcase == tags[i] ) return 1;
 
 	return 0;
 }
@@ -612,15 +760,12 @@ fields_match_casetags( fields *f, int n, vplist *tags )
 int
 fields_findv_eachof( fields *f, int level, int mode, vplist *a, ... )
 {
-	int i, status;
+	int i, status, tags[ FIELDS_MAX_EACHOF ], ntags;
 	va_list argp;
-	vplist tags;
-
-	vplist_init( &tags );
 
 	/* build list of tags to search for */
 	va_start( argp, a );
-	status = fields_build_tags( argp, &tags );
+	status = fields_build_tags( argp, tags, &ntags );
 	va_end( argp );
 	if ( status!=FIELDS_OK ) goto out;
 
@@ -628,7 +773,7 @@ fields_findv_eachof( fields *f, int level, int mode, vplist *a, ... )
 	for ( i=0; i<f->n; ++i ) {
 
 		if ( !fields_match_level( f, i, level ) ) continue;
-		if ( !fields_match_casetags( f, i, &tags ) ) continue;
+		if ( !fields_match_casetags( f, i, tags, ntags ) ) continue;
 
 		if ( _fields_value_notempty( f, i ) || ( mode & FIELDS_NOLENOK_FLAG ) ) {
 			status = fields_findv_each_add( f, mode, i, a );
@@ -640,7 +785,6 @@ fields_findv_eachof( fields *f, int level, int mode, vplist *a, ... )
 	}
 
 out:
-	vplist_free( &tags );
 	return status;
 }
 
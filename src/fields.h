@@ -24,18 +24,21 @@
 
 
 #include <R.h>
+#include "bibthread.h"
 
 
 #include "str.h"
 #include "vplist.h"
 
 typedef struct fields {
-	str       *tag;
+	int       *tag;      /* Georgi: interned, see tagatom.c and fields_tag() */
 	str       *value;
 	int       *used;
 	int       *level;
 	int       n;
 	int       max;
+	int       *dups;     /* Georgi: hash set for FIELDS_NO_DUPS, see fields.c */
+	int       ndups;
 } fields;
 
 void    fields_init( fields *f );
@@ -0,0 +1,298 @@
+/*
+ * freader.c
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * Source code released under the GPL version 2
+ *
+ * Implements a block-buffered line reader. The file is read with fread() in
+ * blocks of FREADER_BUFSIZE bytes and lines are found with memchr(), so the
+ * callers get each line as a span of the buffer (freader_nextline()) or
+ * copied into a str in one go (freader_getline()). A line longer than the
+ * buffer makes the buffer grow, so a line is always contiguous.
+ *
+ * On request (option "--mmap", see bibcore.c) a regular file is mapped into
+ * memory instead (where mmap() is available), see freader_map(). Then
+ * nothing is copied to read it and the spans stay valid until
+ * freader_free(), which freader_addline() uses to copy runs of adjacent
+ * lines in one go. Pipes, terminals, etc. are always read with fread().
+ *
+ * Lines end with "\n", "\r\n" or "\r", as for str_fget().
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "freader.h"
+
+#if !defined( _WIN32 )
+#define FREADER_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+#define FREADER_BUFSIZE (1048576)
+
+/* freader_map()
+ *
+ * map the file into memory if it is a regular, non-empty file not read
+ * from yet; returns 1 on success, else 0 and the file is read with fread()
+ *
+ * Not the default: if the file is truncated by another process while it is
+ * mapped, touching the pages past the new end raises SIGBUS, which would
+ * take down the R session. No check made here can prevent that, since the
+ * size is only known at the time of fstat(). fread() simply sees an
+ * earlier end of file.
+ */
+int
+freader_map( freader *fr )
+{
+#ifdef FREADER_MMAP
+	struct stat st;
+	void *p;
+
+	if ( !fr->fp ) return 0;
+	if ( ftell( fr->fp )!=0 ) return 0;
+	if ( fstat( fileno( fr->fp ), &st )!=0 ) return 0;
+	if ( !S_ISREG( st.st_mode ) || st.st_size<=0 ) return 0;
+	if ( (unsigned long long) st.st_size > (unsigned long long) (size_t) -1 ) return 0;
+
+	p = mmap( NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fileno( fr->fp ), 0 );
+	if ( p==MAP_FAILED ) return 0;
+#ifdef MADV_SEQUENTIAL
+	madvise( p, (size_t) st.st_size, MADV_SEQUENTIAL );
+#endif
+
+	fr->buf    = ( char * ) p;
+	fr->size   = fr->len = (unsigned long) st.st_size;
+	fr->nl     = fr->len;
+	fr->eof    = 1;
+	fr->mapped = 1;
+	p = memchr( fr->buf, '\n', fr->len );
+	if ( p ) fr->nl = (unsigned long) ( ( char * ) p - fr->buf );
+
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+void
+freader_init( freader *fr, FILE *fp )
+{
+	fr->fp     = fp;
+	fr->buf    = NULL;
+	fr->size   = 0;
+	fr->len    = 0;
+	fr->pos    = 0;
+	fr->nl     = 0;
+	fr->last   = 0;
+	fr->eof    = 0;
+	fr->mapped = 0;
+	fr->status = FREADER_OK;
+	fr->runs   = NULL;
+	fr->run    = NULL;
+	fr->runlen = 0;
+}
+
+void
+freader_free( freader *fr )
+{
+#ifdef FREADER_MMAP
+	if ( fr->mapped ) munmap( fr->buf, fr->len );
+	else
+#endif
+	if ( fr->buf ) free( fr->buf );
+	freader_init( fr, NULL );
+}
+
+/* freader_fill()
+ *
+ * move the data not handed out yet to the start of the buffer and append
+ * the next block of the file; returns 0 at end of file or on memory error
+ */
+static int
+freader_fill( freader *fr )
+{
+	unsigned long n, shift;
+	char *p;
+
+	if ( fr->eof || fr->status!=FREADER_OK ) return 0;
+
+	if ( fr->pos ) {
+		shift = fr->pos;
+		memmove( fr->buf, fr->buf + shift, fr->len - shift );
+		fr->len -= shift;
+		fr->nl  -= shift;
+		fr->pos  = 0;
+	}
+
+	if ( fr->len==fr->size ) {
+		n = ( fr->size ) ? fr->size * 2 : FREADER_BUFSIZE;
+		p = ( char * ) realloc( fr->buf, n );
+		if ( !p ) {
+			fr->status = FREADER_MEMERR;
+			return 0;
+		}
+		fr->buf  = p;
+		fr->size = n;
+	}
+
+	n = fread( fr->buf + fr->len, 1, fr->size - fr->len, fr->fp );
+	if ( n==0 ) {
+		fr->eof = 1;
+		return 0;
+	}
+
+	/* no '\n' in the old data, look in the new */
+	if ( fr->nl==fr->len ) {
+		p = memchr( fr->buf + fr->len, '\n', n );
+		fr->nl = ( p ) ? (unsigned long) ( p - fr->buf ) : fr->len + n;
+	}
+	fr->len += n;
+
+	return 1;
+}
+
+/* freader_line()
+ *
+ * find the next line; on success sets *line and *n to the line without its
+ * end and *neol to the length of the end of line (0 for a last line without
+ * one), returns 0 at end of file
+ */
+static int
+freader_line( freader *fr, const char **line, unsigned long *n, unsigned long *neol )
+{
+	unsigned long end;
+	char *p, *cr;
+
+	while ( 1 ) {
+
+		if ( fr->nl < fr->pos ) {
+			p = memchr( fr->buf + fr->pos, '\n', fr->len - fr->pos );
+			fr->nl = ( p ) ? (unsigned long) ( p - fr->buf ) : fr->len;
+		}
+
+		cr = ( fr->nl > fr->pos ) ? memchr( fr->buf + fr->pos, '\r', fr->nl - fr->pos ) : NULL;
+
+		if ( cr ) {
+			end = cr - fr->buf;
+			/* need the next character to see if it is "\r\n" */
+			if ( end + 1 < fr->len ) {
+				*neol = ( fr->buf[end+1]=='\n' ) ? 2 : 1;
+				break;
+			}
+			if ( fr->eof ) {
+				*neol = 1;
+				break;
+			}
+		} else if ( fr->nl < fr->len ) {
+			end   = fr->nl;
+			*neol = 1;
+			break;
+		} else if ( fr->eof ) {
+			if ( fr->pos==fr->len ) return 0;
+			end   = fr->len;
+			*neol = 0;
+			break;
+		}
+
+		if ( !freader_fill( fr ) && fr->status!=FREADER_OK ) return 0;
+	}
+
+	*line = fr->buf + fr->pos;
+	*n    = end - fr->pos;
+	fr->last = fr->pos;
+	fr->pos  = end + *neol;
+
+	return 1;
+}
+
+/* freader_nextline()
+ *
+ * returns 1 and sets *line, *n to the next line (without its end of line),
+ * 0 at end of file; the line is valid until the next call (until
+ * freader_free() if the file is mapped). If neol is not NULL, *neol is set
+ * to the length of the end of line, so the end of line is (*line)[*n, *n + *neol).
+ */
+int
+freader_nextline( freader *fr, const char **line, unsigned long *n, unsigned long *neol )
+{
+	unsigned long m;
+	return freader_line( fr, line, n, ( neol ) ? neol : &m );
+}
+
+/* freader_unread()
+ *
+ * push back the line returned by the last call of freader_nextline() except
+ * its first n characters, the rest of the line will be returned by the next
+ * call
+ */
+void
+freader_unread( freader *fr, unsigned long n )
+{
+	fr->pos = fr->last + n;
+}
+
+/* freader_getline()
+ *
+ * as str_fget(): copies the next line without its end of line to 'line',
+ * returns 0 if there are no more lines
+ */
+int
+freader_getline( freader *fr, str *line )
+{
+	const char *p;
+	unsigned long n;
+
+	str_empty( line );
+	if ( !freader_nextline( fr, &p, &n, NULL ) ) return 0;
+	if ( n ) str_segcpy( line, (char *) p, (char *) p + n );
+	return 1;
+}
+
+/* freader_flush()
+ *
+ * complete the copying delayed by freader_addline()
+ */
+void
+freader_flush( freader *fr )
+{
+	if ( fr->runlen ) str_segcat( fr->runs, (char *) fr->run, (char *) fr->run + fr->runlen );
+	fr->runs   = NULL;
+	fr->run    = NULL;
+	fr->runlen = 0;
+}
+
+/* freader_addline()
+ *
+ * appends p[0..n), a part of a line from freader_nextline(), and '\n' to s.
+ *
+ * If the file is mapped and the part is followed by '\n' in the file, the
+ * copying is delayed while the following calls add the text right after
+ * it, so a run of lines is copied in one go. The caller must call
+ * freader_flush() before using s.
+ */
+void
+freader_addline( freader *fr, str *s, const char *p, unsigned long n )
+{
+	int clean;
+
+	clean = fr->mapped && p + n < fr->buf + fr->len && p[n]=='\n';
+
+	if ( clean && fr->runs==s && p==fr->run + fr->runlen ) {
+		fr->runlen += n + 1;
+		return;
+	}
+
+	freader_flush( fr );
+
+	if ( clean ) {
+		fr->runs   = s;
+		fr->run    = p;
+		fr->runlen = n + 1;
+	} else {
+		if ( n ) str_segcat( s, (char *) p, (char *) p + n );
+		str_addchar( s, '\n' );
+	}
+}
@@ -0,0 +1,46 @@
+/*
+ * freader.h
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * Source code released under the GPL version 2
+ *
+ */
+#ifndef FREADER_H
+#define FREADER_H
+
+#include <stdio.h>
+#include "str.h"
+
+#define FREADER_OK     (0)
+#define FREADER_MEMERR (-1)
+
+/* block-buffered reader of an input file: the file is read in large blocks
+ * (or mapped into memory) and handed out line by line, see freader_nextline()
+ */
+typedef struct freader {
+	FILE *fp;
+	char *buf;
+	unsigned long size; /* allocated size of buf */
+	unsigned long len;  /* number of bytes in buf */
+	unsigned long pos;  /* start of the data not handed out yet */
+	unsigned long nl;   /* position of the first '\n' at or after pos, len if none */
+	unsigned long last; /* start of the last line handed out, see freader_unread() */
+	int eof;
+	int mapped;         /* buf is a mapping of the whole file, see freader_map() */
+	int status;
+	str *runs;          /* pending copy of a run of lines to runs, see freader_addline() */
+	const char *run;
+	unsigned long runlen;
+} freader;
+
+void freader_init      ( freader *fr, FILE *fp );
+int  freader_map       ( freader *fr );
+void freader_free      ( freader *fr );
+int  freader_nextline  ( freader *fr, const char **line, unsigned long *n, unsigned long *neol );
+void freader_unread    ( freader *fr, unsigned long n );
+int  freader_getline   ( freader *fr, str *line );
+void freader_addline   ( freader *fr, str *s, const char *p, unsigned long n );
+void freader_flush     ( freader *fr );
+
+#endif
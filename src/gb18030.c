@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include "gb18030.h"
+#include "bibthread.h"
 
 /* GB18030-2000 is an encoding of Unicode character used in China
  *
@@ -30768,7 +30769,64 @@ genums_t gb18030_enums[] = {
 unsigned int ngb18030_enums = sizeof( gb18030_enums ) / sizeof( gb18030_enums[0] );
 
 
+/* Georgi: indexed lookups
+ *
+ * The tables below are filled from gb18030_enums[] and gb18030_ranges[] on
+ * first use (they used to be searched linearly for every character):
+ *
+ *   gb18030_two[]  -- Unicode of the two-byte character {lead}{trail},
+ *                     indexed by (lead-0x81)*191 + (trail-0x40), 0 if none
+ *   gb18030_four[] -- Unicode of the four-byte characters of the BMP,
+ *                     indexed by their linear number (see gb18030_linear()),
+ *                     0 if none
+ *   gb18030_uni[]  -- GB 18030 of the BMP characters, either the two-byte
+ *                     character (lead<<8 | trail) or GB18030_FOUR plus the
+ *                     linear number of the four-byte character, 0 if none
+ *
+ * They are shared by the threads of bibl_parallel() (see bibthread.c).
+ */
+#define GB18030_NLEAD     ( 0xFE - 0x81 + 1 )
+#define GB18030_NTRAIL    ( 0xFE - 0x40 + 1 )
+#define GB18030_NFOURBMP  (39420)       /* linear number of 84 31 A4 39, plus 1 */
+#define GB18030_SUPPFIRST (189000)      /* linear number of 90 30 81 30 */
+#define GB18030_SUPPLAST  (1237575)     /* linear number of E3 32 9A 35 */
+#define GB18030_FOUR      (0x10000)
+
+/* Roundtrip-mappings that can be enumerated
+ * Note that GB 18030 defines roundtrip mappings for all Unicode code points U+0000..U+10ffff.
+ * This would require 1.1 million <a> elements.
+ * However, most four-byte GB 18030 mappings can be enumerated efficiently within distinct ranges.
+ * Therefore, we use <range> elements for all but the 31000 or so assignments above.
+ *
+ * The last range, U+10000..U+10FFFF from 90 30 81 30, is handled directly in
+ * gb18030_encode() and gb18030_to_unicode().
+ */
+typedef struct granges_t {
+	unsigned int ufirst;
+	unsigned int ulast;
+	unsigned char bfirst[4];
+} granges_t;
+
+static const
+granges_t gb18030_ranges[] = {
+	{ 0x0452, 0x200F, { 0x81, 0x30, 0xD3, 0x30 } },
+	{ 0x2643, 0x2E80, { 0x81, 0x37, 0xA8, 0x39 } },
+	{ 0x361B, 0x3917, { 0x82, 0x30, 0xA6, 0x33 } },
+	{ 0x3CE1, 0x4055, { 0x82, 0x31, 0xD4, 0x38 } },
+	{ 0x4160, 0x4336, { 0x82, 0x32, 0xC9, 0x37 } },
+	{ 0x44D7, 0x464B, { 0x82, 0x33, 0xA3, 0x39 } },
+	{ 0x478E, 0x4946, { 0x82, 0x33, 0xE8, 0x38 } },
+	{ 0x49B8, 0x4C76, { 0x82, 0x34, 0xA1, 0x31 } },
+	{ 0x9FA6, 0xD7FF, { 0x82, 0x35, 0x8F, 0x33 } },
+	{ 0xE865, 0xF92B, { 0x83, 0x36, 0xD0, 0x30 } },
+	{ 0xFA2A, 0xFE2F, { 0x84, 0x30, 0x9C, 0x38 } },
+	{ 0xFFE6, 0xFFFF, { 0x84, 0x31, 0xA2, 0x34 } },
+};
 
+static unsigned short gb18030_two[ GB18030_NLEAD * GB18030_NTRAIL ];
+static unsigned short gb18030_four[ GB18030_NFOURBMP ];
+static unsigned int   gb18030_uni[ 0x10000 ];
+static int gb18030_tables_built = 0;
 
 static int
 in_range( unsigned char n, unsigned char low, unsigned char high )
@@ -30777,94 +30835,89 @@ in_range( unsigned char n, unsigned char low, unsigned char high )
 	return 1;
 }
 
-
-/* Get GB 18030 from Unicode Value in Table */
-static int
-gb18030_unicode_table_lookup( unsigned int unicode, unsigned char out[4] )
+/* number the four-byte characters 81 30 81 30 = 0 up to FE 39 FE 39 */
+static unsigned int
+gb18030_linear( const unsigned char *b )
 {
-	int i, j;
-	if ( unicode >= 0x0080 && unicode <= 0xFFE5 ) {
-		/* list is sorted, so should do binary search here */
-		for ( i=0; i<ngb18030_enums; ++i ) {
-			if ( unicode == gb18030_enums[i].unicode ) {
-				for ( j=0; j<gb18030_enums[i].len; ++j )
-					out[j] = gb18030_enums[i].bytes[j];
-				return gb18030_enums[i].len;
-			}
-		}
-	}
-	return 0;
+	return ( ( ( b[0] - 0x81 ) * 10 + ( b[1] - 0x30 ) ) * 126 + ( b[2] - 0x81 ) ) * 10 + ( b[3] - 0x30 );
 }
 
-static int
-gb18030_match( unsigned char *s, const unsigned char *bytes, unsigned char len )
+static void
+gb18030_unlinear( unsigned int n, unsigned char out[4] )
 {
-	int i;
-	for ( i=0; i<len; ++i )
-		if ( ( s[i])!=bytes[i] ) return 0;
-	return 1;
+	out[3] = 0x30 + n % 10;
+	n /= 10;
+	out[2] = 0x81 + n % 126;
+	n /= 126;
+	out[1] = 0x30 + n % 10;
+	out[0] = 0x81 + n / 10;
 }
 
-static unsigned int
-gb18030_table_lookup( unsigned char *uc, unsigned char len, int *found )
+static void
+gb18030_tables_build( void )
 {
-	unsigned int i;
-	*found = 0;
+	unsigned int i, u, n, m;
+	const unsigned char *b;
+
 	for ( i=0; i<ngb18030_enums; ++i ) {
-		if ( gb18030_enums[i].len!=len ) continue;
-		if ( gb18030_match( &(uc[0]), gb18030_enums[i].bytes, len ) ) {
-			*found = 1;
-			return gb18030_enums[i].unicode;
+		u = gb18030_enums[i].unicode;
+		b = gb18030_enums[i].bytes;
+		if ( gb18030_enums[i].len==2 ) {
+			gb18030_two[ ( b[0] - 0x81 ) * GB18030_NTRAIL + ( b[1] - 0x40 ) ] = u;
+			if ( !gb18030_uni[u] ) gb18030_uni[u] = ( b[0] << 8 ) | b[1];
+		} else if ( gb18030_enums[i].len==4 ) {
+			n = gb18030_linear( b );
+			gb18030_four[n] = u;
+			if ( !gb18030_uni[u] ) gb18030_uni[u] = GB18030_FOUR + n;
 		}
 	}
-	return '?';
-}
 
-
-static int
-gb18030_unicode_range_lookup( unsigned int unicode, unsigned char out[4] ) 
-{
-	return 0;
+	for ( i=0; i<sizeof( gb18030_ranges ) / sizeof( gb18030_ranges[0] ); ++i ) {
+		n = gb18030_linear( gb18030_ranges[i].bfirst );
+		for ( u=gb18030_ranges[i].ufirst; u<=gb18030_ranges[i].ulast; ++u ) {
+			m = n + ( u - gb18030_ranges[i].ufirst );
+			gb18030_four[m] = u;
+			if ( !gb18030_uni[u] ) gb18030_uni[u] = GB18030_FOUR + m;
+		}
+	}
 }
 
-static int
-gb18030_range_lookup( unsigned char *s, /* unsigned char len = 4 only */ int *found )
+static void
+gb18030_tables( void )
 {
-	*found = 0;
-	return 0;
-#if 0
-  <!-- Roundtrip-mappings that can be enumerated
-       Note that GB 18030 defines roundtrip mappings for all Unicode code points U+0000..U+10ffff.
-       This would require 1.1 million <a> elements.
-       However, most four-byte GB 18030 mappings can be enumerated efficiently within distinct ranges.
-       Therefore, we use <range> elements for all but the 31000 or so assignments above.
-    -->
-  <range uFirst="0452" uLast="200F"  bFirst="81 30 D3 30" bLast="81 36 A5 31"  bMin="81 30 81 30" bMax="FE 39 FE 39"/>
-  <range uFirst="2643" uLast="2E80"  bFirst="81 37 A8 39" bLast="81 38 FD 38"  bMin="81 30 81 30" bMax="FE 39 FE 39"/>
-  <range uFirst="361B" uLast="3917"  bFirst="82 30 A6 33" bLast="82 30 F2 37"  bMin="81 30 81 30" bMax="FE 39 FE 39"/>
-  <range uFirst="3CE1" uLast="4055"  bFirst="82 31 D4 38" bLast="82 32 AF 32"  bMin="81 30 81 30" bMax="FE 39 FE 39"/>
-  <range uFirst="4160" uLast="4336"  bFirst="82 32 C9 37" bLast="82 32 F8 37"  bMin="81 30 81 30" bMax="FE 39 FE 39"/>
-  <range uFirst="44D7" uLast="464B"  bFirst="82 33 A3 39" bLast="82 33 C9 31"  bMin="81 30 81 30" bMax="FE 39 FE 39"/>
-  <range uFirst="478E" uLast="4946"  bFirst="82 33 E8 38" bLast="82 34 96 38"  bMin="81 30 81 30" bMax="FE 39 FE 39"/>
-  <range uFirst="49B8" uLast="4C76"  bFirst="82 34 A1 31" bLast="82 34 E7 33"  bMin="81 30 81 30" bMax="FE 39 FE 39"/>
-  <range uFirst="9FA6" uLast="D7FF"  bFirst="82 35 8F 33" bLast="83 36 C7 38"  bMin="81 30 81 30" bMax="FE 39 FE 39"/>
-  <range uFirst="E865" uLast="F92B"  bFirst="83 36 D0 30" bLast="84 30 85 34"  bMin="81 30 81 30" bMax="FE 39 FE 39"/>
-  <range uFirst="FA2A" uLast="FE2F"  bFirst="84 30 9C 38" bLast="84 31 85 37"  bMin="81 30 81 30" bMax="FE 39 FE 39"/>
-  <range uFirst="FFE6" uLast="FFFF"  bFirst="84 31 A2 34" bLast="84 31 A4 39"  bMin="81 30 81 30" bMax="FE 39 FE 39"/>
-  <range uFirst="10000" uLast="10FFFF"  bFirst="90 30 81 30" bLast="E3 32 9A 35"  bMin="81 30 81 30" bMax="FE 39 FE 39"/>
+	int built;
+
+	bibl_load_acquire( built, gb18030_tables_built );
+	if ( built ) return;
+#ifdef _OPENMP
+#pragma omp critical ( gb18030_tables )
 #endif
+	{
+		if ( !gb18030_tables_built ) {
+			gb18030_tables_build();
+			bibl_store_release( gb18030_tables_built, 1 );
+		}
+	}
 }
 
 unsigned int
 gb18030_to_unicode( unsigned char *s, unsigned char len )
 {
-	unsigned int ret;
-	int found;
-	ret = gb18030_table_lookup( s, len, &found );
-	if ( !found && len==4 ) {
-		ret = gb18030_range_lookup( s, &found );
-		if ( !found ) ret = '?';
+	unsigned int n, ret = 0;
+
+	gb18030_tables();
+
+	if ( len==2 ) {
+		ret = gb18030_two[ ( s[0] - 0x81 ) * GB18030_NTRAIL + ( s[1] - 0x40 ) ];
+	} else if ( len==4 ) {
+		n = gb18030_linear( s );
+		if ( n < GB18030_NFOURBMP )
+			ret = gb18030_four[n];
+		else if ( n >= GB18030_SUPPFIRST && n <= GB18030_SUPPLAST )
+			ret = 0x10000 + ( n - GB18030_SUPPFIRST );
 	}
+
+	if ( !ret ) ret = '?';
 	return ret;
 }
 
@@ -30876,20 +30929,38 @@ gb18030_to_unicode( unsigned char *s, unsigned char len )
 int
 gb18030_encode( unsigned int unicode, unsigned char out[4] )
 {
-	int len;
+	unsigned int v;
+
 	if ( unicode < 0x80 ) {
 		out[0] = unicode;
-		len = 1;
-	} else {
-		len = gb18030_unicode_table_lookup( unicode, out );
-		if ( !len )
-			len = gb18030_unicode_range_lookup( unicode, out ); 
+		return 1;
+	}
+
+	if ( unicode >= 0x10000 ) {
+		if ( unicode > 0x10FFFF ) return 0;
+		gb18030_unlinear( GB18030_SUPPFIRST + ( unicode - 0x10000 ), out );
+		return 4;
 	}
-	return len;
+
+	gb18030_tables();
+
+	v = gb18030_uni[ unicode ];
+	if ( !v ) return 0;
+	if ( v >= GB18030_FOUR ) {
+		gb18030_unlinear( v - GB18030_FOUR, out );
+		return 4;
+	}
+	out[0] = v >> 8;
+	out[1] = v & 0xFF;
+	return 2;
 }
 
 /*
  * Decode a gb18030 character into unicode
+ *
+ * The trailing bytes are only read as far as they can belong to the
+ * character, so that a truncated character at the end of the string
+ * doesn't read beyond the terminating '\0'.
  */
 unsigned int
 gb18030_decode( char *s, unsigned int *pi )
@@ -30906,15 +30977,13 @@ gb18030_decode( char *s, unsigned int *pi )
 		i += 1;
 	} else if ( uc[0] != 0xFF ) { /* multi-byte character */
 		uc[1] = ( unsigned char ) s[i+1];
-		uc[2] = ( unsigned char ) s[i+2];
-		uc[3]= ( unsigned char ) s[i+3];
 		if ( in_range( uc[1], 0x40, 0x7e ) || in_range( uc[1], 0x80, 0xfe ) ) {
 			/* two-byte character */
 			c = gb18030_to_unicode( &(uc[0]), 2 );
 			i += 2;
 		} else if ( in_range( uc[1], 0x30, 0x39 ) &&
-		            in_range( uc[2], 0x81, 0xfe ) &&
-		            in_range( uc[3], 0x30, 0x39 ) ) {
+		            in_range( ( uc[2] = ( unsigned char ) s[i+2] ), 0x81, 0xfe ) &&
+		            in_range( ( uc[3] = ( unsigned char ) s[i+3] ), 0x30, 0x39 ) ) {
 			/* four-byte character */
 			c = gb18030_to_unicode( &(uc[0]), 4 );
 			i += 4;
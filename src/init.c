@@ -7,6 +7,7 @@
  *
  */
 #include <stdlib.h> // for NULL
+#include <Rinternals.h>
 #include <R_ext/Rdynload.h>
 
 /* .C calls */
@@ -16,6 +17,7 @@ extern void bibl_freeparams( void * );
 extern void any2xml_main( int *argcin, char *argv[], char *outfile[], double *nref );
 extern void xml2any_main( int *argcin, char *argv[], char *outfile[], double *nref );
 extern void bib2be_main(  int *argcin, char *argv[], char *outfile[], double *nref );
+extern void any2any_main( int *argcin, char *argv[], char *outfile[], double *nref );
   
 static const R_CMethodDef CEntries[] = {
   {"bibl_freeparams", (DL_FUNC) &bibl_freeparams, 1},
@@ -23,13 +25,36 @@ static const R_CMethodDef CEntries[] = {
   {"any2xml_main", (DL_FUNC) &any2xml_main, 4},
   {"xml2any_main", (DL_FUNC) &xml2any_main, 4},
   {"bib2be_main",  (DL_FUNC) &bib2be_main, 4},
+  {"any2any_main", (DL_FUNC) &any2any_main, 4},
   
   {NULL, NULL, 0}
 };
 
+/* .Call calls */
+
+extern SEXP bib2be_bibentry( SEXP argv );
+extern SEXP xml2any_bibentry( SEXP argv );
+extern SEXP any2any_bibentry( SEXP argv );
+
+static const R_CallMethodDef CallEntries[] = {
+  {"bib2be_bibentry",  (DL_FUNC) &bib2be_bibentry,  1},
+  {"xml2any_bibentry", (DL_FUNC) &xml2any_bibentry, 1},
+  {"any2any_bibentry", (DL_FUNC) &any2any_bibentry, 1},
+
+  {NULL, NULL, 0}
+};
+
 void R_init_rbibutils(DllInfo *dll)
 {
-  R_registerRoutines(dll, CEntries, NULL, NULL, NULL);
+  R_registerRoutines(dll, CEntries, CallEntries, NULL, NULL);
   R_useDynamicSymbols(dll, FALSE);
   // R_forceSymbols(dll, TRUE);
 }
+
+extern void tagatom_free( void );
+
+/* called by library.dynam.unload(), see .onUnload() */
+void R_unload_rbibutils(DllInfo *dll)
+{
+  tagatom_free();
+}
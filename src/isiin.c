@@ -25,7 +25,7 @@
 extern variants isi_all[];
 extern int isi_nall;
 
-static int isiin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset );
+static int isiin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm );
 static int isiin_typef( fields *isiin, const char *filename, int nref, param *p );
 static int isiin_convertf( fields *isiin, fields *info, int reftype, param *p );
 static int isiin_processf( fields *isiin, const char *p, const char *filename, long nref, param *pm );
@@ -86,21 +86,21 @@ is_isi_tag( const char *buf )
 }
 
 static int
-readmore( FILE *fp, char *buf, int bufsize, int *bufpos, str *line )
+readmore( freader *fr, str *line )
 {
 	if ( line->len ) return 1;
-	else return str_fget( fp, buf, bufsize, bufpos, line );
+	else return freader_getline( fr, line );
 }
 
 static int
-isiin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset )
+isiin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm )
 {
 	int haveref = 0, inref = 0;
 	char *p;
 
 	*fcharset = CHARSET_UNKNOWN;
 
-	while ( !haveref && readmore( fp, buf, bufsize, bufpos, line ) ) {
+	while ( !haveref && readmore( fr, line ) ) {
 
 		if ( str_is_empty( line ) ) continue;
 
@@ -15,8 +15,8 @@
 #include "latex.h"
 
 #include <R.h>
+#include "bibthread.h"
 
-int convert_latex_escapes_only = 0; // Georgi
 
 #define LATEX_COMBO (0)  /* 'combo' no need for protection on output */
 #define LATEX_MACRO (1)  /* 'macro_name' to be protected by {\macro_name} on output */
@@ -470,18 +470,24 @@ static struct latex_chars only_from_latex[] = {
 static int num_only_from_latex = sizeof( only_from_latex ) / sizeof( only_from_latex[0] );
 
 
-/* latex2char()
- *
- *   Use the latex_chars[] lookup table to determine if any character
- *   is a special LaTeX code.  Note that if it is, then the equivalency
- *   is a Unicode character and we need to flag (by setting *unicode to 1)
- *   that we know the output is Unicode.  Otherwise, we set *unicode to 0,
- *   meaning that the output is whatever character set was given to us
- *   (which could be Unicode, but is not necessarily Unicode).
- *
- */
+/* compare p with a variant; with 'brace' non-zero p[2] is taken to be ' ',
+ * so that \v{z} matches the variant "\\v z" (p is not changed) */
+static int
+latex_variant_match( const char *p, const struct latex_entry *variant, int brace )
+{
+	int k;
+	char c;
+	for ( k=0; k<variant->length; ++k ) {
+		c = ( brace && k==2 ) ? ' ' : p[k];
+		if ( c != variant->entry[k] ) return 0;
+		if ( c == '\0' ) return 0;
+	}
+	return 1;
+}
+
+/* linear search, only used if the trie below cannot be built */
 static unsigned int
-lookup_latex( struct latex_chars *lc, int n, char *p, unsigned int *pos, int *unicode )
+lookup_latex( struct latex_chars *lc, int n, char *p, int brace, unsigned int *pos, int *unicode )
 {
 	struct latex_entry *variant;
 	int i, j;
@@ -490,7 +496,7 @@ lookup_latex( struct latex_chars *lc, int n, char *p, unsigned int *pos, int *un
 		for ( j=0; j<NUM_VARIANTS; ++j ) {
 			variant = &(lc[i].variant[j] );
 			if ( variant->entry == NULL ) break;
-			if ( !strncmp( p, variant->entry, variant->length ) ) {
+			if ( latex_variant_match( p, variant, brace ) ) {
 				*pos = *pos + variant->length;
 				*unicode = 1;
 				return lc[i].unicode;
@@ -501,8 +507,175 @@ lookup_latex( struct latex_chars *lc, int n, char *p, unsigned int *pos, int *un
 	return 0;
 }
 
+/* Georgi: a trie over the variants of latex_chars[] and only_from_latex[]
+ *
+ * Each node is one character of a variant; 'entry' is the smallest
+ * i*NUM_VARIANTS+j over the variants j of latex_chars[i] ending at the node
+ * (-1 if there are none) and 'from' the same for only_from_latex[]. Walking
+ * down the trie along the input visits all variants that are a prefix of
+ * it, and keeping the smallest 'entry' gives the same result as the linear
+ * search, where the first match in the table wins (the order of the table
+ * matters, e.g. \~ has to come after \~n).
+ *
+ * The trie is built on first use and shared by the threads of
+ * bibl_parallel() (see bibthread.c). It is never freed.
+ */
+typedef struct latex_node {
+	int child;              /* first child, -1 if none */
+	int sibling;            /* next child of the parent, -1 if none */
+	int entry;
+	int from;
+	char c;
+} latex_node;
+
+static latex_node *latex_trie = NULL;
+
+static int
+latex_trie_size( struct latex_chars *lc, int n )
+{
+	int i, j, size = 0;
+	for ( i=0; i<n; ++i )
+		for ( j=0; j<NUM_VARIANTS && lc[i].variant[j].entry; ++j )
+			size += lc[i].variant[j].length;
+	return size;
+}
+
+static void
+latex_trie_add( latex_node *t, int *nt, struct latex_chars *lc, int n, int from )
+{
+	struct latex_entry *variant;
+	int i, j, k, m, node, prio;
+
+	for ( i=0; i<n; ++i ) {
+		for ( j=0; j<NUM_VARIANTS; ++j ) {
+			variant = &(lc[i].variant[j] );
+			if ( variant->entry == NULL ) break;
+			node = 0;
+			for ( k=0; k<variant->length; ++k ) {
+				for ( m=t[node].child; m!=-1; m=t[m].sibling )
+					if ( t[m].c == variant->entry[k] ) break;
+				if ( m==-1 ) {
+					m = (*nt)++;
+					t[m].c       = variant->entry[k];
+					t[m].child   = -1;
+					t[m].entry   = -1;
+					t[m].from    = -1;
+					t[m].sibling = t[node].child;
+					t[node].child = m;
+				}
+				node = m;
+			}
+			prio = i * NUM_VARIANTS + j;
+			if ( from ) {
+				if ( t[node].from==-1 ) t[node].from = prio;
+			} else {
+				if ( t[node].entry==-1 ) t[node].entry = prio;
+			}
+		}
+	}
+}
+
+static latex_node *
+latex_trie_build( void )
+{
+	latex_node *t;
+	int nt = 1;
+
+	t = ( latex_node * ) malloc( sizeof( latex_node ) *
+		( 1 + latex_trie_size( latex_chars, nlatex_chars ) +
+		      latex_trie_size( only_from_latex, num_only_from_latex ) ) );
+	if ( !t ) return NULL;
+
+	t[0].c       = '\0';
+	t[0].child   = -1;
+	t[0].sibling = -1;
+	t[0].entry   = -1;
+	t[0].from    = -1;
+
+	latex_trie_add( t, &nt, latex_chars, nlatex_chars, 0 );
+	latex_trie_add( t, &nt, only_from_latex, num_only_from_latex, 1 );
+
+	return t;
+}
+
+/* NULL only on memory error */
+static latex_node *
+latex_trie_get( void )
+{
+	latex_node *t;
+
+	bibl_load_acquire( t, latex_trie );
+	if ( !t ) {
+#ifdef _OPENMP
+#pragma omp critical ( latex_trie )
+#endif
+		{
+			t = latex_trie;
+			if ( !t ) {
+				t = latex_trie_build();
+				if ( t ) bibl_store_release( latex_trie, t );
+			}
+		}
+	}
+
+	return t;
+}
+
+/* Look up p in latex_chars[0..n-1] (from==0) or only_from_latex[0..n-1]
+ * (from!=0), see lookup_latex() */
+static unsigned int
+lookup_latex_trie( latex_node *t, int from, int n, char *p, int brace, unsigned int *pos, int *unicode )
+{
+	int k, node, prio, best = n * NUM_VARIANTS, bestlen = 0;
+	char c;
+
+	node = 0;
+	for ( k=0; p[k]; ++k ) {
+		c = ( brace && k==2 ) ? ' ' : p[k];
+		for ( node=t[node].child; node!=-1; node=t[node].sibling )
+			if ( t[node].c == c ) break;
+		if ( node==-1 ) break;
+		prio = from ? t[node].from : t[node].entry;
+		if ( prio!=-1 && prio < best ) {
+			best = prio;
+			bestlen = k + 1;
+		}
+	}
+
+	if ( bestlen==0 ) return 0;
+
+	*pos = *pos + bestlen;
+	*unicode = 1;
+	return from ? only_from_latex[ best / NUM_VARIANTS ].unicode :
+	              latex_chars[ best / NUM_VARIANTS ].unicode;
+}
+
+static unsigned int
+latex_lookup( int from, int n, char *p, int brace, unsigned int *pos, int *unicode )
+{
+	latex_node *t = latex_trie_get();
+
+	if ( t ) return lookup_latex_trie( t, from, n, p, brace, pos, unicode );
+	else if ( from ) return lookup_latex( only_from_latex, n, p, brace, pos, unicode );
+	else return lookup_latex( latex_chars, n, p, brace, pos, unicode );
+}
+
+/* latex2char()
+ *
+ *   Use the latex_chars[] lookup table to determine if any character
+ *   is a special LaTeX code.  Note that if it is, then the equivalency
+ *   is a Unicode character and we need to flag (by setting *unicode to 1)
+ *   that we know the output is Unicode.  Otherwise, we set *unicode to 0,
+ *   meaning that the output is whatever character set was given to us
+ *   (which could be Unicode, but is not necessarily Unicode).
+ *
+ *   Georgi: if escapes_only is non-zero (this used to be the global
+ *   convert_latex_escapes_only), only sequences starting with '\\'
+ *   are converted, using the part of latex_chars[] before \Alpha.
+ *
+ */
 unsigned int
-latex2char( char *s, unsigned int *pos, int *unicode )
+latex2char( char *s, unsigned int *pos, int *unicode, int escapes_only )
 {
      unsigned int value, result;
      char *p;
@@ -511,34 +684,31 @@ latex2char( char *s, unsigned int *pos, int *unicode )
      p = &( s[*pos] );
      value = (unsigned char) *p;
 
-     if(convert_latex_escapes_only == 1) {
+     if(escapes_only) {
 	  // if ( strchr( "\\\'\"`-^_lL", value ) ) { ... }
 	  if ( value ==  '\\' ) {
-	       result = lookup_latex( latex_chars, nlatexchars_escaped_only, p, pos, unicode );
+	       result = latex_lookup( 0, nlatexchars_escaped_only, p, 0, pos, unicode );
 	       if ( result!=0 ) return result;
 
 	       // crude patch for \\v{z} and similar, should really consolidate all this.
+	       //    (the lookup takes p[2] to be ' ', p is no longer changed)
 	       if(p[1] && p[2] && p[2] == '{'  && p[3]  && p[4] && p[4] == '}'  ) {
-		    p[2] = ' ';
-		    result = lookup_latex( latex_chars, nlatexchars_escaped_only, p, pos, unicode ); // until \Alpha in latex.c
+		    result = latex_lookup( 0, nlatexchars_escaped_only, p, 1, pos, unicode ); // until \Alpha in latex.c
 		    if ( result!=0 ) {
 			 *pos += 1;  // skip '}' // set unicode = 1 ? (no, lookup_latex() sets it if needed
-			 p[2] = '{';
 			 return result;
-		    } else {            // 2024-10-19 BUGFIX: restore '{' if conversion not successful
-			 p[2] = '{'; 
 		    }
 	       }
 	  }
      }
      else {
 	  if ( strchr( "\\\'\"`-^_lL", value ) ) {
-	       result = lookup_latex( latex_chars, nlatex_chars, p, pos, unicode );
+	       result = latex_lookup( 0, nlatex_chars, p, 0, pos, unicode );
 	       if ( result!=0 ) return result;
 	  }
 
 	  if ( value=='~' || value=='\\' ) {
-	       result = lookup_latex( only_from_latex, num_only_from_latex, p, pos, unicode );
+	       result = latex_lookup( 1, num_only_from_latex, p, 0, pos, unicode );
 	       if ( result!=0 ) return result;
 	  }
      }
@@ -548,6 +718,75 @@ latex2char( char *s, unsigned int *pos, int *unicode )
      return value;
 }
 
+/* Georgi: index of latex_chars[] by code point for uni2latex()
+ *
+ * Sorted by code point, with only the first entry of latex_chars[] for each
+ * code point (the one found by the linear search used before). Filled on
+ * first use and shared by the threads of bibl_parallel().
+ */
+typedef struct latex_index {
+	unsigned int unicode;
+	int i;                  /* position in latex_chars[] */
+} latex_index;
+
+static latex_index latex_unicodes[ sizeof( latex_chars ) / sizeof( latex_chars[0] ) ];
+static int nlatex_unicodes = 0;
+
+static int
+latex_index_cmp( const void *v1, const void *v2 )
+{
+	const latex_index *a = ( const latex_index * ) v1;
+	const latex_index *b = ( const latex_index * ) v2;
+	if ( a->unicode != b->unicode ) return ( a->unicode < b->unicode ) ? -1 : 1;
+	return a->i - b->i;
+}
+
+static int
+latex_index_get( void )
+{
+	int i, n;
+
+	bibl_load_acquire( n, nlatex_unicodes );
+	if ( !n ) {
+#ifdef _OPENMP
+#pragma omp critical ( latex_unicodes )
+#endif
+		{
+			n = nlatex_unicodes;
+			if ( !n ) {
+				for ( i=0; i<nlatex_chars; ++i ) {
+					latex_unicodes[i].unicode = latex_chars[i].unicode;
+					latex_unicodes[i].i = i;
+				}
+				qsort( latex_unicodes, nlatex_chars, sizeof( latex_index ), latex_index_cmp );
+				for ( i=0; i<nlatex_chars; ++i ) {
+					if ( n && latex_unicodes[n-1].unicode == latex_unicodes[i].unicode ) continue;
+					latex_unicodes[n++] = latex_unicodes[i];
+				}
+				bibl_store_release( nlatex_unicodes, n );
+			}
+		}
+	}
+
+	return n;
+}
+
+/* position of ch in latex_chars[], -1 if it is not there */
+static int
+latex_find_unicode( unsigned int ch )
+{
+	int lo = 0, hi = latex_index_get() - 1, mid;
+
+	while ( lo <= hi ) {
+		mid = lo + ( hi - lo ) / 2;
+		if ( latex_unicodes[mid].unicode == ch ) return latex_unicodes[mid].i;
+		if ( latex_unicodes[mid].unicode < ch ) lo = mid + 1;
+		else hi = mid - 1;
+	}
+
+	return -1;
+}
+
 void
 uni2latex( unsigned int ch, char buf[], int buf_size )
 {
@@ -563,36 +802,35 @@ uni2latex( unsigned int ch, char buf[], int buf_size )
 		return;
 	}
 
-	for ( i=0; i<nlatex_chars; ++i ) {
-		if ( ch == latex_chars[i].unicode ) {
-			n = 0;
+	i = latex_find_unicode( ch );
+	if ( i!=-1 ) {
+		n = 0;
 
-			if ( latex_chars[i].type == LATEX_MACRO ) {
-				if ( n < buf_size ) buf[n++] = '{';
-				if ( n < buf_size ) buf[n++] = '\\';
-			}
-			else if ( latex_chars[i].type == LATEX_MATH ) {
-				if ( n < buf_size ) buf[n++] = '$';
-			}
+		if ( latex_chars[i].type == LATEX_MACRO ) {
+			if ( n < buf_size ) buf[n++] = '{';
+			if ( n < buf_size ) buf[n++] = '\\';
+		}
+		else if ( latex_chars[i].type == LATEX_MATH ) {
+			if ( n < buf_size ) buf[n++] = '$';
+		}
 
-			j = 0;
-			while ( latex_chars[i].out[j] ) {
-				if ( n < buf_size ) buf[n++] = latex_chars[i].out[j];
-				j++;
-			}
+		j = 0;
+		while ( latex_chars[i].out[j] ) {
+			if ( n < buf_size ) buf[n++] = latex_chars[i].out[j];
+			j++;
+		}
 
-			if ( latex_chars[i].type == LATEX_MACRO ) {
-				if ( n < buf_size ) buf[n++] = '}';
-			}
-			else if ( latex_chars[i].type == LATEX_MATH ) {
-				if ( n < buf_size ) buf[n++] = '$';
-			}
+		if ( latex_chars[i].type == LATEX_MACRO ) {
+			if ( n < buf_size ) buf[n++] = '}';
+		}
+		else if ( latex_chars[i].type == LATEX_MATH ) {
+			if ( n < buf_size ) buf[n++] = '$';
+		}
 
-			if ( n < buf_size ) buf[n] = '\0';
-			else buf[ buf_size-1 ] = '\0';
+		if ( n < buf_size ) buf[n] = '\0';
+		else buf[ buf_size-1 ] = '\0';
 
-			return;
-		}
+		return;
 	}
 
 	if ( ch < 128 ) buf[0] = (char)ch;
@@ -9,10 +9,8 @@
 #ifndef LATEX_H
 #define LATEX_H
 
-extern unsigned int latex2char( char *s, unsigned int *pos, int *unicode );
+extern unsigned int latex2char( char *s, unsigned int *pos, int *unicode, int escapes_only );
 extern void uni2latex( unsigned int ch, char buf[], int buf_size );
 
-extern int convert_latex_escapes_only;
-
 #endif
 
@@ -15,11 +15,12 @@
 #include "fields.h"
 #include "xml.h"
 #include "xml_encoding.h"
+#include "xml_split.h"
 #include "iso639_2.h"
 #include "bibutils.h"
 #include "bibformats.h"
 
-static int medin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset );
+static int medin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm );
 static int medin_processf( fields *medin, const char *data, const char *filename, long nref, param *p );
 
 
@@ -73,85 +74,14 @@ medin_initparams( param *pm, const char *progname )
 static char *wrapper[] = { "PubmedArticle", "MedlineCitation" };
 static int nwrapper = sizeof( wrapper ) / sizeof( wrapper[0] );
 
-static char *
-medin_findstartwrapper( char *buf, int *ntype )
-{
-	char *startptr=NULL;
-	int i;
-	for ( i=0; i<nwrapper && startptr==NULL; ++i ) {
-		startptr = xml_find_start( buf, wrapper[ i ] );
-		if ( startptr && *ntype==-1 ) *ntype = i;
-	}
-	return startptr;
-}
-
-static char *
-medin_findendwrapper( char *buf, int ntype )
-{
-	char *endptr = xml_find_end( buf, wrapper[ ntype ] );
-	return endptr;
-}
-
+/* Georgi: the text after the end of a reference is left for the next one
+ *         (issue #4), xml_split_record() pushes it back to the reader
+ */
 static int
-medin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset )
+medin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm )
 {
-	str tmp;
-	char *startptr = NULL, *endptr;
-	int haveref = 0, inref = 0, file_charset = CHARSET_UNKNOWN, m, type = -1;
-	str_init( &tmp );
-	// while ( !haveref && str_fget( fp, buf, bufsize, bufpos, line ) ) {
-	// 	if ( line->data ) {
-	// 		m = xml_getencoding( line );
-	// 		if ( m!=CHARSET_UNKNOWN ) file_charset = m;
-	// 	}
-	// 	if ( line->data ) {
-	// 		startptr = medin_findstartwrapper( line->data, &type );
-	// 	}
-	// 	if ( startptr || inref ) {
-	// 		if ( inref ) str_strcat( &tmp, line );
-	// 		else {
-	// 			str_strcatc( &tmp, startptr );
-	// 			inref = 1;
-	// 		}
-	// 		endptr = medin_findendwrapper( str_cstr( &tmp ), type );
-	// 		if ( endptr ) {
-	// 			str_segcpy( reference, str_cstr( &tmp ), endptr );
-	// 			haveref = 1;
-	// 		}
-	// 	}
-	// }
-
-	// Georgi: bugfix: issue #4
-	//
-	//         The above code doesn't work properly if the end of a reference is not on a
-	//         line by itself (it drops all text on the line after the end of the reference).
-	do {
-		if ( line->data ) {
-			m = xml_getencoding( line );
-			if ( m!=CHARSET_UNKNOWN ) file_charset = m;
-		}
-		if ( line->data ) {
-			startptr = medin_findstartwrapper( line->data, &type );
-		}
-		if ( startptr || inref ) {
-			if ( inref ) str_strcat( &tmp, line );
-			else {
-				str_strcatc( &tmp, startptr );
-				inref = 1;
-			}
-			str_empty( line );  // Georgi
-			endptr = medin_findendwrapper( str_cstr( &tmp ), type );
-			if ( endptr ) {
-				str_segcpy( reference, str_cstr( &tmp ), endptr );
-				str_strcpyc( line, endptr ); // Georgi: leave unprocessed stuff in line
-				haveref = 1;
-			}
-		}
-	} while ( !haveref && str_fget( fp, buf, bufsize, bufpos, line ) ) ;
-	
-	str_free( &tmp );
-	*fcharset = file_charset;
-	return haveref;
+	int type;
+	return xml_split_record( fr, wrapper, nwrapper, XML_SPLIT_JOINLINES, reference, &type, fcharset );
 }
 
 /*****************************************************
@@ -251,8 +181,8 @@ medin_language( xml *node, fields *info, int level )
 {
 	char *code, *language;
 	int fstatus;
+	if ( !xml_has_value( node ) ) return BIBL_OK;
 	code = xml_value_cstr( node );
-	if ( !code ) return BIBL_OK;
 	language = iso639_2_from_code( code );
 	if ( language )
 		fstatus = fields_add( info, "LANGUAGE", language, level );
@@ -289,6 +219,9 @@ medin_language( xml *node, fields *info, int level )
  *    <Title>Alcohol and alcoholism (Oxford, Oxfordshire)  </Title>
  *    <ISOAbbreviation>Alcohol Alcohol.</ISOAbbreviation>
  * </Journal>
+ *
+ * Georgi: applied to each element of <Journal> and, as the tree walk this
+ *         replaces did, of the elements following it in <Article>
  */
 static int
 medin_journal1( xml *node, fields *info )
@@ -304,29 +237,16 @@ medin_journal1( xml *node, fields *info )
 		{ "Day",             NULL, NULL, "PARTDATE:DAY",   1 },
 	};
 	int nc = sizeof( c ) / sizeof( c[0] ), status, found;
-	if ( xml_has_value( node ) ) {
-		status = medin_doconvert( node, info, c, nc, &found );
-		if ( status!=BIBL_OK ) return status;
-		if ( !found ) {
-			if ( xml_tag_matches( node, "MedlineDate" ) ) {
-				status = medin_medlinedate( info, xml_value_cstr( node ), 1 );
-				if ( status!=BIBL_OK ) return status;
-			}
-			if ( xml_tag_matches( node, "Language" ) ) {
-				status = medin_language( node, info, LEVEL_HOST );
-				if ( status!=BIBL_OK ) return status;
-			}
-		}
-	}
-	if ( node->down ) {
-		status = medin_journal1( node->down, info );
-		if ( status!=BIBL_OK ) return status;
-	}
-	if ( node->next ) {
-		status = medin_journal1( node->next, info );
+	if ( !xml_has_value( node ) ) return BIBL_OK;
+	status = medin_doconvert( node, info, c, nc, &found );
+	if ( status!=BIBL_OK || found ) return status;
+	if ( xml_tag_matches( node, "MedlineDate" ) ) {
+		status = medin_medlinedate( info, xml_value_cstr( node ), 1 );
 		if ( status!=BIBL_OK ) return status;
 	}
-	return BIBL_OK;
+	if ( xml_tag_matches( node, "Language" ) )
+		status = medin_language( node, info, LEVEL_HOST );
+	return status;
 }
 
 /* <Pagination>
@@ -336,7 +256,7 @@ medin_journal1( xml *node, fields *info )
 static int
 medin_pagination( xml *node, fields *info )
 {
-	int i, fstatus, status;
+	int i, fstatus;
 	str sp, ep;
 	const char *p, *pp;
 	if ( xml_tag_matches( node, "MedlinePgn" ) && node->value.len ) {
@@ -360,29 +280,21 @@ medin_pagination( xml *node, fields *info )
 		}
 		strs_free( &sp, &ep, NULL );
 	}
-	if ( node->down ) {
-		status = medin_pagination( node->down, info );
-		if ( status!=BIBL_OK ) return status;
-	}
-	if ( node->next ) {
-		status = medin_pagination( node->next, info );
-		if ( status!=BIBL_OK ) return status;
-	}
 	return BIBL_OK;
 }
 
 /* <Abstract>
  *    <AbstractText>ljwejrelr</AbstractText>
  * </Abstract>
+ *
+ * only the first <AbstractText> is used, see medin_end()
  */
 static int
 medin_abstract( xml *node, fields *info )
 {
 	int fstatus;
-	if ( xml_tag_matches_has_value( node, "AbstractText" ) ) {
-		fstatus = fields_add( info, "ABSTRACT", xml_value_cstr( node ), LEVEL_MAIN );
-		if ( fstatus!=FIELDS_OK ) return BIBL_ERR_MEMERR;
-	} else if ( node->next ) return medin_abstract( node->next, info );
+	fstatus = fields_add( info, "ABSTRACT", xml_value_cstr( node ), LEVEL_MAIN );
+	if ( fstatus!=FIELDS_OK ) return BIBL_ERR_MEMERR;
 	return BIBL_OK;
 }
 
@@ -397,6 +309,8 @@ medin_abstract( xml *node, fields *info )
  *        <CollectiveName>Organization</CollectiveName>
  *    </Author>
  * </AuthorList>
+ *
+ * medin_author() adds an element of <Author> to name
  */
 static int
 medin_author( xml *node, str *name )
@@ -423,60 +337,28 @@ medin_author( xml *node, str *name )
 			if ( !is_ws(*p) ) str_addchar( name, *p++ );
 		}
 	}
-	if ( node->next ) medin_author( node->next, name );
-	return BIBL_OK;
-}
-
-static int
-medin_corpauthor( xml *node, str *name )
-{
-	if ( xml_tag_matches( node, "CollectiveName" ) ) {
-		str_strcpy( name, xml_value( node ) );
-	} else if ( node->next ) medin_corpauthor( node->next, name );
 	return BIBL_OK;
 }
 
+/* add the author from name, the first <CollectiveName> (if any) in corp if
+ * there is no personal name
+ */
 static int
-medin_authorlist( xml *node, fields *info )
+medin_authorlist( str *name, str *corp, int hascorp, fields *info )
 {
-	int fstatus, status = BIBL_OK;
+	int fstatus;
 	char *tag;
-	str name;
-
-	str_init( &name );
-
-	node = node->down;
-	while ( node ) {
 
-		if ( xml_tag_matches( node, "Author" ) && node->down ) {
-
-			status = medin_author( node->down, &name );
-			if ( status!=BIBL_OK ) goto out;
-
-			tag = "AUTHOR";
-			if ( str_is_empty( &name ) ) {
-				status = medin_corpauthor( node->down, &name );
-				tag = "AUTHOR:CORP";
-			}
-			if ( str_memerr( &name ) || status!=BIBL_OK ) {
-				status = BIBL_ERR_MEMERR;
-				goto out;
-			}
-			if ( str_has_value( &name ) ) {
-				fstatus = fields_add( info, tag, str_cstr( &name ), LEVEL_MAIN );
-				if ( fstatus!=FIELDS_OK ) {
-					status = BIBL_ERR_MEMERR;
-					goto out;
-				}
-			}
-			str_empty( &name );
-		}
-
-		node = node->next;
+	tag = "AUTHOR";
+	if ( str_is_empty( name ) ) {
+		if ( hascorp ) str_strcpy( name, corp );
+		tag = "AUTHOR:CORP";
+	}
+	if ( str_memerr( name ) ) return BIBL_ERR_MEMERR;
+	if ( str_has_value( name ) ) {
+		fstatus = fields_add( info, tag, str_cstr( name ), LEVEL_MAIN );
+		if ( fstatus!=FIELDS_OK ) return BIBL_ERR_MEMERR;
 	}
-
-out:
-	str_free( &name );
 	return BIBL_OK;
 }
 
@@ -495,17 +377,12 @@ out:
 static int
 medin_journal2( xml *node, fields *info )
 {
-	int fstatus, status = BIBL_OK;
+	int fstatus;
 	if ( xml_tag_matches_has_value( node, "MedlineTA" ) && fields_find( info, "TITLE", LEVEL_HOST )==FIELDS_NOTFOUND ) {
 		fstatus = fields_add( info, "TITLE", xml_value_cstr( node ), 1 );
 		if ( fstatus!=FIELDS_OK ) return BIBL_ERR_MEMERR;
 	}
-	if ( node->down ) {
-		status = medin_journal2( node->down, info );
-		if ( status!=BIBL_OK ) return status;
-	}
-	if ( node->next ) status = medin_journal2( node->next, info );
-	return status;
+	return BIBL_OK;
 }
 
 /*
@@ -521,25 +398,12 @@ medin_journal2( xml *node, fields *info )
 static int
 medin_meshheading( xml *node, fields *info )
 {
-	int fstatus, status = BIBL_OK;
+	int fstatus;
 	if ( xml_tag_matches_has_value( node, "DescriptorName" ) ) {
 		fstatus = fields_add( info, "KEYWORD", xml_value_cstr( node ), 0 );
 		if ( fstatus!=FIELDS_OK ) return BIBL_ERR_MEMERR;
 	}
-	if ( node->next ) status = medin_meshheading( node->next, info );
-	return status;
-}
-
-static int
-medin_meshheadinglist( xml *node, fields *info )
-{
-	int status = BIBL_OK;
-	if ( xml_tag_matches( node, "MeshHeading" ) && node->down ) {
-		status = medin_meshheading( node->down, info );
-		if ( status!=BIBL_OK ) return status;
-	}
-	if ( node->next ) status = medin_meshheadinglist( node->next, info );
-	return status;
+	return BIBL_OK;
 }
 
 /* <PubmedData>
@@ -553,6 +417,9 @@ medin_meshheadinglist( xml *node, fields *info )
  * </PubmedData>
  *
  * I think "pii" is "Publisher Item Identifier"
+ *
+ * Georgi: only this <ArticleIdList>, those in <ReferenceList> are of the
+ *         cited works
  */
 static int
 medin_pubmeddata( xml *node, fields *info )
@@ -564,126 +431,253 @@ medin_pubmeddata( xml *node, fields *info )
 		{ "ArticleId", "IdType", "pmc",     "PMC",     0 },
 		{ "ArticleId", "IdType", "pii",     "PII",     0 },
 	};
-	int nc = sizeof( c ) / sizeof( c[0] ), found, status;
-	status = medin_doconvert( node, info, c, nc, &found );
-	if ( status!=BIBL_OK ) return status;
-	if ( node->next ) {
-		status = medin_pubmeddata( node->next, info );
-		if ( status!=BIBL_OK ) return status;
-	}
-	if ( node->down ) {
-		status = medin_pubmeddata( node->down, info );
-		if ( status!=BIBL_OK ) return status;
-	}
-	return BIBL_OK;
+	int nc = sizeof( c ) / sizeof( c[0] ), found;
+	return medin_doconvert( node, info, c, nc, &found );
 }
 
+/* the elements of <Article> other than those above */
 static int
 medin_article( xml *node, fields *info )
 {
 	int fstatus, status = BIBL_OK;
-	if ( xml_tag_matches( node, "Journal" ) )
-		status = medin_journal1( node, info );
-	else if ( xml_tag_matches( node, "ArticleTitle" ) )
+	if ( xml_tag_matches( node, "ArticleTitle" ) )
 		status = medin_articletitle( node, info );
-	else if ( xml_tag_matches( node, "Pagination" ) && node->down )
-		status = medin_pagination( node->down, info );
-	else if ( xml_tag_matches( node, "Abstract" ) && node->down )
-		status = medin_abstract( node->down, info );
-	else if ( xml_tag_matches( node, "AuthorList" ) )
-		status = medin_authorlist( node, info );
 	else if ( xml_tag_matches( node, "Language" ) )
 		status = medin_language( node, info, LEVEL_MAIN );
-	else if ( xml_tag_matches( node, "Affiliation" ) ) {
+	else if ( xml_tag_matches_has_value( node, "Affiliation" ) ) {
 		fstatus = fields_add( info, "ADDRESS", xml_value_cstr( node ), LEVEL_MAIN );
 		if ( fstatus!=FIELDS_OK ) status = BIBL_ERR_MEMERR;
 	}
-	if ( status!=BIBL_OK ) return status;
-	if ( node->next ) status = medin_article( node->next, info );
 	return status;
 }
 
-static int
-medin_medlinecitation( xml *node, fields *info )
+/* Georgi: the records are converted from the events of xml_sax_parse(), as
+ * the elements end, without building the tree of the record. Each element
+ * gets a context from its parent and its tag (medin_start()), which says
+ * what is taken from its children (medin_end()).
+ */
+enum {
+	MEDIN_TOP,              /* not in a record yet */
+	MEDIN_IGNORE,
+	MEDIN_PUBMEDARTICLE,
+	MEDIN_MEDLINECITATION,
+	MEDIN_ARTICLE,
+	MEDIN_PAGINATION,       /* any depth below <Pagination> */
+	MEDIN_ABSTRACT,
+	MEDIN_AUTHORLIST,
+	MEDIN_AUTHOR,
+	MEDIN_JOURNALINFO,      /* any depth below <MedlineJournalInfo> */
+	MEDIN_MESHHEADINGLIST,
+	MEDIN_MESHHEADING,
+	MEDIN_PUBMEDDATA,
+	MEDIN_ARTICLEIDLIST
+};
+
+typedef struct medin_sax {
+	fields *info;
+	int *context;        /* contexts of the open elements, [0] for the top */
+	int ncontext;
+	int article;         /* depth of <Article>, 0 outside of it */
+	int journal;         /* in <Article> from <Journal> on, see medin_journal1() */
+	fields deferred;     /* see medin_articleinfo() */
+	int abstract;        /* the <AbstractText> was found */
+	str name, corp;      /* of the current <Author> */
+	int hascorp;
+} medin_sax;
+
+/* the fields from the elements of <Article> after <Journal> come after
+ * those of medin_journal1() (as they did with the tree walk), so they are
+ * kept apart until <Article> ends
+ */
+static fields *
+medin_articleinfo( medin_sax *m )
 {
-	int fstatus, status = BIBL_OK;
-	if ( xml_tag_matches_has_value( node, "PMID" ) ) {
-		fstatus = fields_add( info, "PMID", xml_value_cstr( node ), LEVEL_MAIN );
-		if ( fstatus!=FIELDS_OK ) return BIBL_ERR_MEMERR;
-	}
-	if ( node->down ) {
-		if ( xml_tag_matches( node, "Article" ) ) {
-			status = medin_article( node->down, info );
-		} else if ( xml_tag_matches( node, "MedlineJournalInfo" ) ) {
-			status = medin_journal2( node->down, info );
-		} else if ( xml_tag_matches( node, "MeshHeadingList" ) )
-			status = medin_meshheadinglist( node->down, info );
-		if ( status!=BIBL_OK ) return status;
-	}
-	if ( node->next ) status = medin_medlinecitation( node->next, info );
-	return status;
+	return ( m->journal ) ? &(m->deferred) : m->info;
 }
 
 static int
-medin_pubmedarticle( xml *node, fields *info )
+medin_start( xml *node, int depth, void *data )
 {
-	int status = BIBL_OK;
-	if ( node->down ) {
+	medin_sax *m = ( medin_sax * ) data;
+	int context = MEDIN_IGNORE, *more;
+
+	if ( depth >= m->ncontext ) {
+		more = ( int * ) realloc( m->context, sizeof( int ) * ( m->ncontext * 2 ) );
+		if ( !more ) return BIBL_ERR_MEMERR;
+		m->context   = more;
+		m->ncontext *= 2;
+	}
+
+	switch ( m->context[depth-1] ) {
+	case MEDIN_TOP:
+		if ( xml_tag_matches( node, "PubmedArticle" ) )
+			context = MEDIN_PUBMEDARTICLE;
+		else if ( xml_tag_matches( node, "MedlineCitation" ) )
+			context = MEDIN_MEDLINECITATION;
+		else
+			context = MEDIN_TOP;
+		break;
+	case MEDIN_PUBMEDARTICLE:
 		if ( xml_tag_matches( node, "MedlineCitation" ) )
-			status = medin_medlinecitation( node->down, info );
+			context = MEDIN_MEDLINECITATION;
 		else if ( xml_tag_matches( node, "PubmedData" ) )
-			status = medin_pubmeddata( node->down, info );
-		if ( status!=BIBL_OK ) return status;
+			context = MEDIN_PUBMEDDATA;
+		break;
+	case MEDIN_MEDLINECITATION:
+		if ( xml_tag_matches( node, "Article" ) ) {
+			context    = MEDIN_ARTICLE;
+			m->article = depth;
+			m->journal = 0;
+		} else if ( xml_tag_matches( node, "MedlineJournalInfo" ) )
+			context = MEDIN_JOURNALINFO;
+		else if ( xml_tag_matches( node, "MeshHeadingList" ) )
+			context = MEDIN_MESHHEADINGLIST;
+		break;
+	case MEDIN_ARTICLE:
+		if ( xml_tag_matches( node, "Journal" ) )
+			m->journal = 1;
+		else if ( xml_tag_matches( node, "Pagination" ) )
+			context = MEDIN_PAGINATION;
+		else if ( xml_tag_matches( node, "Abstract" ) ) {
+			context     = MEDIN_ABSTRACT;
+			m->abstract = 0;
+		} else if ( xml_tag_matches( node, "AuthorList" ) )
+			context = MEDIN_AUTHORLIST;
+		break;
+	case MEDIN_PAGINATION:
+		context = MEDIN_PAGINATION;
+		break;
+	case MEDIN_AUTHORLIST:
+		if ( xml_tag_matches( node, "Author" ) ) {
+			context    = MEDIN_AUTHOR;
+			str_empty( &(m->name) );
+			str_empty( &(m->corp) );
+			m->hascorp = 0;
+		}
+		break;
+	case MEDIN_JOURNALINFO:
+		context = MEDIN_JOURNALINFO;
+		break;
+	case MEDIN_MESHHEADINGLIST:
+		if ( xml_tag_matches( node, "MeshHeading" ) )
+			context = MEDIN_MESHHEADING;
+		break;
+	case MEDIN_PUBMEDDATA:
+		if ( xml_tag_matches( node, "ArticleIdList" ) )
+			context = MEDIN_ARTICLEIDLIST;
+		break;
 	}
-	if ( node->next ) status = medin_pubmedarticle( node->next, info );
-	return status;
+
+	m->context[depth] = context;
+
+	return BIBL_OK;
 }
 
 static int
-medin_assembleref( xml *node, fields *info )
+medin_end( xml *node, int depth, void *data )
 {
-	int status = BIBL_OK;
-	if ( node->down ) {
-		if ( xml_tag_matches( node, "PubmedArticle" ) )
-			status = medin_pubmedarticle( node->down, info );
-		else if ( xml_tag_matches( node, "MedlineCitation" ) )
-			status = medin_medlinecitation( node->down, info );
-		else
-			status = medin_assembleref( node->down, info );
-	}
-	if ( status!=BIBL_OK ) return status;
+	medin_sax *m = ( medin_sax * ) data;
+	int i, fstatus, status = BIBL_OK;
 
-	if ( node->next ) {
-		status = medin_assembleref( node->next, info );
+	if ( m->journal && depth > m->article ) {
+		status = medin_journal1( node, m->info );
 		if ( status!=BIBL_OK ) return status;
 	}
 
-	/* assume everything is a journal article */
-	if ( fields_num( info ) ) {
-		status = fields_add( info, "RESOURCE", "text", LEVEL_MAIN );
-		if ( status!=FIELDS_OK ) return BIBL_ERR_MEMERR;
-		status = fields_add( info, "ISSUANCE", "continuing", LEVEL_HOST );
-		if ( status!=FIELDS_OK ) return BIBL_ERR_MEMERR;
-		status = fields_add( info, "GENRE:MARC", "periodical", LEVEL_HOST );
-		if ( status!=FIELDS_OK ) return BIBL_ERR_MEMERR;
-		status = fields_add( info, "GENRE:BIBUTILS", "academic journal", LEVEL_HOST );
-		if ( status!=FIELDS_OK ) return BIBL_ERR_MEMERR;
-		status = BIBL_OK;
+	switch ( m->context[depth-1] ) {
+	case MEDIN_MEDLINECITATION:
+		if ( xml_tag_matches_has_value( node, "PMID" ) ) {
+			fstatus = fields_add( m->info, "PMID", xml_value_cstr( node ), LEVEL_MAIN );
+			if ( fstatus!=FIELDS_OK ) status = BIBL_ERR_MEMERR;
+		}
+		break;
+	case MEDIN_ARTICLE:
+		status = medin_article( node, medin_articleinfo( m ) );
+		break;
+	case MEDIN_PAGINATION:
+		status = medin_pagination( node, medin_articleinfo( m ) );
+		break;
+	case MEDIN_ABSTRACT:
+		if ( !m->abstract && xml_tag_matches_has_value( node, "AbstractText" ) ) {
+			m->abstract = 1;
+			status = medin_abstract( node, medin_articleinfo( m ) );
+		}
+		break;
+	case MEDIN_AUTHORLIST:
+		if ( m->context[depth]==MEDIN_AUTHOR )
+			status = medin_authorlist( &(m->name), &(m->corp), m->hascorp, medin_articleinfo( m ) );
+		break;
+	case MEDIN_AUTHOR:
+		status = medin_author( node, &(m->name) );
+		if ( !m->hascorp && xml_tag_matches( node, "CollectiveName" ) ) {
+			str_strcpy( &(m->corp), xml_value( node ) );
+			m->hascorp = 1;
+		}
+		break;
+	case MEDIN_JOURNALINFO:
+		status = medin_journal2( node, m->info );
+		break;
+	case MEDIN_MESHHEADING:
+		status = medin_meshheading( node, m->info );
+		break;
+	case MEDIN_ARTICLEIDLIST:
+		status = medin_pubmeddata( node, m->info );
+		break;
 	}
+	if ( status!=BIBL_OK ) return status;
 
-	return status;
+	if ( m->context[depth]==MEDIN_ARTICLE ) {
+		for ( i=0; i<fields_num( &(m->deferred) ); ++i ) {
+			fstatus = fields_add( m->info, fields_tag( &(m->deferred), i, FIELDS_CHRP_NOUSE ),
+			                      fields_value( &(m->deferred), i, FIELDS_CHRP_NOUSE ),
+			                      fields_level( &(m->deferred), i ) );
+			if ( fstatus!=FIELDS_OK ) return BIBL_ERR_MEMERR;
+		}
+		fields_free( &(m->deferred) );
+		m->article = 0;
+		m->journal = 0;
+	}
+
+	return BIBL_OK;
 }
 
 static int
 medin_processf( fields *medin, const char *data, const char *filename, long nref, param *p )
 {
-	int status;
-	xml top;
+	int status = BIBL_OK;
+	xml_sax h;
+	medin_sax m;
+
+	m.info     = medin;
+	m.ncontext = 16;
+	m.context  = ( int * ) malloc( sizeof( int ) * m.ncontext );
+	if ( !m.context ) return 0;
+	m.context[0] = MEDIN_TOP;
+	m.article  = 0;
+	m.journal  = 0;
+	m.abstract = 0;
+	m.hascorp  = 0;
+	fields_init( &(m.deferred) );
+	strs_init( &(m.name), &(m.corp), NULL );
+
+	h.start = medin_start;
+	h.end   = medin_end;
+	h.data  = &m;
+
+	if ( xml_sax_parse( data, &h )!=0 ) status = BIBL_ERR_MEMERR;
+
+	/* assume everything is a journal article */
+	if ( status==BIBL_OK && fields_num( medin ) ) {
+		if ( fields_add( medin, "RESOURCE", "text", LEVEL_MAIN )!=FIELDS_OK ||
+		     fields_add( medin, "ISSUANCE", "continuing", LEVEL_HOST )!=FIELDS_OK ||
+		     fields_add( medin, "GENRE:MARC", "periodical", LEVEL_HOST )!=FIELDS_OK ||
+		     fields_add( medin, "GENRE:BIBUTILS", "academic journal", LEVEL_HOST )!=FIELDS_OK )
+			status = BIBL_ERR_MEMERR;
+	}
 
-	xml_init( &top );
-	xml_parse( data, &top );
-	status = medin_assembleref( &top, medin );
-	xml_free( &top );
+	fields_free( &(m.deferred) );
+	strs_free( &(m.name), &(m.corp), NULL );
+	free( m.context );
 
 	if ( status==BIBL_OK ) return 1;
 	return 0;
@@ -15,6 +15,7 @@
 #include "str_conv.h"
 #include "xml.h"
 #include "xml_encoding.h"
+#include "xml_split.h"
 #include "fields.h"
 #include "name.h"
 #include "reftypes.h"
@@ -28,7 +29,7 @@
 #include "bibutils.h"
 #include "bibformats.h"
 
-static int modsin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset );
+static int modsin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm );
 static int modsin_processf( fields *medin, const char *data, const char *filename, long nref, param *p );
 
 /*****************************************************
@@ -128,17 +129,20 @@ out:
 	return status;
 }
 
-static int
-modsin_date( xml *node, fields *info, int level, int part )
+/* modsin_datestr()
+ *
+ * Georgi: the date "year-month-day" in p, as written by modsout.c, also
+ * used by the direct conversion (see modsout_direct())
+ */
+int
+modsin_datestr( const char *p, fields *info, int level, int part )
 {
 	int fstatus, status = BIBL_OK;
-	const char *tag, *p;
+	const char *tag;
 	str s;
 
 	str_init( &s );
 
-	p = xml_value_cstr( node );
-
 	if ( p ) {
 
 		p = str_cpytodelim( &s, skip_ws( p ), "-", 1 );
@@ -172,6 +176,12 @@ out:
 	return status;
 }
 
+static int
+modsin_date( xml *node, fields *info, int level, int part )
+{
+	return modsin_datestr( xml_value_cstr( node ), info, level, part );
+}
+
 static int
 modsin_pager( xml *node, str *sp, str *ep, str *tp, str *lp )
 {
@@ -298,8 +308,10 @@ out:
  *
  * Take input strings with roles separated by '|' characters, e.g.
  * "author" or "author|creator" or "edt" or "editor|edt".
+ *
+ * Georgi: also used by the direct conversion (see modsout_direct())
  */
-static int
+int
 modsin_marcrole_convert( str *s, char *suffix, str *out )
 {
 	int i, sstatus, status = BIBL_OK;
@@ -424,39 +436,18 @@ modsin_personr( xml *node, str *familyname, str *givenname, str *suffix )
 	return status;
 }
 
-static int
-modsin_person( xml *node, fields *info, int level )
+/* modsin_person_add()
+ *
+ * Georgi: the name from the parts of a personal name, as collected by
+ * modsin_person(), also used by the direct conversion (see modsout_direct())
+ */
+int
+modsin_person_add( str *familyname, str *givenname, str *suffix, str *roles, fields *info, int level )
 {
-	str familyname, givenname, name, suffix, roles, role_out;
 	int fstatus, status = BIBL_OK;
-	xml *dnode, *rnode;
-
-	dnode = node->down;
-	if ( !dnode ) return status;
-
-	strs_init( &name, &familyname, &givenname, &suffix, &roles, &role_out, NULL );
-
-	while ( dnode ) {
-
-		if ( xml_tag_matches( dnode, "namePart" ) ) {
-			status = modsin_personr( dnode, &familyname, &givenname, &suffix );
-			if ( status!=BIBL_OK ) goto out;
-		}
+	str name, role_out;
 
-		else if ( xml_tag_matches( dnode, "role" ) ) {
-			rnode = dnode->down;
-			while ( rnode ) {
-				if ( xml_tag_matches( rnode, "roleTerm" ) ) {
-					status = modsin_roler( rnode, &roles );
-					if ( status!=BIBL_OK ) goto out;
-				}
-				rnode = rnode->next;
-			}
-		}
-
-		dnode = dnode->next;
-
-	}
+	strs_init( &name, &role_out, NULL );
 
 	/*
 	 * Handle:
@@ -464,11 +455,11 @@ modsin_person( xml *node, fields *info, int level )
 	 *          <namePart type='family'>Smith</namePart>
 	 * without mangling the order of "Noah A."
 	 */
-	if ( str_has_value( &familyname ) ) {
-		str_strcpy( &name, &familyname );
-		if ( givenname.len ) {
+	if ( str_has_value( familyname ) ) {
+		str_strcpy( &name, familyname );
+		if ( givenname->len ) {
 			str_addchar( &name, '|' );
-			str_strcat( &name, &givenname );
+			str_strcat( &name, givenname );
 		}
 	}
 
@@ -478,13 +469,13 @@ modsin_person( xml *node, fields *info, int level )
 	 * with name order mangling.
 	 */
 	else {
-		if ( str_has_value( &givenname ) )
-			name_parse( &name, &givenname, NULL, NULL );
+		if ( str_has_value( givenname ) )
+			name_parse( &name, givenname, NULL, NULL );
 	}
 
-	if ( str_has_value( &suffix ) ) {
+	if ( str_has_value( suffix ) ) {
 		str_strcatc( &name, "||" );
-		str_strcat( &name, &suffix );
+		str_strcat( &name, suffix );
 	}
 
 	if ( str_memerr( &name ) ) {
@@ -492,14 +483,55 @@ modsin_person( xml *node, fields *info, int level )
 		goto out;
 	}
 
-	status = modsin_marcrole_convert( &roles, NULL, &role_out );
+	status = modsin_marcrole_convert( roles, NULL, &role_out );
 	if ( status!=BIBL_OK ) goto out;
 
 	fstatus = fields_add_can_dup( info, str_cstr( &role_out ), str_cstr( &name ), level );
 	if ( fstatus!=FIELDS_OK ) status = BIBL_ERR_MEMERR;
 
 out:
-	strs_free( &name, &familyname, &givenname, &suffix, &roles, &role_out, NULL );
+	strs_free( &name, &role_out, NULL );
+	return status;
+}
+
+static int
+modsin_person( xml *node, fields *info, int level )
+{
+	str familyname, givenname, suffix, roles;
+	int status = BIBL_OK;
+	xml *dnode, *rnode;
+
+	dnode = node->down;
+	if ( !dnode ) return status;
+
+	strs_init( &familyname, &givenname, &suffix, &roles, NULL );
+
+	while ( dnode ) {
+
+		if ( xml_tag_matches( dnode, "namePart" ) ) {
+			status = modsin_personr( dnode, &familyname, &givenname, &suffix );
+			if ( status!=BIBL_OK ) goto out;
+		}
+
+		else if ( xml_tag_matches( dnode, "role" ) ) {
+			rnode = dnode->down;
+			while ( rnode ) {
+				if ( xml_tag_matches( rnode, "roleTerm" ) ) {
+					status = modsin_roler( rnode, &roles );
+					if ( status!=BIBL_OK ) goto out;
+				}
+				rnode = rnode->next;
+			}
+		}
+
+		dnode = dnode->next;
+
+	}
+
+	status = modsin_person_add( &familyname, &givenname, &suffix, &roles, info, level );
+
+out:
+	strs_free( &familyname, &givenname, &suffix, &roles, NULL );
 	return status;
 }
 
@@ -702,16 +734,14 @@ modsin_id1( xml *node, fields *info, int level )
  * MARC authority terms tagged with "GENRE:MARC"
  * bibutils authority terms tagged with "GENRE:BIBUTILS"
  * unknown terms tagged with "GENRE:UNKNOWN"
+ *
+ * Georgi: modsin_genre_add() is also used by the direct conversion (see
+ * modsout_direct())
  */
-static int
-modsin_genre( xml *node, fields *info, int level )
+int
+modsin_genre_add( const char *d, fields *info, int level )
 {
 	int fstatus;
-	char *d;
-
-	if ( !xml_has_value( node ) ) return BIBL_OK;
-
-	d = xml_value_cstr( node );
 
 	/* ...handle special genres in KTH DivA */
 	if ( !strcmp( d, "conferenceProceedings" ) || !strcmp( d, "conferencePaper" ) )
@@ -740,6 +770,14 @@ modsin_genre( xml *node, fields *info, int level )
 	else return BIBL_OK;
 }
 
+static int
+modsin_genre( xml *node, fields *info, int level )
+{
+	if ( !xml_has_value( node ) ) return BIBL_OK;
+
+	return modsin_genre_add( xml_value_cstr( node ), info, level );
+}
+
 /* in MODS version 3.5
  * <languageTerm type="text">....</languageTerm>
  * <languageTerm type="code" authority="xxx">...</languageTerm>
@@ -957,35 +995,56 @@ modsin_recordinfo( xml *node, fields *info, int level )
 	return BIBL_OK;
 }
 
+static convert identifiers[] = {
+	{ "citekey",       "REFNUM",      0, 0 },
+	{ "issn",          "ISSN",        0, 0 },
+	{ "coden",         "CODEN",       0, 0 },
+	{ "isbn",          "ISBN",        0, 0 },
+	{ "doi",           "DOI",         0, 0 },
+	{ "url",           "URL",         0, 0 },
+	{ "uri",           "URL",         0, 0 },
+	{ "pmid",          "PMID",        0, 0 },
+	{ "pubmed",        "PMID",        0, 0 },
+	{ "medline",       "MEDLINE",     0, 0 },
+	{ "pmc",           "PMC",         0, 0 },
+	{ "arXiv",         "ARXIV",       0, 0 },
+	{ "MRnumber",      "MRNUMBER",    0, 0 },
+	{ "pii",           "PII",         0, 0 },
+	{ "isi",           "ISIREFNUM",   0, 0 },
+	{ "serial number", "SERIALNUMBER",0, 0 },
+	{ "accessnum",     "ACCESSNUM",   0, 0 },
+	{ "jstor",         "JSTOR",       0, 0 },
+	{ "eid",           "EID",         0, 0 },
+};
+static int nidentifiers = sizeof( identifiers ) / sizeof( identifiers[0] );
+
 static int
 modsin_identifier( xml *node, fields *info, int level )
 {
-	convert ids[] = {
-		{ "citekey",       "REFNUM",      0, 0 },
-		{ "issn",          "ISSN",        0, 0 },
-		{ "coden",         "CODEN",       0, 0 },
-		{ "isbn",          "ISBN",        0, 0 },
-		{ "doi",           "DOI",         0, 0 },
-		{ "url",           "URL",         0, 0 },
-		{ "uri",           "URL",         0, 0 },
-		{ "pmid",          "PMID",        0, 0 },
-		{ "pubmed",        "PMID",        0, 0 },
-		{ "medline",       "MEDLINE",     0, 0 },
-		{ "pmc",           "PMC",         0, 0 },
-		{ "arXiv",         "ARXIV",       0, 0 },
-		{ "MRnumber",      "MRNUMBER",    0, 0 },
-		{ "pii",           "PII",         0, 0 },
-		{ "isi",           "ISIREFNUM",   0, 0 },
-		{ "serial number", "SERIALNUMBER",0, 0 },
-		{ "accessnum",     "ACCESSNUM",   0, 0 },
-		{ "jstor",         "JSTOR",       0, 0 },
-		{ "eid",           "EID",         0, 0 },
-	};
-	int i, fstatus, n = sizeof( ids ) / sizeof( ids[0] );
+	int i, fstatus;
 	if ( node->value.len==0 ) return BIBL_OK;
-	for ( i=0; i<n; ++i ) {
-		if ( xml_tag_has_attribute( node, "identifier", "type", ids[i].mods ) ) {
-			fstatus = fields_add( info, ids[i].internal, xml_value_cstr( node ), level );
+	for ( i=0; i<nidentifiers; ++i ) {
+		if ( xml_tag_has_attribute( node, "identifier", "type", identifiers[i].mods ) ) {
+			fstatus = fields_add( info, identifiers[i].internal, xml_value_cstr( node ), level );
+			if ( fstatus!=FIELDS_OK ) return BIBL_ERR_MEMERR;
+		}
+	}
+	return BIBL_OK;
+}
+
+/* modsin_identifier_add()
+ *
+ * Georgi: as modsin_identifier() for <identifier type="type">value</identifier>,
+ * used by the direct conversion (see modsout_direct())
+ */
+int
+modsin_identifier_add( const char *type, const char *value, fields *info, int level )
+{
+	int i, fstatus;
+	if ( !value || !value[0] ) return BIBL_OK;
+	for ( i=0; i<nidentifiers; ++i ) {
+		if ( !strcasecmp( type, identifiers[i].mods ) ) {
+			fstatus = fields_add( info, identifiers[i].internal, value, level );
 			if ( fstatus!=FIELDS_OK ) return BIBL_ERR_MEMERR;
 		}
 	}
@@ -1092,6 +1151,7 @@ modsin_processf( fields *modsin, const char *data, const char *filename, long nr
 	xml top;
 
 	xml_init( &top );
+	top.pns = p->ctx->xml_pns; /* found by modsin_readf() */
 	xml_parse( data, &top );
 	status = modsin_assembleref( &top, modsin );
 	xml_free( &top );
@@ -1104,58 +1164,22 @@ modsin_processf( fields *modsin, const char *data, const char *filename, long nr
  PUBLIC: int modsin_readf()
 *****************************************************/
 
-static char *
-modsin_startptr( char *p, char **next )
-{
-	char *startptr;
-	*next = NULL;
-	startptr = xml_find_start( p, "mods:mods" );
-	if ( startptr ) {
-		/* set namespace if found */
-		xml_pns = modsns;
-		*next = startptr + 9;
-	} else {
-		startptr = xml_find_start( p, "mods" );
-		if ( startptr ) {
-			xml_pns = NULL;
-			*next = startptr + 5;
-		}
-	}
-	return startptr;
-}
-
-static char *
-modsin_endptr( char *p )
-{
-	return xml_find_end( p, "mods" );
-}
+/* Georgi: the record is found by xml_split_record(), which does not search
+ *         the text accumulated for a long record again after each line
+ */
+static char *modsin_tags[] = { "mods:mods", "mods" };
 
 static int
-modsin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset )
+modsin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm )
 {
-	str tmp;
-	int m, file_charset = CHARSET_UNKNOWN;
-	char *startptr = NULL, *nextptr, *endptr = NULL;
-
-	str_init( &tmp );
-
-	do {
-		if ( line->data ) str_strcat( &tmp, line );
-		if ( str_has_value( &tmp ) ) {
-			m = xml_getencoding( &tmp );
-			if ( m!=CHARSET_UNKNOWN ) file_charset = m;
-			startptr = modsin_startptr( tmp.data, &nextptr );
-			if ( nextptr ) endptr = modsin_endptr( nextptr );
-		} else startptr = endptr = NULL;
-		str_empty( line );
-		if ( startptr && endptr ) {
-			str_segcpy( reference, startptr, endptr );
-			str_strcpyc( line, endptr );
-		}
-	} while ( !endptr && str_fget( fp, buf, bufsize, bufpos, line ) );
+	int ntag;
+
+	if ( !xml_split_record( fr, modsin_tags, 2, XML_SPLIT_JOINLINES, reference, &ntag, fcharset ) )
+		return 0;
+
+	/* the namespace is used by modsin_processf() for this reference */
+	pm->ctx->xml_pns = ( ntag==0 ) ? modsns : NULL;
 
-	str_free( &tmp );
-	*fcharset = file_charset;
 	return ( reference->len > 0 );
 }
 
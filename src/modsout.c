@@ -13,6 +13,7 @@
 #include <string.h>
 #include "is_ws.h"
 #include "str.h"
+#include "slist.h"
 #include "charsets.h"
 #include "str_conv.h"
 #include "fields.h"
@@ -21,6 +22,7 @@
 #include "modstypes.h"
 #include "bu_auth.h"
 #include "marc_auth.h"
+#include "url.h"
 #include "bibformats.h"
 
 /*****************************************************
@@ -185,23 +187,33 @@ incr_level( int level, int amt )
 /* convert_findallfields()
  *
  *       Find the positions of all convert.internal tags in the fields
- *       structure and store the locations in convert.pos element.
+ *       structure and store the locations in pos[].
  *
  *       Return number of the tags found.
+ *
+ * Georgi: the tables are shared with modsout_direct(), which can run on
+ *         several threads, so the positions are not stored in convert.pos
  */
 static int
-convert_findallfields( fields *f, convert *parts, int nparts, int level )
+convert_findallfields( fields *f, convert *parts, int nparts, int level, int pos[] )
 {
 	int i, n = 0;
 
 	for ( i=0; i<nparts; ++i ) {
-		parts[i].pos = fields_find( f, parts[i].internal, level );
-		n += ( parts[i].pos!=FIELDS_NOTFOUND );
+		pos[i] = fields_find( f, parts[i].internal, level );
+		n += ( pos[i]!=FIELDS_NOTFOUND );
 	}
 
 	return n;
 }
 
+static int
+shorttitle_differs( fields *f, int ttl, int subttl, int shrttl )
+{
+	if ( ttl==FIELDS_NOTFOUND || subttl!=FIELDS_NOTFOUND ) return 1;
+	return strcmp( fields_value( f, ttl, FIELDS_CHRP ), fields_value( f, shrttl, FIELDS_CHRP ) )!=0;
+}
+
 static void
 output_title( fields *f, FILE *outptr, int level )
 {
@@ -223,7 +235,7 @@ output_title( fields *f, FILE *outptr, int level )
 	/* output shorttitle if it's different from normal title */
 	if ( shrttl!=FIELDS_NOTFOUND ) {
 		val = (char *) fields_value( f, shrttl, FIELDS_CHRP );
-		if ( ttl==FIELDS_NOTFOUND || subttl!=FIELDS_NOTFOUND || strcmp(fields_value(f,ttl,FIELDS_CHRP),val) ) {
+		if ( shorttitle_differs( f, ttl, subttl, shrttl ) ) {
 			output_tag( outptr, lvl2indent(level),               "titleInfo", NULL, TAG_OPEN,      TAG_NEWLINE, "type", "abbreviated", NULL );
 			output_tag( outptr, lvl2indent(incr_level(level,1)), "title",     val,  TAG_OPENCLOSE, TAG_NEWLINE, NULL );
 			output_tag( outptr, lvl2indent(level),               "titleInfo", NULL, TAG_CLOSE,     TAG_NEWLINE, NULL );
@@ -231,14 +243,19 @@ output_title( fields *f, FILE *outptr, int level )
 	}
 }
 
-static void
-output_name( FILE *outptr, char *p, int level )
+/* name_parts()
+ *
+ *       Split a name "family|given1|given2||suffix" into the parts written
+ *       by output_name().
+ */
+static int
+name_parts( const char *p, str *family, slist *given, str *suffix )
 {
-	str family, part, suffix;
-	int n=0;
+	int status = BIBL_OK;
+	str part;
 
-	strs_init( &family, &part, &suffix, NULL );
-	while ( *p && *p!='|' ) str_addchar( &family, *p++ );
+	str_init( &part );
+	while ( *p && *p!='|' ) str_addchar( family, *p++ );
 	if ( *p=='|' ) p++;
 
 	while ( *p ) {
@@ -249,21 +266,46 @@ output_name( FILE *outptr, char *p, int level )
 				part.len=1;
 				part.data[1]='\0';
 			}
-			if ( n==0 )
-				output_tag( outptr, lvl2indent(level), "name", NULL, TAG_OPEN, TAG_NEWLINE, "type", "personal", NULL );
-			output_tag( outptr, lvl2indent(incr_level(level,1)), "namePart", part.data, TAG_OPENCLOSE, TAG_NEWLINE, "type", "given", NULL );
-			n++;
+			if ( slist_add( given, &part )!=SLIST_OK ) {
+				status = BIBL_ERR_MEMERR;
+				goto out;
+			}
 		}
 		if ( *p=='|' ) {
 			p++;
 			if ( *p=='|' ) {
 				p++;
-				while ( *p && *p!='|' ) str_addchar( &suffix, *p++ );
+				while ( *p && *p!='|' ) str_addchar( suffix, *p++ );
 			}
 			str_empty( &part );
 		}
 	}
 
+	if ( str_memerr( family ) || str_memerr( suffix ) || str_memerr( &part ) )
+		status = BIBL_ERR_MEMERR;
+out:
+	str_free( &part );
+	return status;
+}
+
+static void
+output_name( FILE *outptr, char *p, int level )
+{
+	str family, suffix;
+	slist given;
+	int i, n=0;
+
+	strs_init( &family, &suffix, NULL );
+	slist_init( &given );
+	(void) name_parts( p, &family, &given, &suffix );
+
+	for ( i=0; i<given.n; ++i ) {
+		if ( n==0 )
+			output_tag( outptr, lvl2indent(level), "name", NULL, TAG_OPEN, TAG_NEWLINE, "type", "personal", NULL );
+		output_tag( outptr, lvl2indent(incr_level(level,1)), "namePart", slist_cstr( &given, i ), TAG_OPENCLOSE, TAG_NEWLINE, "type", "given", NULL );
+		n++;
+	}
+
 	if ( family.len ) {
 		if ( n==0 )
 			output_tag( outptr, lvl2indent(level), "name", NULL, TAG_OPEN, TAG_NEWLINE, "type", "personal", NULL );
@@ -277,7 +319,8 @@ output_name( FILE *outptr, char *p, int level )
 		output_tag( outptr, lvl2indent(incr_level(level,1)), "namePart", suffix.data, TAG_OPENCLOSE, TAG_NEWLINE, "type", "suffix", NULL );
 	}
 
-	strs_free( &part, &family, &suffix, NULL );
+	strs_free( &family, &suffix, NULL );
+	slist_free( &given );
 }
 
 
@@ -294,78 +337,37 @@ output_name( FILE *outptr, char *p, int level )
  * </name>
  */
 
-#define NO_AUTHORITY (0)
-#define MARC_AUTHORITY (1)
-
 static void
 output_names( fields *f, FILE *outptr, int level )
 {
-	convert   names[] = {
-	  { "author",                              "AUTHOR",          0, MARC_AUTHORITY },
-	  { "editor",                              "EDITOR",          0, MARC_AUTHORITY },
-	  { "annotator",                           "ANNOTATOR",       0, MARC_AUTHORITY },
-	  { "artist",                              "ARTIST",          0, MARC_AUTHORITY },
-	  { "author",                              "2ND_AUTHOR",      0, MARC_AUTHORITY },
-	  { "author",                              "3RD_AUTHOR",      0, MARC_AUTHORITY },
-	  { "author",                              "SUB_AUTHOR",      0, MARC_AUTHORITY },
-	  { "author",                              "COMMITTEE",       0, MARC_AUTHORITY },
-	  { "author",                              "COURT",           0, MARC_AUTHORITY },
-	  { "author",                              "LEGISLATIVEBODY", 0, MARC_AUTHORITY },
-	  { "author of afterword, colophon, etc.", "AFTERAUTHOR",     0, MARC_AUTHORITY },
-	  { "author of introduction, etc.",        "INTROAUTHOR",     0, MARC_AUTHORITY },
-	  { "cartographer",                        "CARTOGRAPHER",    0, MARC_AUTHORITY },
-	  { "collaborator",                        "COLLABORATOR",    0, MARC_AUTHORITY },
-	  { "commentator",                         "COMMENTATOR",     0, MARC_AUTHORITY },
-	  { "compiler",                            "COMPILER",        0, MARC_AUTHORITY },
-	  { "degree grantor",                      "DEGREEGRANTOR",   0, MARC_AUTHORITY },
-	  { "director",                            "DIRECTOR",        0, MARC_AUTHORITY },
-	  { "event",                               "EVENT",           0, NO_AUTHORITY   },
-	  { "inventor",                            "INVENTOR",        0, MARC_AUTHORITY },
-	  { "organizer of meeting",                "ORGANIZER",       0, MARC_AUTHORITY },
-	  { "patent holder",                       "ASSIGNEE",        0, MARC_AUTHORITY },
-	  { "performer",                           "PERFORMER",       0, MARC_AUTHORITY },
-	  { "producer",                            "PRODUCER",        0, MARC_AUTHORITY },
-	  { "addressee",                           "ADDRESSEE",       0, MARC_AUTHORITY },
-	  { "redactor",                            "REDACTOR",        0, MARC_AUTHORITY },
-	  { "reporter",                            "REPORTER",        0, MARC_AUTHORITY },
-	  { "sponsor",                             "SPONSOR",         0, MARC_AUTHORITY },
-	  { "translator",                          "TRANSLATOR",      0, MARC_AUTHORITY },
-	  { "writer",                              "WRITER",          0, MARC_AUTHORITY },
-	};
-	int i, n, nfields, ntypes = sizeof( names ) / sizeof( convert );
-	int f_asis, f_corp, f_conf;
+	int i, n, nfields, flags;
 	str role;
 
 	str_init( &role );
 	nfields = fields_num( f );
-	for ( n=0; n<ntypes; ++n ) {
+	for ( n=0; n<nmods_names; ++n ) {
 		for ( i=0; i<nfields; ++i ) {
 			if ( fields_level( f, i )!=level ) continue;
 			if ( fields_no_value( f, i ) ) continue;
-			f_asis = f_corp = f_conf = 0;
-			str_strcpyc( &role, f->tag[i].data );
-			if ( str_findreplace( &role, ":ASIS", "" )) f_asis=1;
-			if ( str_findreplace( &role, ":CORP", "" )) f_corp=1;
-			if ( str_findreplace( &role, ":CONF", "" )) f_conf=1;
-			if ( strcasecmp( role.data, names[n].internal ) )
+			if ( mods_find_name( fields_tag( f, i, FIELDS_CHRP_NOUSE ), &role, &flags )!=n )
 				continue;
-			if ( f_asis ) {
+			if ( flags & MODS_NAME_ASIS ) {
 				output_tag( outptr, lvl2indent(level),               "name",     NULL, TAG_OPEN,      TAG_NEWLINE, NULL );
 				output_fil( outptr, lvl2indent(incr_level(level,1)), "namePart", f, i, TAG_OPENCLOSE, TAG_NEWLINE, NULL );
-			} else if ( f_corp ) {
+			} else if ( flags & MODS_NAME_CORP ) {
 				output_tag( outptr, lvl2indent(level),               "name",     NULL, TAG_OPEN,      TAG_NEWLINE, "type", "corporate", NULL );
 				output_fil( outptr, lvl2indent(incr_level(level,1)), "namePart", f, i, TAG_OPENCLOSE, TAG_NEWLINE, NULL );
-			} else if ( f_conf ) {
+			} else if ( flags & MODS_NAME_CONF ) {
 				output_tag( outptr, lvl2indent(level),               "name",     NULL, TAG_OPEN,      TAG_NEWLINE, "type", "conference", NULL );
 				output_fil( outptr, lvl2indent(incr_level(level,1)), "namePart", f, i, TAG_OPENCLOSE, TAG_NEWLINE, NULL );
 			} else {
 				output_name(outptr, fields_value( f, i, FIELDS_CHRP ), level);
 			}
 			output_tag( outptr, lvl2indent(incr_level(level,1)), "role", NULL, TAG_OPEN, TAG_NEWLINE, NULL );
-			if ( names[n].code & MARC_AUTHORITY )
-				output_tag( outptr, lvl2indent(incr_level(level,2)), "roleTerm", names[n].mods, TAG_OPENCLOSE, TAG_NEWLINE, "authority", "marcrelator", "type", "text", NULL );
+			if ( mods_names[n].code & MODS_MARC_AUTHORITY )
+				output_tag( outptr, lvl2indent(incr_level(level,2)), "roleTerm", mods_names[n].mods, TAG_OPENCLOSE, TAG_NEWLINE, "authority", "marcrelator", "type", "text", NULL );
 			else
-				output_tag( outptr, lvl2indent(incr_level(level,2)), "roleTerm", names[n].mods, TAG_OPENCLOSE, TAG_NEWLINE, "type", "text", NULL );
+				output_tag( outptr, lvl2indent(incr_level(level,2)), "roleTerm", mods_names[n].mods, TAG_OPENCLOSE, TAG_NEWLINE, "type", "text", NULL );
 			output_tag( outptr, lvl2indent(incr_level(level,1)), "role", NULL, TAG_CLOSE, TAG_NEWLINE, NULL );
 			output_tag( outptr, lvl2indent(level),               "name", NULL, TAG_CLOSE, TAG_NEWLINE, NULL );
 			fields_set_used( f, i );
@@ -434,53 +436,78 @@ find_dateinfo( fields *f, int level, int datepos[ NUM_DATE_TYPES ] )
 	return found;
 }
 
-static void
-output_datepieces( fields *f, FILE *outptr, int pos[ NUM_DATE_TYPES ] )
+static int
+datepieces( fields *f, int pos[ NUM_DATE_TYPES ], str *date )
 {
 	str *s;
 	int i;
 
 	for ( i=0; i<3 && pos[i]!=-1; ++i ) {
-		if ( i>0 ) fprintf( outptr, "-" );
+		if ( i>0 ) str_addchar( date, '-' );
 		/* zero pad month or days written as "1", "2", "3" ... */
 		if ( i==DATE_MONTH || i==DATE_DAY ) {
 			s = fields_value( f, pos[i], FIELDS_STRP_NOUSE );
 			if ( s->len==1 ) {
-				fprintf( outptr, "0" );
+				str_addchar( date, '0' );
 			}
 		}
-		fprintf( outptr, "%s", (char *) fields_value( f, pos[i], FIELDS_CHRP ) );
+		str_strcatc( date, (char *) fields_value( f, pos[i], FIELDS_CHRP ) );
 	}
+
+	if ( str_memerr( date ) ) return BIBL_ERR_MEMERR;
+	return BIBL_OK;
+}
+
+/* dateissued()
+ *
+ *      the contents of <dateIssued>
+ */
+static int
+dateissued( fields *f, int pos[ NUM_DATE_TYPES ], str *date )
+{
+	str_empty( date );
+	if ( pos[ DATE_YEAR ]!=-1 || pos[ DATE_MONTH ]!=-1 || pos[ DATE_DAY ]!=-1 )
+		return datepieces( f, pos, date );
+
+	str_strcpyc( date, (char *) fields_value( f, pos[ DATE_ALL ], FIELDS_CHRP ) );
+	if ( str_memerr( date ) ) return BIBL_ERR_MEMERR;
+	return BIBL_OK;
 }
 
 static void
 output_dateissued( fields *f, FILE *outptr, int level, int pos[ NUM_DATE_TYPES ] )
 {
+	str date;
+
+	str_init( &date );
 	output_tag( outptr, lvl2indent(incr_level(level,1)), "dateIssued", NULL, TAG_OPEN, TAG_NONEWLINE, NULL );
-	if ( pos[ DATE_YEAR ]!=-1 || pos[ DATE_MONTH ]!=-1 || pos[ DATE_DAY ]!=-1 ) {
-		output_datepieces( f, outptr, pos );
-	} else {
-		fprintf( outptr, "%s", (char *) fields_value( f, pos[ DATE_ALL ], FIELDS_CHRP ) );
-	}
+	if ( dateissued( f, pos, &date )==BIBL_OK && date.len )
+		fprintf( outptr, "%s", str_cstr( &date ) );
 	fprintf( outptr, "</dateIssued>\n" );
+	str_free( &date );
 }
 
+static convert origin_parts[] = {
+	{ "issuance",	  "ISSUANCE",          0, 0 },
+	{ "publisher",	  "PUBLISHER",         0, 0 },
+	{ "place",	  "ADDRESS",           0, 1 },
+	{ "place",        "ADDRESS:PUBLISHER", 0, 0 },
+	{ "place",	  "ADDRESS:AUTHOR",    0, 0 },
+	{ "edition",	  "EDITION",           0, 0 },
+	{ "dateCaptured", "URLDATE",           0, 0 }
+};
+static int norigin_parts = sizeof( origin_parts ) / sizeof( origin_parts[0] );
+
+#define MAX_PARTS (32)
+
 static void
 output_origin( fields *f, FILE *outptr, int level )
 {
-	convert parts[] = {
-		{ "issuance",	  "ISSUANCE",          0, 0 },
-		{ "publisher",	  "PUBLISHER",         0, 0 },
-		{ "place",	  "ADDRESS",           0, 1 },
-		{ "place",        "ADDRESS:PUBLISHER", 0, 0 },
-		{ "place",	  "ADDRESS:AUTHOR",    0, 0 },
-		{ "edition",	  "EDITION",           0, 0 },
-		{ "dateCaptured", "URLDATE",           0, 0 }
-	};
-	int nparts = sizeof( parts ) / sizeof( parts[0] );
-	int i, found, datefound, datepos[ NUM_DATE_TYPES ];
-
-	found     = convert_findallfields( f, parts, nparts, level );
+	convert *parts = origin_parts;
+	int nparts = norigin_parts;
+	int i, found, datefound, datepos[ NUM_DATE_TYPES ], pos[ MAX_PARTS ];
+
+	found     = convert_findallfields( f, parts, nparts, level, pos );
 	datefound = find_dateinfo( f, level, datepos );
 	if ( !found && !datefound ) return;
 
@@ -488,8 +515,8 @@ output_origin( fields *f, FILE *outptr, int level )
 	output_tag( outptr, lvl2indent(level), "originInfo", NULL, TAG_OPEN, TAG_NEWLINE, NULL );
 
 	/* issuance must precede date */
-	if ( parts[0].pos!=-1 )
-		output_fil( outptr, lvl2indent(incr_level(level,1)), "issuance", f, parts[0].pos, TAG_OPENCLOSE, TAG_NEWLINE, NULL );
+	if ( pos[0]!=-1 )
+		output_fil( outptr, lvl2indent(incr_level(level,1)), "issuance", f, pos[0], TAG_OPENCLOSE, TAG_NEWLINE, NULL );
 
 	/* date */
 	if ( datefound )
@@ -499,17 +526,17 @@ output_origin( fields *f, FILE *outptr, int level )
 	for ( i=1; i<nparts; i++ ) {
 
 		/* skip missing originInfo elements */
-		if ( parts[i].pos==-1 ) continue;
+		if ( pos[i]==-1 ) continue;
 
 		/* normal originInfo element */
 		if ( parts[i].code==0 ) {
-			output_fil( outptr, lvl2indent(incr_level(level,1)), parts[i].mods, f, parts[i].pos, TAG_OPENCLOSE, TAG_NEWLINE, NULL );
+			output_fil( outptr, lvl2indent(incr_level(level,1)), parts[i].mods, f, pos[i], TAG_OPENCLOSE, TAG_NEWLINE, NULL );
 		}
 
 		/* originInfo with placeTerm info */
 		else {
-			output_tag( outptr, lvl2indent(incr_level(level,1)), parts[i].mods, NULL,            TAG_OPEN,      TAG_NEWLINE, NULL );
-			output_fil( outptr, lvl2indent(incr_level(level,2)), "placeTerm",   f, parts[i].pos, TAG_OPENCLOSE, TAG_NEWLINE, "type", "text", NULL );
+			output_tag( outptr, lvl2indent(incr_level(level,1)), parts[i].mods, NULL,      TAG_OPEN,      TAG_NEWLINE, NULL );
+			output_fil( outptr, lvl2indent(incr_level(level,2)), "placeTerm",   f, pos[i], TAG_OPENCLOSE, TAG_NEWLINE, "type", "text", NULL );
 			output_tag( outptr, lvl2indent(incr_level(level,1)), parts[i].mods, NULL,            TAG_CLOSE,     TAG_NEWLINE, NULL );
 		}
 	}
@@ -649,105 +676,132 @@ try_output_partfooter( FILE *outptr, int wrote_header, int level )
  * <date>xxxx-xx-xx</date>
  *
  */
+static convert partdate_parts[] = {
+	{ "",	"PARTDATE:YEAR",           0, 0 },
+	{ "",	"PARTDATE:MONTH",          0, 0 },
+	{ "",	"PARTDATE:DAY",            0, 0 },
+};
+static int npartdate_parts = sizeof( partdate_parts ) / sizeof( partdate_parts[0] );
+
+/* partdate()
+ *
+ *      the contents of <date> in <part>
+ */
+static int
+partdate( fields *f, int pos[], str *date )
+{
+	str_empty( date );
+
+	if ( pos[0]!=-1 ) {
+		str_strcatc( date, (char *) fields_value( f, pos[0], FIELDS_CHRP ) );
+	} else str_strcatc( date, "XXXX" );
+
+	if ( pos[1]!=-1 ) {
+		str_addchar( date, '-' );
+		str_strcatc( date, (char *) fields_value( f, pos[1], FIELDS_CHRP ) );
+	}
+
+	if ( pos[2]!=-1 ) {
+		if ( pos[1]==-1 )
+			str_strcatc( date, "-XX" );
+		str_addchar( date, '-' );
+		str_strcatc( date, (char *) fields_value( f, pos[2], FIELDS_CHRP ) );
+	}
+
+	if ( str_memerr( date ) ) return BIBL_ERR_MEMERR;
+	return BIBL_OK;
+}
+
 static int
 output_partdate( fields *f, FILE *outptr, int level, int wrote_header )
 {
-	convert parts[] = {
-		{ "",	"PARTDATE:YEAR",           0, 0 },
-		{ "",	"PARTDATE:MONTH",          0, 0 },
-		{ "",	"PARTDATE:DAY",            0, 0 },
-	};
-	int nparts = sizeof(parts)/sizeof(parts[0]);
+	int pos[ MAX_PARTS ];
+	str date;
 
-	if ( !convert_findallfields( f, parts, nparts, level ) ) return 0;
+	if ( !convert_findallfields( f, partdate_parts, npartdate_parts, level, pos ) ) return 0;
 
 	try_output_partheader( outptr, wrote_header, level );
 
 	output_tag( outptr, lvl2indent(incr_level(level,1)), "date", NULL, TAG_OPEN, TAG_NONEWLINE, NULL );
 
-	if ( parts[0].pos!=-1 ) {
-		fprintf( outptr, "%s", (char *) fields_value( f, parts[0].pos, FIELDS_CHRP ) );
-	} else fprintf( outptr, "XXXX" );
-
-	if ( parts[1].pos!=-1 ) {
-		fprintf( outptr, "-%s", (char *) fields_value( f, parts[1].pos, FIELDS_CHRP ) );
-	}
-
-	if ( parts[2].pos!=-1 ) {
-		if ( parts[1].pos==-1 )
-			fprintf( outptr, "-XX" );
-		fprintf( outptr, "-%s", (char *) fields_value( f, parts[2].pos, FIELDS_CHRP ) );
-	}
+	str_init( &date );
+	if ( partdate( f, pos, &date )==BIBL_OK )
+		fprintf( outptr, "%s", str_cstr( &date ) );
+	str_free( &date );
 
 	fprintf( outptr,"</date>\n");
 
 	return 1;
 }
 
+static convert pages_parts[] = {
+	{ "",  "PAGES:START",              0, 0 },
+	{ "",  "PAGES:STOP",               0, 0 },
+	{ "",  "PAGES",                    0, 0 },
+	{ "",  "PAGES:TOTAL",              0, 0 }
+};
+static int npages_parts = sizeof( pages_parts ) / sizeof( pages_parts[0] );
+
 static int
 output_partpages( fields *f, FILE *outptr, int level, int wrote_header )
 {
-	convert parts[] = {
-		{ "",  "PAGES:START",              0, 0 },
-		{ "",  "PAGES:STOP",               0, 0 },
-		{ "",  "PAGES",                    0, 0 },
-		{ "",  "PAGES:TOTAL",              0, 0 }
-	};
-	int nparts = sizeof(parts)/sizeof(parts[0]);
+	int pos[ MAX_PARTS ];
 
-	if ( !convert_findallfields( f, parts, nparts, level ) ) return 0;
+	if ( !convert_findallfields( f, pages_parts, npages_parts, level, pos ) ) return 0;
 
 	try_output_partheader( outptr, wrote_header, level );
 
 	/* If PAGES:START or PAGES:STOP are undefined */
-	if ( parts[0].pos==-1 || parts[1].pos==-1 ) {
-		if ( parts[0].pos!=-1 )
-			mods_output_detail( f, outptr, parts[0].pos, "page", level );
-		if ( parts[1].pos!=-1 )
-			mods_output_detail( f, outptr, parts[1].pos, "page", level );
-		if ( parts[2].pos!=-1 )
-			mods_output_detail( f, outptr, parts[2].pos, "page", level );
-		if ( parts[3].pos!=-1 )
-			mods_output_extents( f, outptr, -1, -1, parts[3].pos, "page", level );
+	if ( pos[0]==-1 || pos[1]==-1 ) {
+		if ( pos[0]!=-1 )
+			mods_output_detail( f, outptr, pos[0], "page", level );
+		if ( pos[1]!=-1 )
+			mods_output_detail( f, outptr, pos[1], "page", level );
+		if ( pos[2]!=-1 )
+			mods_output_detail( f, outptr, pos[2], "page", level );
+		if ( pos[3]!=-1 )
+			mods_output_extents( f, outptr, -1, -1, pos[3], "page", level );
 	}
 	/* If both PAGES:START and PAGES:STOP are defined */
 	else {
-		mods_output_extents( f, outptr, parts[0].pos, parts[1].pos, parts[3].pos, "page", level );
+		mods_output_extents( f, outptr, pos[0], pos[1], pos[3], "page", level );
 	}
 
 	return 1;
 }
 
+static convert element_parts[] = {
+	{ "",                "NUMVOLUMES",      0, 0 },
+	{ "volume",          "VOLUME",          0, 0 },
+	{ "section",         "SECTION",         0, 0 },
+	{ "issue",           "ISSUE",           0, 0 },
+	{ "number",          "NUMBER",          0, 0 },
+	{ "publiclawnumber", "PUBLICLAWNUMBER", 0, 0 },
+	{ "session",         "SESSION",         0, 0 },
+	{ "articlenumber",   "ARTICLENUMBER",   0, 0 },
+	{ "part",            "PART",            0, 0 },
+	{ "chapter",         "CHAPTER",         0, 0 },
+	{ "report number",   "REPORTNUMBER",    0, 0 },
+};
+static int nelement_parts = sizeof( element_parts ) / sizeof( element_parts[0] );
+
 static int
 output_partelement( fields *f, FILE *outptr, int level, int wrote_header )
 {
-	convert parts[] = {
-		{ "",                "NUMVOLUMES",      0, 0 },
-		{ "volume",          "VOLUME",          0, 0 },
-		{ "section",         "SECTION",         0, 0 },
-		{ "issue",           "ISSUE",           0, 0 },
-		{ "number",          "NUMBER",          0, 0 },
-		{ "publiclawnumber", "PUBLICLAWNUMBER", 0, 0 },
-		{ "session",         "SESSION",         0, 0 },
-		{ "articlenumber",   "ARTICLENUMBER",   0, 0 },
-		{ "part",            "PART",            0, 0 },
-		{ "chapter",         "CHAPTER",         0, 0 },
-		{ "report number",   "REPORTNUMBER",    0, 0 },
-	};
-	int i, nparts = sizeof( parts ) / sizeof( convert );
-
-	if ( !convert_findallfields( f, parts, nparts, level ) ) return 0;
+	int i, pos[ MAX_PARTS ];
+
+	if ( !convert_findallfields( f, element_parts, nelement_parts, level, pos ) ) return 0;
 
 	try_output_partheader( outptr, wrote_header, level );
 
 	/* start loop at 1 to skip NUMVOLUMES */
-	for ( i=1; i<nparts; ++i ) {
-		if ( parts[i].pos==-1 ) continue;
-		mods_output_detail( f, outptr, parts[i].pos, parts[i].mods, level );
+	for ( i=1; i<nelement_parts; ++i ) {
+		if ( pos[i]==-1 ) continue;
+		mods_output_detail( f, outptr, pos[i], element_parts[i].mods, level );
 	}
 
-	if ( parts[0].pos!=-1 )
-		mods_output_extents( f, outptr, -1, -1, parts[0].pos, "volumes", level );
+	if ( pos[0]!=-1 )
+		mods_output_extents( f, outptr, -1, -1, pos[0], "volumes", level );
 
 	return 1;
 }
@@ -890,12 +944,12 @@ output_key( fields *f, FILE *outptr, int level )
 	n = fields_num( f );
 	for ( i=0; i<n; ++i ) {
 		if ( fields_level( f, i ) != level ) continue;
-		if ( !strcasecmp( f->tag[i].data, "KEYWORD" ) ) {
+		if ( fields_match_casetag( f, i, "KEYWORD" ) ) {
 			output_tag( outptr, lvl2indent(level),               "subject", NULL, TAG_OPEN,      TAG_NEWLINE, NULL );
 			output_fil( outptr, lvl2indent(incr_level(level,1)), "topic",   f, i, TAG_OPENCLOSE, TAG_NEWLINE, NULL );
 			output_tag( outptr, lvl2indent(level),               "subject", NULL, TAG_CLOSE,     TAG_NEWLINE, NULL );
 		}
-		else if ( !strcasecmp( f->tag[i].data, "EPRINTCLASS" ) ) {
+		else if ( fields_match_casetag( f, i, "EPRINTCLASS" ) ) {
 			output_tag( outptr, lvl2indent(level),               "subject", NULL, TAG_OPEN,      TAG_NEWLINE, NULL );
 			output_fil( outptr, lvl2indent(incr_level(level,1)), "topic",   f, i, TAG_OPENCLOSE, TAG_NEWLINE, "class", "primary", NULL );
 			output_tag( outptr, lvl2indent(level),               "subject", NULL, TAG_CLOSE,     TAG_NEWLINE, NULL );
@@ -903,44 +957,45 @@ output_key( fields *f, FILE *outptr, int level )
 	}
 }
 
+static convert sn_types[] = {
+	{ "isbn",      "ISBN",      0, 0 },
+	{ "isbn",      "ISBN13",    0, 0 },
+	{ "lccn",      "LCCN",      0, 0 },
+	{ "issn",      "ISSN",      0, 0 },
+	{ "coden",     "CODEN",     0, 0 },
+	{ "citekey",   "REFNUM",    0, 0 },
+	{ "doi",       "DOI",       0, 0 },
+	{ "eid",       "EID",       0, 0 },
+	{ "eprint",    "EPRINT",    0, 0 },
+	{ "eprinttype","EPRINTTYPE",0, 0 },
+	{ "pubmed",    "PMID",      0, 0 },
+	{ "MRnumber",  "MRNUMBER",  0, 0 },
+	{ "medline",   "MEDLINE",   0, 0 },
+	{ "pii",       "PII",       0, 0 },
+	{ "pmc",       "PMC",       0, 0 },
+	{ "arXiv",     "ARXIV",     0, 0 },
+	{ "isi",       "ISIREFNUM", 0, 0 },
+	{ "accessnum", "ACCESSNUM", 0, 0 },
+	{ "jstor",     "JSTOR",     0, 0 },
+	{ "isrn",      "ISRN",      0, 0 },
+};
+static int nsn_types = sizeof( sn_types ) / sizeof( sn_types[0] );
+
 static void
 output_sn( fields *f, FILE *outptr, int level )
 {
-	convert sn_types[] = {
-		{ "isbn",      "ISBN",      0, 0 },
-		{ "isbn",      "ISBN13",    0, 0 },
-		{ "lccn",      "LCCN",      0, 0 },
-		{ "issn",      "ISSN",      0, 0 },
-		{ "coden",     "CODEN",     0, 0 },
-		{ "citekey",   "REFNUM",    0, 0 },
-		{ "doi",       "DOI",       0, 0 },
-		{ "eid",       "EID",       0, 0 },
-		{ "eprint",    "EPRINT",    0, 0 },
-		{ "eprinttype","EPRINTTYPE",0, 0 },
-		{ "pubmed",    "PMID",      0, 0 },
-		{ "MRnumber",  "MRNUMBER",  0, 0 },
-		{ "medline",   "MEDLINE",   0, 0 },
-		{ "pii",       "PII",       0, 0 },
-		{ "pmc",       "PMC",       0, 0 },
-		{ "arXiv",     "ARXIV",     0, 0 },
-		{ "isi",       "ISIREFNUM", 0, 0 },
-		{ "accessnum", "ACCESSNUM", 0, 0 },
-		{ "jstor",     "JSTOR",     0, 0 },
-		{ "isrn",      "ISRN",      0, 0 },
-	};
-	int ntypes = sizeof( sn_types ) / sizeof( sn_types[0] );
-	int i, n, found;
+	int i, n, found, pos[ MAX_PARTS ];
 
 	/* output call number */
 	n = fields_find( f, "CALLNUMBER", level );
 	output_fil( outptr, lvl2indent(level), "classification", f, n, TAG_OPENCLOSE, TAG_NEWLINE, NULL );
 
 	/* output specialized serialnumber */
-	found = convert_findallfields( f, sn_types, ntypes, level );
+	found = convert_findallfields( f, sn_types, nsn_types, level, pos );
 	if ( found ) {
-		for ( i=0; i<ntypes; ++i ) {
-			if ( sn_types[i].pos==-1 ) continue;
-			output_fil( outptr, lvl2indent(level), "identifier", f, sn_types[i].pos, TAG_OPENCLOSE, TAG_NEWLINE, "type", sn_types[i].mods, NULL );
+		for ( i=0; i<nsn_types; ++i ) {
+			if ( pos[i]==-1 ) continue;
+			output_fil( outptr, lvl2indent(level), "identifier", f, pos[i], TAG_OPENCLOSE, TAG_NEWLINE, "type", sn_types[i].mods, NULL );
 		}
 	}
 
@@ -948,7 +1003,7 @@ output_sn( fields *f, FILE *outptr, int level )
 	n = fields_num( f );
 	for ( i=0; i<n; ++i ) {
 		if ( f->level[i]!=level ) continue;
-		if ( strcasecmp( f->tag[i].data, "SERIALNUMBER" ) ) continue;
+		if ( !fields_match_casetag( f, i, "SERIALNUMBER" ) ) continue;
 		output_fil( outptr, lvl2indent(level), "identifier", f, i, TAG_OPENCLOSE, TAG_NEWLINE, "type", "serial number", NULL );
 	}
 }
@@ -977,18 +1032,18 @@ output_url( fields *f, FILE *outptr, int level )
 	n = fields_num( f );
 	for ( i=0; i<n; ++i ) {
 		if ( f->level[i]!=level ) continue;
-		if ( strcasecmp( f->tag[i].data, "URL" ) ) continue;
+		if ( !fields_match_casetag( f, i, "URL" ) ) continue;
 		output_fil( outptr, lvl2indent(incr_level(level,1)), "url", f, i, TAG_OPENCLOSE, TAG_NEWLINE, NULL );
 	}
 	for ( i=0; i<n; ++i ) {
 		if ( f->level[i]!=level ) continue;
-		if ( strcasecmp( f->tag[i].data, "PDFLINK" ) ) continue;
+		if ( !fields_match_casetag( f, i, "PDFLINK" ) ) continue;
 /*		output_fil( outptr, lvl2indent(incr_level(level,1)), "url", f, i, TAG_OPENCLOSE, TAG_NEWLINE, "urlType", "pdf", NULL ); */
 		output_fil( outptr, lvl2indent(incr_level(level,1)), "url", f, i, TAG_OPENCLOSE, TAG_NEWLINE, NULL );
 	}
 	for ( i=0; i<n; ++i ) {
 		if ( f->level[i]!=level ) continue;
-		if ( strcasecmp( f->tag[i].data, "FILEATTACH" ) ) continue;
+		if ( !fields_match_casetag( f, i, "FILEATTACH" ) ) continue;
 		output_fil( outptr, lvl2indent(incr_level(level,1)), "url", f, i, TAG_OPENCLOSE, TAG_NEWLINE, "displayLabel", "Electronic full text", "access", "raw object", NULL );
 	}
 	if ( location!=-1 )
@@ -1180,3 +1235,538 @@ modsout_writefooter( FILE *outptr )
 	fflush( outptr );
 }
 
+
+/*****************************************************
+ PUBLIC: int modsout_direct()
+*****************************************************/
+
+/* Georgi: the direct conversion (see any2any.c) doesn't write the MODS XML
+ * and read it back, so modsout_direct() makes the fields that modsin.c
+ * would have read from the output of modsout_write() for the reference.
+ * The functions below follow output_citeparts() and make the fields from
+ * each element as modsin_mods() does, in the same order.
+ */
+
+/* direct_text()
+ *
+ *      the text of an element as read back: xml_parse() skips the white
+ *      space at the start and modsin_readf() joins the lines
+ *
+ *      returns NULL if no text is left, or on a memory error in s
+ */
+static const char *
+direct_text( const char *value, str *s )
+{
+	const char *p;
+
+	if ( !value ) return NULL;
+
+	p = skip_ws( value );
+	if ( *p=='\0' ) return NULL;
+	if ( !strpbrk( p, "\r\n" ) ) return p;
+
+	str_empty( s );
+	for ( ; *p; ++p )
+		if ( *p!='\n' && *p!='\r' ) str_addchar( s, *p );
+	if ( str_memerr( s ) || s->len==0 ) return NULL;
+	return str_cstr( s );
+}
+
+static int
+direct_add( fields *out, const char *tag, const char *value, int level, str *s )
+{
+	const char *t;
+
+	t = direct_text( value, s );
+	if ( str_memerr( s ) ) return BIBL_ERR_MEMERR;
+	if ( !t ) return BIBL_OK;
+
+	if ( fields_add( out, tag, t, level )!=FIELDS_OK ) return BIBL_ERR_MEMERR;
+	return BIBL_OK;
+}
+
+static int
+direct_addn( fields *f, int n, fields *out, const char *tag, int level, str *s )
+{
+	if ( n==FIELDS_NOTFOUND ) return BIBL_OK;
+	return direct_add( out, tag, fields_value( f, n, FIELDS_CHRP ), level, s );
+}
+
+/* the "ID" attribute of <mods>, see output_head() */
+static int
+direct_head( fields *f, fields *out, int dropkey )
+{
+	int n, status = BIBL_OK;
+	const char *p;
+	str id;
+
+	if ( dropkey ) return BIBL_OK;
+
+	n = fields_find( f, "REFNUM", LEVEL_MAIN );
+	if ( n==FIELDS_NOTFOUND ) return BIBL_OK;
+
+	str_init( &id );
+	for ( p = fields_value( f, n, FIELDS_CHRP_NOUSE ); *p; ++p )
+		if ( !is_ws( *p ) ) str_addchar( &id, *p );
+	if ( str_memerr( &id ) ) status = BIBL_ERR_MEMERR;
+	else if ( id.len && fields_add( out, "REFNUM", str_cstr( &id ), LEVEL_MAIN )!=FIELDS_OK )
+		status = BIBL_ERR_MEMERR;
+	str_free( &id );
+
+	return status;
+}
+
+/* the <partName> of output_title() is not read back */
+static int
+direct_title( fields *f, fields *out, int level, int lvl, str *s )
+{
+	int ttl    = fields_find( f, "TITLE", level );
+	int subttl = fields_find( f, "SUBTITLE", level );
+	int shrttl = fields_find( f, "SHORTTITLE", level );
+	int status;
+
+	status = direct_addn( f, ttl, out, "TITLE", lvl, s );
+	if ( status!=BIBL_OK ) return status;
+	status = direct_addn( f, subttl, out, "SUBTITLE", lvl, s );
+	if ( status!=BIBL_OK ) return status;
+
+	if ( shrttl!=FIELDS_NOTFOUND && shorttitle_differs( f, ttl, subttl, shrttl ) )
+		status = direct_addn( f, shrttl, out, "SHORTTITLE", lvl, s );
+
+	return status;
+}
+
+/* a personal name, see output_name() and modsin_person() */
+static int
+direct_person( const char *value, char *role, fields *out, int lvl, str *s )
+{
+	str family, given, suffix, roles, namefamily, namesuffix;
+	int i, status;
+	const char *t;
+	slist parts;
+
+	strs_init( &family, &given, &suffix, &roles, &namefamily, &namesuffix, NULL );
+	slist_init( &parts );
+
+	status = name_parts( value, &namefamily, &parts, &namesuffix );
+	if ( status!=BIBL_OK ) goto out;
+
+	for ( i=0; i<parts.n; ++i ) {
+		t = direct_text( slist_cstr( &parts, i ), s );
+		if ( !t ) continue;
+		if ( given.len ) str_addchar( &given, '|' );
+		str_strcatc( &given, t );
+	}
+
+	t = direct_text( str_cstr( &namefamily ), s );
+	if ( t ) str_strcpyc( &family, t );
+
+	t = direct_text( str_cstr( &namesuffix ), s );
+	if ( t ) str_strcpyc( &suffix, t );
+
+	str_strcpyc( &roles, role );
+
+	if ( str_memerr( s ) || str_memerr( &given ) || str_memerr( &family ) ||
+	     str_memerr( &suffix ) || str_memerr( &roles ) ) {
+		status = BIBL_ERR_MEMERR;
+		goto out;
+	}
+
+	status = modsin_person_add( &family, &given, &suffix, &roles, out, lvl );
+out:
+	strs_free( &family, &given, &suffix, &roles, &namefamily, &namesuffix, NULL );
+	slist_free( &parts );
+	return status;
+}
+
+/* <name type="corporate"> gives the suffix ":CORP", any other non-personal
+ * name ":ASIS", see modsin_asis_corp()
+ */
+static int
+direct_asis_corp( const char *value, char *role, char *suffix, fields *out, int lvl, str *s )
+{
+	str roles, role_out;
+	const char *t;
+	int status;
+
+	t = direct_text( value, s );
+	if ( str_memerr( s ) ) return BIBL_ERR_MEMERR;
+	if ( !t ) return BIBL_OK;
+
+	strs_init( &roles, &role_out, NULL );
+	str_strcpyc( &roles, role );
+	if ( str_memerr( &roles ) ) { status = BIBL_ERR_MEMERR; goto out; }
+
+	status = modsin_marcrole_convert( &roles, suffix, &role_out );
+	if ( status!=BIBL_OK ) goto out;
+
+	if ( fields_add( out, str_cstr( &role_out ), t, lvl )!=FIELDS_OK )
+		status = BIBL_ERR_MEMERR;
+out:
+	strs_free( &roles, &role_out, NULL );
+	return status;
+}
+
+static int
+direct_names( fields *f, fields *out, int level, int lvl, str *s )
+{
+	int i, n, nfields, flags, status = BIBL_OK;
+	int *name, *nameflags;
+	char *value;
+	str role;
+
+	nfields = fields_num( f );
+	if ( nfields==0 ) return BIBL_OK;
+
+	name = ( int * ) malloc( sizeof( int ) * nfields * 2 );
+	if ( !name ) return BIBL_ERR_MEMERR;
+	nameflags = name + nfields;
+
+	/* output_names() takes the names in the order of mods_names[] */
+	str_init( &role );
+	for ( i=0; i<nfields; ++i ) {
+		name[i] = -1;
+		if ( fields_level( f, i )!=level ) continue;
+		if ( fields_no_value( f, i ) ) continue;
+		name[i] = mods_find_name( fields_tag( f, i, FIELDS_CHRP_NOUSE ), &role, &flags );
+		nameflags[i] = flags;
+	}
+	if ( str_memerr( &role ) ) status = BIBL_ERR_MEMERR;
+	str_free( &role );
+
+	for ( n=0; n<nmods_names && status==BIBL_OK; ++n ) {
+		for ( i=0; i<nfields && status==BIBL_OK; ++i ) {
+			if ( name[i]!=n ) continue;
+			value = fields_value( f, i, FIELDS_CHRP );
+			if ( nameflags[i] & MODS_NAME_ASIS )
+				status = direct_asis_corp( value, mods_names[n].mods, ":ASIS", out, lvl, s );
+			else if ( nameflags[i] & MODS_NAME_CORP )
+				status = direct_asis_corp( value, mods_names[n].mods, ":CORP", out, lvl, s );
+			else if ( nameflags[i] & MODS_NAME_CONF )
+				status = direct_asis_corp( value, mods_names[n].mods, ":ASIS", out, lvl, s );
+			else
+				status = direct_person( value, mods_names[n].mods, out, lvl, s );
+		}
+	}
+
+	free( name );
+	return status;
+}
+
+/* modsin_origininfo() adds the date and the place as they come and the
+ * publisher, edition and issuance at the end; <place> without <placeTerm>
+ * and <dateCaptured> are not read back
+ */
+static int
+direct_origin( fields *f, fields *out, int level, int lvl, str *s )
+{
+	char *last[] = { "publisher", "edition", "issuance" };
+	int nlast = sizeof( last ) / sizeof( last[0] );
+	int i, j, found, datefound, status = BIBL_OK;
+	int datepos[ NUM_DATE_TYPES ], pos[ MAX_PARTS ];
+	const char *t;
+	str date;
+
+	found     = convert_findallfields( f, origin_parts, norigin_parts, level, pos );
+	datefound = find_dateinfo( f, level, datepos );
+	if ( !found && !datefound ) return BIBL_OK;
+
+	if ( datefound ) {
+		str_init( &date );
+		status = dateissued( f, datepos, &date );
+		if ( status==BIBL_OK ) {
+			t = direct_text( str_cstr( &date ), s );
+			if ( str_memerr( s ) ) status = BIBL_ERR_MEMERR;
+			else status = modsin_datestr( t, out, lvl, 0 );
+		}
+		str_free( &date );
+		if ( status!=BIBL_OK ) return status;
+	}
+
+	for ( i=0; i<norigin_parts; ++i ) {
+		if ( pos[i]==-1 || origin_parts[i].code==0 ) continue;
+		status = direct_addn( f, pos[i], out, "ADDRESS", lvl, s );
+		if ( status!=BIBL_OK ) return status;
+	}
+
+	for ( j=0; j<nlast; ++j ) {
+		for ( i=0; i<norigin_parts; ++i ) {
+			if ( pos[i]==-1 || strcmp( origin_parts[i].mods, last[j] ) ) continue;
+			status = direct_addn( f, pos[i], out, origin_parts[i].internal, lvl, s );
+			if ( status!=BIBL_OK ) return status;
+		}
+	}
+
+	return BIBL_OK;
+}
+
+static int
+direct_type( fields *f, fields *out, int level, int lvl, str *s )
+{
+	int i, n, status = BIBL_OK;
+	const char *t;
+	char *value;
+
+	n = fields_find( f, "RESOURCE", level );
+	if ( n!=FIELDS_NOTFOUND ) {
+		value = fields_value( f, n, FIELDS_CHRP );
+		if ( is_marc_resource( value ) ) {
+			status = direct_add( out, "RESOURCE", value, lvl, s );
+			if ( status!=BIBL_OK ) return status;
+		} else {
+			REprintf( "Illegal typeofResource = '%s'\n", value );
+		}
+	}
+
+	n = fields_num( f );
+	for ( i=0; i<n; ++i ) {
+		if ( fields_level( f, i ) != level ) continue;
+		if ( !fields_match_tag( f, i, "GENRE:MARC" ) && !fields_match_tag( f, i, "GENRE:BIBUTILS" ) && !fields_match_tag( f, i, "GENRE:UNKNOWN" ) ) continue;
+		t = direct_text( fields_value( f, i, FIELDS_CHRP ), s );
+		if ( str_memerr( s ) ) return BIBL_ERR_MEMERR;
+		if ( !t ) continue;
+		status = modsin_genre_add( t, out, lvl );
+		if ( status!=BIBL_OK ) return status;
+	}
+
+	return BIBL_OK;
+}
+
+/* the text of the language and, with a iso639-2b code, the language of
+ * the code, see modsin_languager()
+ */
+static int
+direct_language( fields *f, fields *out, int level, int lvl, str *s )
+{
+	char *lang, *code, *d;
+	const char *t;
+	int n, status;
+
+	n = fields_find( f, "LANGUAGE", level );
+	if ( n==FIELDS_NOTFOUND ) return BIBL_OK;
+
+	lang = (char *) fields_value( f, n, FIELDS_CHRP );
+	code = iso639_2_from_language( lang );
+
+	status = direct_add( out, "LANGUAGE", lang, lvl, s );
+	if ( status!=BIBL_OK || !code ) return status;
+
+	t = direct_text( code, s );
+	if ( str_memerr( s ) ) return BIBL_ERR_MEMERR;
+	if ( !t ) return BIBL_OK;
+	d = iso639_2_from_code( (char *) t );
+	if ( fields_add( out, "LANGUAGE", d ? d : t, lvl )!=FIELDS_OK ) return BIBL_ERR_MEMERR;
+	return BIBL_OK;
+}
+
+/* <bibtex-annote> is read back as ANNOTE, <note type="annotation"> as
+ * ANNOTATION and any other <note> as NOTES
+ */
+static int
+direct_notes( fields *f, fields *out, int level, int lvl, str *s )
+{
+	char *notes[] = { "NOTES", "PUBSTATE", "TIMESCITED", "ADDENDUM", "BIBKEY" };
+	int nnotes = sizeof( notes ) / sizeof( notes[0] );
+	int i, j, n, status = BIBL_OK;
+	char *t, *tag;
+
+	n = fields_num( f );
+	for ( i=0; i<n && status==BIBL_OK; ++i ) {
+		if ( fields_level( f, i ) != level ) continue;
+		t = fields_tag( f, i, FIELDS_CHRP_NOUSE );
+		tag = NULL;
+		if ( !strcasecmp( t, "ANNOTE" ) ) tag = "ANNOTE";
+		else if ( !strcasecmp( t, "ANNOTATION" ) ) tag = "ANNOTATION";
+		else {
+			for ( j=0; j<nnotes && !tag; ++j )
+				if ( !strcasecmp( t, notes[j] ) ) tag = "NOTES";
+		}
+		if ( tag ) status = direct_add( out, tag, fields_value( f, i, FIELDS_CHRP ), lvl, s );
+	}
+
+	return status;
+}
+
+static int
+direct_key( fields *f, fields *out, int level, int lvl, str *s )
+{
+	int i, n, status = BIBL_OK;
+
+	n = fields_num( f );
+	for ( i=0; i<n && status==BIBL_OK; ++i ) {
+		if ( fields_level( f, i ) != level ) continue;
+		if ( fields_match_casetag( f, i, "KEYWORD" ) )
+			status = direct_add( out, "KEYWORD", fields_value( f, i, FIELDS_CHRP ), lvl, s );
+		else if ( fields_match_casetag( f, i, "EPRINTCLASS" ) )
+			status = direct_add( out, "EPRINTCLASS", fields_value( f, i, FIELDS_CHRP ), lvl, s );
+	}
+
+	return status;
+}
+
+/* the identifiers are read back by modsin_identifier(), which doesn't know
+ * some of the types written by output_sn()
+ */
+static int
+direct_sn( fields *f, fields *out, int level, int lvl, str *s )
+{
+	int i, n, status, pos[ MAX_PARTS ];
+	const char *t;
+
+	n = fields_find( f, "CALLNUMBER", level );
+	status = direct_addn( f, n, out, "CLASSIFICATION", lvl, s );
+	if ( status!=BIBL_OK ) return status;
+
+	convert_findallfields( f, sn_types, nsn_types, level, pos );
+	for ( i=0; i<nsn_types; ++i ) {
+		if ( pos[i]==-1 ) continue;
+		t = direct_text( fields_value( f, pos[i], FIELDS_CHRP ), s );
+		if ( str_memerr( s ) ) return BIBL_ERR_MEMERR;
+		status = modsin_identifier_add( sn_types[i].mods, t, out, lvl );
+		if ( status!=BIBL_OK ) return status;
+	}
+
+	n = fields_num( f );
+	for ( i=0; i<n; ++i ) {
+		if ( f->level[i]!=level ) continue;
+		if ( !fields_match_casetag( f, i, "SERIALNUMBER" ) ) continue;
+		t = direct_text( fields_value( f, i, FIELDS_CHRP ), s );
+		if ( str_memerr( s ) ) return BIBL_ERR_MEMERR;
+		status = modsin_identifier_add( "serial number", t, out, lvl );
+		if ( status!=BIBL_OK ) return status;
+	}
+
+	return BIBL_OK;
+}
+
+static int
+direct_url( fields *f, fields *out, int level, int lvl, str *s )
+{
+	char *urls[] = { "URL", "PDFLINK" };
+	int location = fields_find( f, "LOCATION", level );
+	int i, j, n, status = BIBL_OK;
+	const char *t;
+
+	n = fields_num( f );
+	for ( j=0; j<2; ++j ) {
+		for ( i=0; i<n; ++i ) {
+			if ( f->level[i]!=level ) continue;
+			if ( !fields_match_casetag( f, i, urls[j] ) ) continue;
+			t = direct_text( fields_value( f, i, FIELDS_CHRP ), s );
+			if ( str_memerr( s ) ) return BIBL_ERR_MEMERR;
+			if ( !t ) continue;
+			status = urls_split_and_add( (char *) t, out, lvl );
+			if ( status!=BIBL_OK ) return status;
+		}
+	}
+	for ( i=0; i<n; ++i ) {
+		if ( f->level[i]!=level ) continue;
+		if ( !fields_match_casetag( f, i, "FILEATTACH" ) ) continue;
+		status = direct_add( out, "FILEATTACH", fields_value( f, i, FIELDS_CHRP ), lvl, s );
+		if ( status!=BIBL_OK ) return status;
+	}
+
+	return direct_addn( f, location, out, "LOCATION", lvl, s );
+}
+
+/* the <detail> elements are read back with their type in upper case and
+ * the extent of the volumes is not read back, see modsin_part()
+ */
+static int
+direct_part( fields *f, fields *out, int level, int lvl, str *s )
+{
+	int i, status = BIBL_OK, pos[ MAX_PARTS ];
+	const char *t;
+	str tmp;
+
+	str_init( &tmp );
+
+	if ( convert_findallfields( f, partdate_parts, npartdate_parts, level, pos ) ) {
+		status = partdate( f, pos, &tmp );
+		if ( status!=BIBL_OK ) goto out;
+		t = direct_text( str_cstr( &tmp ), s );
+		if ( str_memerr( s ) ) { status = BIBL_ERR_MEMERR; goto out; }
+		status = modsin_datestr( t, out, lvl, 1 );
+		if ( status!=BIBL_OK ) goto out;
+	}
+
+	if ( convert_findallfields( f, element_parts, nelement_parts, level, pos ) ) {
+		for ( i=1; i<nelement_parts; ++i ) {
+			if ( pos[i]==-1 ) continue;
+			str_strcpyc( &tmp, element_parts[i].mods );
+			str_toupper( &tmp );
+			if ( str_memerr( &tmp ) ) { status = BIBL_ERR_MEMERR; goto out; }
+			status = direct_addn( f, pos[i], out, str_cstr( &tmp ), lvl, s );
+			if ( status!=BIBL_OK ) goto out;
+		}
+	}
+
+	if ( convert_findallfields( f, pages_parts, npages_parts, level, pos ) ) {
+		if ( pos[0]==-1 || pos[1]==-1 ) {
+			for ( i=0; i<3 && status==BIBL_OK; ++i )
+				status = direct_addn( f, pos[i], out, "PAGES:START", lvl, s );
+		} else {
+			status = direct_addn( f, pos[0], out, "PAGES:START", lvl, s );
+			if ( status==BIBL_OK )
+				status = direct_addn( f, pos[1], out, "PAGES:STOP", lvl, s );
+		}
+		if ( status==BIBL_OK )
+			status = direct_addn( f, pos[3], out, "PAGES:TOTAL", lvl, s );
+	}
+
+out:
+	str_free( &tmp );
+	return status;
+}
+
+static int
+direct_citeparts( fields *f, fields *out, int level, int lvl, int max, str *s )
+{
+	int orig_level, status;
+
+	status = direct_title( f, out, level, lvl, s );
+	if ( status==BIBL_OK ) status = direct_names( f, out, level, lvl, s );
+	if ( status==BIBL_OK ) status = direct_origin( f, out, level, lvl, s );
+	if ( status==BIBL_OK ) status = direct_type( f, out, level, lvl, s );
+	if ( status==BIBL_OK ) status = direct_language( f, out, level, lvl, s );
+	if ( status==BIBL_OK ) status = direct_addn( f, fields_find( f, "DESCRIPTION", level ), out, "DESCRIPTION", lvl, s );
+	if ( status!=BIBL_OK ) return status;
+
+	if ( level >= 0 && level < max ) {
+		status = direct_citeparts( f, out, incr_level(level,1), lvl+1, max, s );
+		if ( status!=BIBL_OK ) return status;
+	}
+	/* all original items are read back at LEVEL_ORIG */
+	orig_level = original_items( f, level );
+	if ( orig_level ) {
+		status = direct_citeparts( f, out, orig_level, LEVEL_ORIG, max, s );
+		if ( status!=BIBL_OK ) return status;
+	}
+
+	status = direct_addn( f, fields_find( f, "ABSTRACT", level ), out, "ABSTRACT", lvl, s );
+	if ( status==BIBL_OK ) status = direct_notes( f, out, level, lvl, s );
+	if ( status==BIBL_OK ) status = direct_addn( f, fields_find( f, "CONTENTS", level ), out, "CONTENTS", lvl, s );
+	if ( status==BIBL_OK ) status = direct_key( f, out, level, lvl, s );
+	if ( status==BIBL_OK ) status = direct_sn( f, out, level, lvl, s );
+	if ( status==BIBL_OK ) status = direct_url( f, out, level, lvl, s );
+	if ( status==BIBL_OK ) status = direct_part( f, out, level, lvl, s );
+	if ( status==BIBL_OK ) status = direct_addn( f, fields_find( f, "LANGCATALOG", level ), out, "LANGCATALOG", lvl, s );
+
+	return status;
+}
+
+int
+modsout_direct( fields *in, fields *out, param *p )
+{
+	int max, status;
+	str s;
+
+	str_init( &s );
+	max = fields_maxlevel( in );
+
+	status = direct_head( in, out, p->format_opts & BIBL_FORMAT_MODSOUT_DROPKEY );
+	if ( status==BIBL_OK ) status = direct_citeparts( in, out, 0, 0, max, &s );
+
+	str_free( &s );
+	return status;
+}
@@ -8,6 +8,7 @@
  */
 #include <stdio.h>
 #include <string.h>
+#include "str.h"
 #include "modstypes.h"
 
 /* Conversion information for identifier type attributes:
@@ -55,3 +56,74 @@ mods_find_internal( char *mods_name, convert *data, int ndata )
 	}
 	return NULL;
 }
+
+/* Conversion information for the roles of names:
+ *
+ *       <name type="personal">
+ *           <namePart type="family">XXX</namePart>
+ *           <role>
+ *               <roleTerm authority="marcrelator" type="text">author</roleTerm>
+ *           </role>
+ *       </name>
+ *
+ * in the order written by modsout.c
+ */
+convert mods_names[] = {
+	{ "author",                              "AUTHOR",          0, MODS_MARC_AUTHORITY },
+	{ "editor",                              "EDITOR",          0, MODS_MARC_AUTHORITY },
+	{ "annotator",                           "ANNOTATOR",       0, MODS_MARC_AUTHORITY },
+	{ "artist",                              "ARTIST",          0, MODS_MARC_AUTHORITY },
+	{ "author",                              "2ND_AUTHOR",      0, MODS_MARC_AUTHORITY },
+	{ "author",                              "3RD_AUTHOR",      0, MODS_MARC_AUTHORITY },
+	{ "author",                              "SUB_AUTHOR",      0, MODS_MARC_AUTHORITY },
+	{ "author",                              "COMMITTEE",       0, MODS_MARC_AUTHORITY },
+	{ "author",                              "COURT",           0, MODS_MARC_AUTHORITY },
+	{ "author",                              "LEGISLATIVEBODY", 0, MODS_MARC_AUTHORITY },
+	{ "author of afterword, colophon, etc.", "AFTERAUTHOR",     0, MODS_MARC_AUTHORITY },
+	{ "author of introduction, etc.",        "INTROAUTHOR",     0, MODS_MARC_AUTHORITY },
+	{ "cartographer",                        "CARTOGRAPHER",    0, MODS_MARC_AUTHORITY },
+	{ "collaborator",                        "COLLABORATOR",    0, MODS_MARC_AUTHORITY },
+	{ "commentator",                         "COMMENTATOR",     0, MODS_MARC_AUTHORITY },
+	{ "compiler",                            "COMPILER",        0, MODS_MARC_AUTHORITY },
+	{ "degree grantor",                      "DEGREEGRANTOR",   0, MODS_MARC_AUTHORITY },
+	{ "director",                            "DIRECTOR",        0, MODS_MARC_AUTHORITY },
+	{ "event",                               "EVENT",           0, MODS_NO_AUTHORITY   },
+	{ "inventor",                            "INVENTOR",        0, MODS_MARC_AUTHORITY },
+	{ "organizer of meeting",                "ORGANIZER",       0, MODS_MARC_AUTHORITY },
+	{ "patent holder",                       "ASSIGNEE",        0, MODS_MARC_AUTHORITY },
+	{ "performer",                           "PERFORMER",       0, MODS_MARC_AUTHORITY },
+	{ "producer",                            "PRODUCER",        0, MODS_MARC_AUTHORITY },
+	{ "addressee",                           "ADDRESSEE",       0, MODS_MARC_AUTHORITY },
+	{ "redactor",                            "REDACTOR",        0, MODS_MARC_AUTHORITY },
+	{ "reporter",                            "REPORTER",        0, MODS_MARC_AUTHORITY },
+	{ "sponsor",                             "SPONSOR",         0, MODS_MARC_AUTHORITY },
+	{ "translator",                          "TRANSLATOR",      0, MODS_MARC_AUTHORITY },
+	{ "writer",                              "WRITER",          0, MODS_MARC_AUTHORITY },
+};
+
+int nmods_names = sizeof( mods_names ) / sizeof( mods_names[0] );
+
+/* mods_find_name()
+ *
+ * The position in mods_names[] of a name tagged 'tag', e.g. "EDITOR:CORP",
+ * or -1. The ":ASIS", ":CORP" and ":CONF" suffixes are removed and reported
+ * in *flags, 'role' is work space.
+ */
+int
+mods_find_name( const char *tag, str *role, int *flags )
+{
+	int i;
+
+	*flags = 0;
+	str_strcpyc( role, tag );
+	if ( str_findreplace( role, ":ASIS", "" ) ) *flags |= MODS_NAME_ASIS;
+	if ( str_findreplace( role, ":CORP", "" ) ) *flags |= MODS_NAME_CORP;
+	if ( str_findreplace( role, ":CONF", "" ) ) *flags |= MODS_NAME_CONF;
+	if ( str_memerr( role ) ) return -1;
+
+	for ( i=0; i<nmods_names; ++i ) {
+		if ( !strcasecmp( str_cstr( role ), mods_names[i].internal ) )
+			return i;
+	}
+	return -1;
+}
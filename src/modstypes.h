@@ -8,6 +8,10 @@
  */
 #ifndef MODSTYPES_H
 #define MODSTYPES_H
+
+#include "str.h"
+#include "fields.h"
+
 typedef struct convert {
 	char *mods;     /* old */
 	char *internal; /* new */
@@ -21,4 +25,26 @@ extern int nidentifier_types;
 extern char *mods_find_attrib( char *internal_name, convert *data, int ndata );
 extern char *mods_find_internal( char *mods_name, convert *data, int ndata );
 
+/* Georgi: the names written by modsout.c, shared with the direct conversion */
+#define MODS_NO_AUTHORITY   (0)
+#define MODS_MARC_AUTHORITY (1)
+
+#define MODS_NAME_ASIS (1)
+#define MODS_NAME_CORP (2)
+#define MODS_NAME_CONF (4)
+
+extern convert mods_names[];
+extern int nmods_names;
+
+extern int mods_find_name( const char *tag, str *role, int *flags );
+
+/* Georgi: parts of modsin.c used by the direct conversion to read back
+ * what modsout.c would have written (see modsout_direct())
+ */
+extern int modsin_datestr( const char *p, fields *info, int level, int part );
+extern int modsin_marcrole_convert( str *s, char *suffix, str *out );
+extern int modsin_person_add( str *familyname, str *givenname, str *suffix, str *roles, fields *info, int level );
+extern int modsin_genre_add( const char *d, fields *info, int level );
+extern int modsin_identifier_add( const char *type, const char *value, fields *info, int level );
+
 #endif
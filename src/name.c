@@ -27,8 +27,6 @@
 #include "intlist.h"
 #include "name.h"
 
-int rdpack_patch_for_i_acute_variant = 0;
-
 /* name_build_withcomma()
  *
  * reconstruct parsed names in format: 'family|given|given||suffix'
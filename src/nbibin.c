@@ -32,7 +32,7 @@ extern int nbib_nall;
  PUBLIC: void nbib_initparams()
 *****************************************************/
 
-static int nbib_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset );
+static int nbib_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm );
 static int nbib_processf( fields *nbib, const char *p, const char *filename, long nref, param *pm );
 static int nbib_typef( fields *nbib, const char *filename, int nref, param *p );
 static int nbib_convertf( fields *nbib, fields *info, int reftype, param *p );
@@ -111,10 +111,10 @@ nbib_istag( const char *buf )
 }
 
 static int
-readmore( FILE *fp, char *buf, int bufsize, int *bufpos, str *line )
+readmore( freader *fr, str *line )
 {
 	if ( line->len ) return 1;
-	else return str_fget( fp, buf, bufsize, bufpos, line );
+	else return freader_getline( fr, line );
 }
 
 static int
@@ -134,14 +134,14 @@ skip_utf8_bom( str *line, int *fcharset )
 }
 
 static int
-nbib_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset )
+nbib_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm )
 {
 	int n, haveref = 0, inref = 0, readtoofar = 0;
 	char *p;
 
 	*fcharset = CHARSET_UNKNOWN;
 
-	while ( !haveref && readmore( fp, buf, bufsize, bufpos, line ) ) {
+	while ( !haveref && readmore( fr, line ) ) {
 
 		/* ...references are terminated by an empty line */
 		if ( str_is_empty( line ) ) {
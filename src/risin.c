@@ -32,7 +32,7 @@ extern int ris_nall;
  PUBLIC: void risin_initparams()
 *****************************************************/
 
-static int risin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset );
+static int risin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm );
 static int risin_processf( fields *risin, const char *p, const char *filename, long nref, param *pm );
 static int risin_typef( fields *risin, const char *filename, int nref, param *p );
 static int risin_convertf( fields *risin, fields *info, int reftype, param *p );
@@ -133,21 +133,21 @@ is_ris_end_tag( char *p )
 }
 
 static int
-readmore( FILE *fp, char *buf, int bufsize, int *bufpos, str *line )
+readmore( freader *fr, str *line )
 {
 	if ( line->len ) return 1;
-	else return str_fget( fp, buf, bufsize, bufpos, line );
+	else return freader_getline( fr, line );
 }
 
 static int
-risin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset )
+risin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm )
 {
 	int haveref = 0, inref = 0, readtoofar = 0;
 	char *p;
 
 	*fcharset = CHARSET_UNKNOWN;
 
-	while ( !haveref && readmore( fp, buf, bufsize, bufpos, line ) ) {
+	while ( !haveref && readmore( fr, line ) ) {
 
 		if ( str_is_empty( line ) ) continue;
 
@@ -153,6 +153,11 @@ slist_swap( slist *a, slist_index n1, slist_index n2 )
 		str_swapstrings( &(a->strs[n1]), &(a->strs[n2]) );
 }
 
+/* Georgi: the data of a str in the array, also while qsort() moves it
+ * (see str.h); the elements are relocated after sorting
+ */
+#define slist_data( s ) ( str_isinline( s ) ? (s)->small : (s)->data )
+
 static int
 slist_revcomp( const void *v1, const void *v2 )
 {
@@ -164,7 +169,7 @@ slist_revcomp( const void *v1, const void *v2 )
 	else if ( !s1->len ) return 1;
 	else if ( !s2->len ) return -1;
 
-	n = str_strcmp( s1, s2 );
+	n = strcmp( slist_data( s1 ), slist_data( s2 ) );
 	if ( n==0 ) return 0;
 	else if ( n > 0 ) return -1;
 	else return 1;
@@ -178,7 +183,7 @@ slist_comp( const void *v1, const void *v2 )
 	if ( !s1->len && !s2->len ) return 0;
 	else if ( !s1->len ) return -1;
 	else if ( !s2->len ) return 1;
-	else return str_strcmp( s1, s2 );
+	else return strcmp( slist_data( s1 ), slist_data( s2 ) );
 }
 
 static int
@@ -298,6 +303,9 @@ slist_realloc( slist *a, slist_index alloc )
 
 	a->strs = more;
 
+	for ( i=0; i<a->max; ++i )
+		str_relocate( &(a->strs[i]) );
+
 	for ( i=a->max; i<alloc; ++i )
 		str_init( &(a->strs[i]) );
 
@@ -331,9 +339,20 @@ slist_ensure_space( slist *a, slist_index n, int mode )
 int
 slist_addvp( slist *a, int mode, void *vp )
 {
-	str *s = NULL;
+	str *s = NULL, tmp;
 	int status;
 
+	/* Georgi: an element of a itself (or its data, see str.h) moves if the
+	 * array is reallocated
+	 */
+	if ( a->strs && (char *) vp >= (char *) a->strs && (char *) vp < (char *) ( a->strs + a->max ) ) {
+		if ( mode==SLIST_CHR ) str_initstrc( &tmp, (const char*) vp );
+		else str_initstr( &tmp, (str*) vp );
+		status = slist_addvp( a, SLIST_STR, (void*) &tmp );
+		str_free( &tmp );
+		return status;
+	}
+
 	status = slist_ensure_space( a, a->n+1, SLIST_DOUBLE_SIZE );
 
 	if ( status==SLIST_OK ) {
@@ -601,14 +620,20 @@ slist_remove( slist *a, slist_index n )
 void
 slist_sort( slist *a )
 {
+	slist_index i;
 	qsort( a->strs, a->n, sizeof( str ), slist_comp );
+	for ( i=0; i<a->n; ++i )
+		str_relocate( &(a->strs[i]) );
 	a->sorted = 1;
 }
 
 void
 slist_revsort( slist *a )
 {
+	slist_index i;
 	qsort( a->strs, a->n, sizeof( str ), slist_revcomp );
+	for ( i=0; i<a->n; ++i )
+		str_relocate( &(a->strs[i]) );
 	a->sorted = 0;
 }
 
@@ -22,7 +22,9 @@
 
 #include <R.h>
 
-
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "is_ws.h"
 #include "str.h"
@@ -86,12 +88,22 @@ str_realloc( str *s, unsigned long minsize )
 
 	size = 2 * s->dim;
 	if (size < minsize) size = minsize;
+	if (size <= STR_SMALLSIZE) size = str_initlen;
 
-	newptr = (char *) realloc( s->data, sizeof( *(s->data) )*size );
-	if ( !newptr ) handle_memerr( s, __FUNCTION__ );
+	if ( s->inarena || str_isinline( s ) ) {
+		newptr = (char *) malloc( sizeof( *(s->data) )*size );
+		if ( newptr ) memcpy( newptr, s->data, s->dim );
+	}
+	else newptr = (char *) realloc( s->data, sizeof( *(s->data) )*size );
+	if ( !newptr ) {
+		/* Georgi: s keeps its data, the caller sees str_memerr() */
+		handle_memerr( s, __FUNCTION__ );
+		return;
+	}
 
 	s->data = newptr;
 	s->dim = size;
+	s->inarena = 0;
 }
 
 /* define as a no-op */
@@ -110,16 +122,22 @@ str_realloc( str *s, unsigned long minsize )
 
 	size = 2 * s->dim;
 	if ( size < minsize ) size = minsize;
+	if ( size <= STR_SMALLSIZE ) size = str_initlen;
 
 	newptr = (char *) malloc( sizeof( *(s->data) ) * size );
-	if ( !newptr ) handle_memerr( s, __FUNCTION__ );
+	if ( !newptr ) {
+		handle_memerr( s, __FUNCTION__ );
+		return;
+	}
 
 	if ( s->data ) {
+		memcpy( newptr, s->data, s->dim );
 		str_nullify( s );
-		free( s->data );
+		if ( !s->inarena && !str_isinline( s ) ) free( s->data );
 	}
 	s->data = newptr;
 	s->dim = size;
+	s->inarena = 0;
 }
 
 static inline void
@@ -137,6 +155,7 @@ str_init( str *s )
 	s->dim = 0;
 	s->len = 0;
 	s->data = NULL;
+	s->inarena = 0;
 	str_clear_status( s );
 }
 
@@ -217,7 +236,12 @@ str_initalloc( str *s, unsigned long minsize )
        unsigned long size = str_initlen;
        assert( s );
        if ( minsize > str_initlen ) size = minsize;
-       s->data = (char *) malloc( sizeof( *(s->data) ) * size );
+       if ( minsize <= STR_SMALLSIZE ) {
+	       /* Georgi: short, keep it in the str, see str.h */
+	       size = STR_SMALLSIZE;
+	       s->data = s->small;
+       }
+       else s->data = (char *) malloc( sizeof( *(s->data) ) * size );
        //     tried changing to calloc() to avoid this kind of error from valgrind:
         //      > bibConvert(fn_med, bib, informat = "med")
         //      ==16041== Conditional jump or move depends on uninitialised value(s)
@@ -253,12 +277,29 @@ str_initalloc( str *s, unsigned long minsize )
        //
        // s->data = (char *) calloc( size, sizeof( *(s->data) ) );
        if ( !s->data ) {
+#if defined( _OPENMP ) && !defined( STR_SMALL )
+	 /* Georgi: error() must not be called on the threads of bibl_parallel()
+	  * (the longjmp out of a parallel region is undefined). Leave s empty
+	  * and marked, the caller sees str_memerr() and returns BIBL_ERR_MEMERR,
+	  * which is reported on the main thread.
+	  */
+	 if ( omp_in_parallel() ) {
+		s->data = s->small;
+		s->data[0] = '\0';
+		s->dim = STR_SMALLSIZE;
+		s->len = 0;
+		s->inarena = 0;
+		s->status = STR_MEMERR;
+		return;
+	 }
+#endif
          error("Error.  Cannot allocate memory in str_initalloc, requested %lu characters.\n\n", size );
          // error("\n"); // error( EXIT_FAILURE );
 	}
 	s->data[0]='\0';
 	s->dim=size;
 	s->len=0;
+	s->inarena=0;
 	str_clear_status( s );
 }
 
@@ -267,7 +308,7 @@ str_new( void )
 {
 	str *s = (str *) malloc( sizeof( *s ) );
 	if ( s )
-		str_initalloc( s, str_initlen );
+		str_initalloc( s, 1 );
 	return s;
 }
 
@@ -277,11 +318,58 @@ str_free( str *s )
 	assert( s );
 	if ( s->data ) {
 		str_nullify( s );
-		free( s->data );
+		if ( !s->inarena && !str_isinline( s ) ) free( s->data );
 	}
 	s->dim = 0;
 	s->len = 0;
 	s->data = NULL;
+	s->inarena = 0;
+}
+
+/* str_relocate( s )
+ *
+ * Georgi: s has been moved in memory (by realloc, memcpy or assignment),
+ * point its data again to its own small buffer if it is used, see str.h.
+ */
+void
+str_relocate( str *s )
+{
+	assert( s );
+	if ( str_isinline( s ) ) s->data = s->small;
+}
+
+/* str_segtoarena( s, startat, endat, p )
+ *
+ * Georgi: as str_segcpy( s, startat, endat ) but into p, which is
+ * typically from an arena (see arena.c and xml_setstr()), instead of the
+ * heap. p must have room for endat-startat+1 chars unless the segment fits
+ * the small buffer of s. s doesn't own p: str_free() leaves it alone and a
+ * change needing more room moves the data to the heap. Unlike str_segcpy(),
+ * an empty segment leaves s with data "". Returns the number of chars used
+ * from p.
+ */
+unsigned long
+str_segtoarena( str *s, const char *startat, const char *endat, char *p )
+{
+	unsigned long n;
+	char *q;
+
+	assert( s && startat && endat );
+	assert( startat <= endat );
+
+	n = (unsigned long) ( endat - startat );
+	q = ( n + 1 <= STR_SMALLSIZE ) ? s->small : p;
+	assert( q );
+
+	if ( s->data && !s->inarena && !str_isinline( s ) ) free( s->data );
+	memcpy( q, startat, n );
+	q[ n ] = '\0';
+	s->data    = q;
+	s->len     = n;
+	s->dim     = ( q==s->small ) ? STR_SMALLSIZE : n + 1;
+	s->inarena = ( q!=s->small );
+	str_clear_status( s );
+	return ( q==s->small ) ? 0 : n + 1;
 }
 
 void
@@ -342,9 +430,10 @@ str_addchar( str *s, char newchar )
 	if ( newchar=='\0' ) return; /* appending '\0' is a null operation */
 
 	if ( !s->data || s->dim==0 ) 
-		str_initalloc( s, str_initlen );
+		str_initalloc( s, 2 );
 	if ( s->len + 2 > s->dim ) 
 		str_realloc( s, s->len*2 );
+	return_if_memerr( s );
 
 	s->data[s->len++] = newchar;
 	s->data[s->len] = '\0';
@@ -404,9 +493,11 @@ str_prepend( str *s, const char *addstr )
 	else {
 		if ( s->len + lenaddstr  + 1 > s->dim )
 			str_realloc( s, s->len + lenaddstr + 1 );
+		return_if_memerr( s );
 		for ( i=s->len+lenaddstr-1; i>=lenaddstr; i-- )
 			s->data[i] = s->data[i-lenaddstr];
 	}
+	return_if_memerr( s );
 	// Georgi: fix the warning about truncation in strncpy; strcpy cannot be used here (at
 	//   least not without further adjustments) since here the final null would replace
 	//   the first char of the original string (see above, where the original string was
@@ -436,6 +527,7 @@ str_strcat_internal( str *s, const char *addstr, unsigned long n )
 {
 	return_if_memerr( s );
 	str_strcat_ensurespace( s, n );
+	return_if_memerr( s );
 	// Georgi: tell the compiler that there is enough space to fix
 	//   warning: 'strncat' output truncated before terminating nul copying as many bytes
 	//   from a string as its length [-Wstringop-truncation]
@@ -467,7 +559,6 @@ void
 str_segcat( str *s, char *startat, char *endat )
 {
 	unsigned long n;
-	char *p;
 
 	assert( s && startat && endat );
 	assert( (size_t) startat < (size_t) endat );
@@ -476,12 +567,7 @@ str_segcat( str *s, char *startat, char *endat )
 
 	if ( startat==endat ) return;
 
-	n = 0;
-	p = startat;
-	while ( p!=endat ) {
-		n++;
-		p++;
-	}
+	n = (unsigned long) ( endat - startat );
 
 	str_strcat_internal( s, startat, n );
 }
@@ -550,6 +636,7 @@ str_strcpy_internal( str *s, const char *p, unsigned long n )
 	return_if_memerr( s );
 
 	str_strcpy_ensurespace( s, n );
+	return_if_memerr( s );
         // Georgi: (Github commit 20efd6 on 4 Jul 2020)
         //
         // This fixes the warning about truncation in strncpy
@@ -621,7 +708,6 @@ void
 str_segcpy( str *s, char *startat, char *endat )
 {
 	unsigned long n;
-	char *p;
 
 	assert( s && startat && endat );
 	assert( ((size_t) startat) <= ((size_t) endat) );
@@ -633,12 +719,7 @@ str_segcpy( str *s, char *startat, char *endat )
 		return;
 	}
 
-	n = 0;
-	p = startat;
-	while ( p!=endat ) {
-		p++;
-		n++;
-	}
+	n = (unsigned long) ( endat - startat );
 
 	str_strcpy_internal( s, startat, n );
 }
@@ -663,6 +744,7 @@ str_indxcpy( str *s, char *p, unsigned long start, unsigned long stop )
 		return;
 	}
 	str_strcpy_ensurespace( s, stop-start+1 );
+	return_if_memerr( s );
 	for ( i=start; i<stop; ++i )
 		s->data[i-start] = p[i];
 	s->len = stop-start;
@@ -745,6 +827,7 @@ str_findreplace( str *s, const char *find, const char *replace )
 		findstart=(size_t) p - (size_t) s->data;
 		minsize = curr_len + diff + 1;
 		if (s->dim <= minsize) str_realloc( s, minsize );
+		return_zero_if_memerr( s );
 		if ( find_len > rep_len ) {
 			p1 = findstart + rep_len;
 			p2 = findstart + find_len;
@@ -823,25 +906,17 @@ str_tolower( str *s )
 void
 str_swapstrings( str *s1, str *s2 )
 {
-	char *tmpp;
-	int tmp;
+	str tmp;
 
 	assert( s1 && s2 );
 
-	/* swap dimensioning info */
-	tmp = s1->dim;
-	s1->dim = s2->dim;
-	s2->dim = tmp;
+	/* Georgi: swap everything, the small buffers included (see str.h) */
+	tmp = *s1;
+	*s1 = *s2;
+	*s2 = tmp;
 
-	/* swap length info */
-	tmp = s1->len;
-	s1->len = s2->len;
-	s2->len = tmp;
-
-	/* swap data */
-	tmpp = s1->data;
-	s1->data = s2->data;
-	s2->data = tmpp;
+	str_relocate( s1 );
+	str_relocate( s2 );
 }
 
 void
@@ -1191,6 +1266,7 @@ str_fill( str *s, unsigned long n, char fillchar )
 		str_initalloc( s, n+1 );
 	if ( n + 1 > s->dim )
 		str_realloc( s, n+1 );
+	return_if_memerr( s );
 	for ( i=0; i<n; ++i )
 		s->data[i] = fillchar;
 	s->data[n] = '\0';
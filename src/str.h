@@ -16,6 +16,13 @@
 
 #include <stdio.h>
 
+/* Georgi: strings shorter than STR_SMALLSIZE are kept in the str itself,
+ * in 'small', with data pointing to it (and dim==STR_SMALLSIZE). Code
+ * moving a str in memory (realloc, memcpy, qsort or assignment of a
+ * struct) must call str_relocate() for the copy.
+ */
+#define STR_SMALLSIZE (24)
+
 typedef struct str {
 	char *data;
 	unsigned long dim;
@@ -23,8 +30,12 @@ typedef struct str {
 #ifndef STR_SMALL
 	int status;
 #endif
+	int inarena; /* Georgi: data not owned, see str_segtoarena() */
+	char small[ STR_SMALLSIZE ];
 }  str;
 
+#define str_isinline( s ) ( (s)->dim==STR_SMALLSIZE )
+
 str *  str_new         ( void );
 void   str_delete      ( str *s );
 
@@ -34,6 +45,8 @@ void   str_initstrc    ( str *s, const char *initstr );
 void   str_initstrsc   ( str *s, ... );
 void   str_empty       ( str *s );
 void   str_free        ( str *s );
+void   str_relocate    ( str *s );
+unsigned long str_segtoarena( str *s, const char *startat, const char *endat, char *p );
 
 void   strs_init       ( str *s, ... );
 void   strs_empty      ( str *s, ... );
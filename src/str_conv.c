@@ -22,8 +22,7 @@
 #include "str_conv.h"
 
 #include <R.h>
-
-int export_tex_chars_only = 0; // Georgi
+#include "bibthread.h"
 
 static void
 addentity( str *s, unsigned int ch )
@@ -84,15 +83,15 @@ addgb18030char( str *s, unsigned int ch, int xmlout )
 }
 
 static void
-addlatexchar( str *s, unsigned int ch, int xmlout, int utf8out )
+addlatexchar( str *s, unsigned int ch, int latexout, int xmlout, int utf8out )
 {
 	char buf[512];
 
 	
 	uni2latex( ch, buf, sizeof( buf ) );
 
-	// Georgi
-	if(export_tex_chars_only) {
+	// Georgi (was the global export_tex_chars_only)
+	if( latexout==STR_CONV_LATEX_ESCAPES ) {
 	  if( ch == 36  || ch == 123 || ch == 125 ) { // '$', '{', '}'
 	    str_addchar(s, (char) ch);
 	    return;
@@ -152,7 +151,7 @@ get_unicode( str *s, unsigned int *pi, int charsetin, int latexin, int utf8in, i
 		if ( utf8in && ( s->data[*pi] & 128 ) ) {
 			ch = utf8_decode( s->data, pi );
 			unicode = 1;
-		} else ch = latex2char( s->data, pi, &unicode );
+		} else ch = latex2char( s->data, pi, &unicode, latexin==STR_CONV_LATEX_ESCAPES );
 	}
 	else if ( utf8in )
 		ch = utf8_decode( s->data, pi );
@@ -160,7 +159,7 @@ get_unicode( str *s, unsigned int *pi, int charsetin, int latexin, int utf8in, i
 		ch = (unsigned int) s->data[*pi];
 		*pi = *pi + 1;
 	}
-	if ( !unicode && charsetin!=CHARSET_UNICODE )
+	if ( !unicode && charsetin!=CHARSET_UNICODE && charsetin!=CHARSET_GB18030 )
 		ch = charset_lookupchar( charsetin, ch );
 	
 	// REprintf("(get_unicode) ch: %d, latexin: %d, utf8in: %d, charsetin = %d\n",
@@ -181,7 +180,7 @@ write_unicode( str *s, unsigned int ch, int charsetout, int latexout,
 	// 	                  ch,     latexout,      utf8out,    charsetout);
 	
 	if ( latexout ) {
-		addlatexchar( s, ch, xmlout, utf8out );
+		addlatexchar( s, ch, latexout, xmlout, utf8out );
 	} else if ( utf8out ) {
 		addutf8char( s, ch, xmlout );
 	} else if ( charsetout==CHARSET_GB18030 ) {
@@ -199,6 +198,123 @@ write_unicode( str *s, unsigned int ch, int charsetout, int latexout,
 	return 1;
 }
 
+/* Georgi: bytes that str_convert() can copy as they are
+ *
+ * Most fields are plain ASCII, and most of their characters come out of
+ * get_unicode() and write_unicode() unchanged. str_conv_class[] has a bit
+ * for each reason why an ASCII byte might not:
+ *
+ *   STR_CONV_XMLIN     '&' starts an entity (xmlin)
+ *   STR_CONV_LATEXIN   may start a LaTeX escape (latexin, see latex2char())
+ *   STR_CONV_ESCIN     may start a LaTeX escape (latexin==STR_CONV_LATEX_ESCAPES)
+ *   STR_CONV_XMLOUT    one of the five minimal XML entities (xmlout)
+ *   STR_CONV_LATEXOUT  has a LaTeX equivalent (latexout, see uni2latex())
+ *   STR_CONV_ESCOUT    same, for latexout==STR_CONV_LATEX_ESCAPES
+ *
+ * Bytes >= 128 (and '\0') have all bits set, including STR_CONV_ANY, which
+ * is always in the mask. With STR_CONV_UTF8 in the mask (UTF-8 in and out,
+ * no LaTeX output and no XML entities on output), valid UTF-8 characters,
+ * see utf8_charlen(), are copied as they are too. The LaTeX bits come from uni2latex(), so
+ * the table is filled on first use (shared by the threads, see bibthread.c).
+ */
+#define STR_CONV_XMLIN    (1)
+#define STR_CONV_LATEXIN  (2)
+#define STR_CONV_ESCIN    (4)
+#define STR_CONV_XMLOUT   (8)
+#define STR_CONV_LATEXOUT (16)
+#define STR_CONV_ESCOUT   (32)
+#define STR_CONV_ANY      (128)
+#define STR_CONV_UTF8     (256)
+
+static unsigned char str_conv_class[256];
+static int str_conv_class_built = 0;
+
+static void
+str_conv_class_build( void )
+{
+	char buf[512];
+	int c;
+
+	for ( c=0; c<128; ++c ) {
+		str_conv_class[c] = 0;
+		if ( c=='&' ) str_conv_class[c] |= STR_CONV_XMLIN;
+		if ( strchr( "\\\'\"`-^_lL~", c ) ) str_conv_class[c] |= STR_CONV_LATEXIN;
+		if ( c=='\\' ) str_conv_class[c] |= STR_CONV_ESCIN;
+		if ( strchr( "\"&'<>", c ) ) str_conv_class[c] |= STR_CONV_XMLOUT;
+		uni2latex( c, buf, sizeof( buf ) );
+		if ( buf[0]!=c || buf[1]!='\0' ) {
+			str_conv_class[c] |= STR_CONV_LATEXOUT;
+			/* see addlatexchar() */
+			if ( !( c=='$' || c=='{' || c=='}' || !strcmp( buf, "{\\backslash}" ) ) )
+				str_conv_class[c] |= STR_CONV_ESCOUT;
+		}
+	}
+	/* strchr() also finds the terminating '\0' */
+	str_conv_class[0] = 0xFF;
+	for ( c=128; c<256; ++c )
+		str_conv_class[c] = 0xFF;
+}
+
+/* The bits of str_conv_class[] that matter for a conversion, -1 if the fast
+ * path cannot be used (8-bit character sets, whose ASCII half is not
+ * necessarily ASCII)
+ */
+static int
+str_conv_mask( int charsetin, int latexin, int utf8in, int xmlin,
+	int charsetout, int latexout, int utf8out, int xmlout )
+{
+	int mask = 0, built;
+
+	if ( charsetin!=CHARSET_UNICODE && charsetin!=CHARSET_GB18030 ) return -1;
+	if ( !latexout && !utf8out && charsetout!=CHARSET_UNICODE && charsetout!=CHARSET_GB18030 )
+		return -1;
+
+	if ( xmlin ) mask |= STR_CONV_XMLIN;
+	if ( latexin==STR_CONV_LATEX_ESCAPES ) mask |= STR_CONV_ESCIN;
+	else if ( latexin ) mask |= STR_CONV_LATEXIN;
+	if ( latexout==STR_CONV_LATEX_ESCAPES ) mask |= STR_CONV_ESCOUT;
+	else if ( latexout ) mask |= STR_CONV_LATEXOUT;
+	else if ( xmlout ) mask |= STR_CONV_XMLOUT;
+	if ( charsetin==CHARSET_UNICODE && utf8in && utf8out && !latexout &&
+	     xmlout!=STR_CONV_XMLOUT_ENTITIES )
+		mask |= STR_CONV_UTF8;
+
+	bibl_load_acquire( built, str_conv_class_built );
+	if ( !built ) {
+#ifdef _OPENMP
+#pragma omp critical ( str_conv_class )
+#endif
+		{
+			if ( !str_conv_class_built ) {
+				str_conv_class_build();
+				bibl_store_release( str_conv_class_built, 1 );
+			}
+		}
+	}
+
+	return mask;
+}
+
+/* length of the run of bytes at p (of length len) that are copied as they are */
+static unsigned long
+str_conv_run( const char *p, unsigned long len, int mask )
+{
+	const unsigned char *q = ( const unsigned char * ) p;
+	unsigned long n = 0;
+	int k;
+
+	if ( mask==STR_CONV_UTF8 ) return utf8_validate( p, len );
+
+	mask |= STR_CONV_ANY;
+	while ( 1 ) {
+		if ( !( str_conv_class[ q[n] ] & mask ) ) n++;
+		else if ( ( mask & STR_CONV_UTF8 ) && q[n]>=128 && ( k = utf8_charlen( p+n ) ) ) n += k;
+		else break;
+	}
+
+	return n;
+}
+
 /*
  * Returns 1 on memory error condition
  */
@@ -209,12 +325,20 @@ str_convert( str *s,
 {
 	unsigned int pos = 0;
 	unsigned int ch;
+	unsigned long n;
 	str ns;
-	int ok = 1;
+	int ok = 1, mask;
 
 	if ( !s || s->len==0 ) return ok;
 	// REprintf("(str_convert): s = %s\n", s->data);
 
+	if ( charsetin==CHARSET_UNKNOWN ) charsetin = CHARSET_DEFAULT;
+	if ( charsetout==CHARSET_UNKNOWN ) charsetout = CHARSET_DEFAULT;
+
+	/* nothing to do if all of it is copied as it is */
+	mask = str_conv_mask( charsetin, latexin, utf8in, xmlin, charsetout, latexout, utf8out, xmlout );
+	if ( mask!=-1 && str_conv_run( s->data, s->len, mask )==s->len ) return ok;
+
 	/* Ensure that string is internally allocated.
 	 * This fixes NULL pointer derefernce in CVE-2018-10775 in bibutils
 	 * as a string with a valid data pointer is potentially replaced
@@ -226,12 +350,17 @@ str_convert( str *s,
 	 */
 	str_initstrc( &ns, "" );
 
-	if ( charsetin==CHARSET_UNKNOWN ) charsetin = CHARSET_DEFAULT;
-	if ( charsetout==CHARSET_UNKNOWN ) charsetout = CHARSET_DEFAULT;
-
 	while ( s->data[pos] ) {
 	// REprintf("(str_convert): pos = %d\n", pos);
 	// REprintf("(str_convert): s = %s\n", s->data);
+		if ( mask!=-1 ) {
+			n = str_conv_run( &(s->data[pos]), s->len - pos, mask );
+			if ( n ) {
+				str_segcat( &ns, &(s->data[pos]), &(s->data[pos+n]) );
+				pos += n;
+				continue;
+			}
+		}
 		ch = get_unicode( s, &pos, charsetin, latexin, utf8in, xmlin );
 		ok = write_unicode( &ns, ch, charsetout, latexout, utf8out, xmlout );
 		if ( !ok ) goto out;
@@ -13,6 +13,11 @@
 #define STR_CONV_XMLOUT_TRUE     (1)
 #define STR_CONV_XMLOUT_ENTITIES (3)
 
+/* Georgi: value of latexin/latexout for str_convert(); on input only the
+ * LaTeX escapes are converted, on output $, {, } and \ are kept as they are
+ */
+#define STR_CONV_LATEX_ESCAPES   (2)
+
 #include "str.h"
 
 extern int str_convert( str *s,
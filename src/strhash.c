@@ -0,0 +1,140 @@
+/*
+ * strhash.c
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * Source code released under the GPL version 2
+ *
+ * Implements a simple hash table with strings as keys (open addressing with
+ * linear probing, the size is a power of 2 and at most half of it is used).
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "strhash.h"
+
+#define STRHASH_MINALLOC (64)
+
+/* FNV-1a */
+unsigned long
+strhash_hash( const char *s )
+{
+	unsigned long h = 2166136261UL;
+	while ( *s ) {
+		h ^= (unsigned char) *s++;
+		h *= 16777619UL;
+	}
+	return h;
+}
+
+void
+strhash_init( strhash *h )
+{
+	h->n     = 0;
+	h->max   = 0;
+	h->key   = NULL;
+	h->value = NULL;
+}
+
+void
+strhash_empty( strhash *h )
+{
+	long i;
+	for ( i=0; i<h->max; ++i ) {
+		if ( h->key[i] ) {
+			free( h->key[i] );
+			h->key[i] = NULL;
+		}
+	}
+	h->n = 0;
+}
+
+void
+strhash_free( strhash *h )
+{
+	strhash_empty( h );
+	if ( h->key )   free( h->key );
+	if ( h->value ) free( h->value );
+	strhash_init( h );
+}
+
+/* the slot of 'key' or, if it is not there, the empty slot for it */
+static long
+strhash_slot( strhash *h, const char *key )
+{
+	long i = strhash_hash( key ) & ( h->max - 1 );
+	while ( h->key[i] && strcmp( h->key[i], key ) )
+		i = ( i + 1 ) & ( h->max - 1 );
+	return i;
+}
+
+static int
+strhash_resize( strhash *h, long alloc )
+{
+	char **oldkey = h->key;
+	long *oldvalue = h->value, oldmax = h->max, i, j;
+
+	h->key   = ( char ** ) calloc( alloc, sizeof( char * ) );
+	h->value = ( long * ) malloc( sizeof( long ) * alloc );
+	if ( !h->key || !h->value ) {
+		if ( h->key )   free( h->key );
+		if ( h->value ) free( h->value );
+		h->key   = oldkey;
+		h->value = oldvalue;
+		return STRHASH_MEMERR;
+	}
+	h->max = alloc;
+
+	for ( i=0; i<oldmax; ++i ) {
+		if ( !oldkey[i] ) continue;
+		j = strhash_slot( h, oldkey[i] );
+		h->key[j]   = oldkey[i];
+		h->value[j] = oldvalue[i];
+	}
+
+	if ( oldkey )   free( oldkey );
+	if ( oldvalue ) free( oldvalue );
+
+	return STRHASH_OK;
+}
+
+/* strhash_add()
+ *
+ * Adds 'key' with 'value', unless 'key' is already there, in which case
+ * the old value is kept.
+ *
+ * returns STRHASH_OK or STRHASH_MEMERR
+ */
+int
+strhash_add( strhash *h, const char *key, long value )
+{
+	long i;
+
+	if ( 2 * ( h->n + 1 ) > h->max ) {
+		if ( strhash_resize( h, h->max ? 2 * h->max : STRHASH_MINALLOC )!=STRHASH_OK )
+			return STRHASH_MEMERR;
+	}
+
+	i = strhash_slot( h, key );
+	if ( h->key[i] ) return STRHASH_OK;
+
+	h->key[i] = strdup( key );
+	if ( !h->key[i] ) return STRHASH_MEMERR;
+	h->value[i] = value;
+	h->n++;
+
+	return STRHASH_OK;
+}
+
+/* strhash_find()
+ *
+ * returns the value for 'key' or STRHASH_NOTFOUND
+ */
+long
+strhash_find( strhash *h, const char *key )
+{
+	long i;
+	if ( h->n==0 ) return STRHASH_NOTFOUND;
+	i = strhash_slot( h, key );
+	return ( h->key[i] ) ? h->value[i] : STRHASH_NOTFOUND;
+}
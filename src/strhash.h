@@ -0,0 +1,33 @@
+/*
+ * strhash.h
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * Source code released under the GPL version 2
+ *
+ */
+#ifndef STRHASH_H
+#define STRHASH_H
+
+#define STRHASH_OK       (0)
+#define STRHASH_MEMERR   (-1)
+#define STRHASH_NOTFOUND (-1)
+
+/* hash table with strings as keys and non-negative longs as values;
+ * the keys are copied
+ */
+typedef struct strhash {
+	long n, max;
+	char **key;
+	long *value;
+} strhash;
+
+unsigned long strhash_hash( const char *s );
+
+void strhash_init ( strhash *h );
+void strhash_free ( strhash *h );
+void strhash_empty( strhash *h );
+int  strhash_add  ( strhash *h, const char *key, long value );
+long strhash_find ( strhash *h, const char *key );
+
+#endif
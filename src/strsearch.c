@@ -15,27 +15,48 @@
  * strsearch returns haystack when needle is empty as per strstr()
  * conventions
  *
+ * Georgi: the candidates for a match are found with strchr() when the
+ * first character of needle has no other case (e.g. '<' of the XML tags
+ * searched by xml_find_start() and xml_find_end()), so the haystack is
+ * scanned by the C library instead of with toupper() on every byte
+ *
  */
 #include <stdio.h>
+#include <string.h>
 #include <ctype.h>
 #include "strsearch.h"
 
 char *strsearch (const char *haystack, const char *needle)
 {
-	char *returnptr=NULL;
-	unsigned long pos=0;
+	const unsigned char *h = (const unsigned char *) haystack;
+	const unsigned char *n, *q;
+	int c, first;
+
+	if ( !(*needle) ) return (char *) haystack;
 
-	if ( !(*needle) ) returnptr = (char *) haystack;
+	c     = (unsigned char) *needle;
+	first = toupper( c );
 
-	while (*(haystack+pos) && returnptr==NULL) {
-		if ( toupper((unsigned char)*(haystack+pos)) == toupper((unsigned char)*(needle+pos)) )
-			pos++;
-		else {
-			pos = 0;
-			haystack++;
+	while ( 1 ) {
+
+		/* the next candidate for the first character */
+		if ( c < 128 && !isalpha( c ) ) {
+			h = (const unsigned char *) strchr( (const char *) h, c );
+			if ( !h ) return NULL;
+		} else {
+			while ( *h && toupper( *h )!=first ) h++;
+			if ( !(*h) ) return NULL;
 		}
-		if ( ! (*(needle+pos)) ) returnptr = (char *) haystack;
+
+		n = (const unsigned char *) needle + 1;
+		q = h + 1;
+		while ( *n && *q && toupper( *q )==toupper( *n ) ) {
+			n++;
+			q++;
+		}
+		if ( !(*n) ) return (char *) h;
+		if ( !(*q) ) return NULL; /* haystack is shorter than needle */
+
+		h++;
 	}
-	return returnptr;
 }
-
@@ -0,0 +1,303 @@
+/*
+ * tagatom.c
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * Source code released under the GPL version 2
+ *
+ */
+
+/* Interned tags for fields (see fields.c).
+ *
+ * Each distinct tag gets a small integer, its atom, the first time it is
+ * seen, so a fields entry stores an int instead of its own copy of the tag
+ * and tags are compared as ints. The atoms of tags differing only in case
+ * ("AUTHOR", "author") share a case id (tagatom_case()), which is what
+ * the case insensitive matching of fields_find() and friends compares.
+ *
+ * The table is global and lives as long as the package is loaded; it holds
+ * only the names of the tags, which are few, so it is not emptied between
+ * conversions. tagatom_free() releases it when the package is unloaded
+ * (see init.c).
+ *
+ * Tags are interned also from the threads of bibl_parallel() (bibthread.c).
+ * Additions are serialised by a lock; lookups don't take it. For this the
+ * buckets of the hash tables and the blocks of atoms have fixed addresses,
+ * and a new node is made visible (with a release store) only after it and
+ * its atom are completely set up.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "tagatom.h"
+#include "bibthread.h"
+
+#define TAGATOM_NBUCKETS  (4096)
+#define TAGATOM_BLOCKSIZE (256)
+#define TAGATOM_MAXBLOCKS (4096)
+#define TAGATOM_BUFSIZE   (128)
+
+typedef struct tagatom_node {
+	char *key;
+	int id;
+	struct tagatom_node *next;
+} tagatom_node;
+
+typedef struct {
+	str name;
+	int caseid;
+} tagatom_entry;
+
+static tagatom_node  *exact_table[ TAGATOM_NBUCKETS ];  /* tag -> atom */
+static tagatom_node  *case_table[ TAGATOM_NBUCKETS ];   /* upper case tag -> case id */
+static tagatom_entry *blocks[ TAGATOM_MAXBLOCKS ];
+static int natoms = 0, ncaseids = 0;
+
+static unsigned long
+tagatom_hash( const char *s )
+{
+	unsigned long h = 2166136261UL;
+	while ( *s ) {
+		h ^= (unsigned char) *s++;
+		h *= 16777619UL;
+	}
+	return h & ( TAGATOM_NBUCKETS - 1 );
+}
+
+static int
+tagatom_lookup( tagatom_node **table, const char *key )
+{
+	tagatom_node *node;
+
+	bibl_load_acquire( node, table[ tagatom_hash( key ) ] );
+	while ( node ) {
+		if ( !strcmp( node->key, key ) ) return node->id;
+		node = node->next;
+	}
+
+	return TAGATOM_NOTFOUND;
+}
+
+/* call with the lock held */
+static tagatom_node *
+tagatom_newnode( const char *key, int id )
+{
+	tagatom_node *node;
+
+	node = ( tagatom_node * ) malloc( sizeof( tagatom_node ) );
+	if ( !node ) return NULL;
+	node->key = ( char * ) malloc( strlen( key ) + 1 );
+	if ( !node->key ) {
+		free( node );
+		return NULL;
+	}
+	strcpy( node->key, key );
+	node->id = id;
+
+	return node;
+}
+
+static void
+tagatom_freenode( tagatom_node *node )
+{
+	free( node->key );
+	free( node );
+}
+
+/* call with the lock held */
+static void
+tagatom_publish( tagatom_node **table, tagatom_node *node )
+{
+	unsigned long h = tagatom_hash( node->key );
+	node->next = table[h];
+	bibl_store_release( table[h], node );
+}
+
+/* the upper case version of 'tag' in 'buf' (of size TAGATOM_BUFSIZE), or in
+ * allocated memory if it doesn't fit; ASCII only, as strcasecmp() in the C
+ * locale
+ */
+static char *
+tagatom_upper( const char *tag, char *buf )
+{
+	size_t i, len = strlen( tag );
+	char *s = buf;
+
+	if ( len >= TAGATOM_BUFSIZE ) {
+		s = ( char * ) malloc( len + 1 );
+		if ( !s ) return NULL;
+	}
+	for ( i=0; i<len; ++i )
+		s[i] = ( tag[i]>='a' && tag[i]<='z' ) ? tag[i] - 'a' + 'A' : tag[i];
+	s[len] = '\0';
+
+	return s;
+}
+
+/* call with the lock held */
+static int
+tagatom_add( const char *tag )
+{
+	tagatom_node *node, *casenode = NULL;
+	tagatom_entry *e;
+	char buf[ TAGATOM_BUFSIZE ], *up;
+	int atom, caseid;
+
+	/* another thread may have added it in the meantime */
+	atom = tagatom_lookup( exact_table, tag );
+	if ( atom!=TAGATOM_NOTFOUND ) return atom;
+
+	atom = natoms;
+	if ( atom / TAGATOM_BLOCKSIZE >= TAGATOM_MAXBLOCKS ) return TAGATOM_MEMERR;
+	if ( !blocks[ atom / TAGATOM_BLOCKSIZE ] ) {
+		blocks[ atom / TAGATOM_BLOCKSIZE ] = ( tagatom_entry * ) calloc( TAGATOM_BLOCKSIZE, sizeof( tagatom_entry ) );
+		if ( !blocks[ atom / TAGATOM_BLOCKSIZE ] ) return TAGATOM_MEMERR;
+	}
+
+	up = tagatom_upper( tag, buf );
+	if ( !up ) return TAGATOM_MEMERR;
+
+	caseid = tagatom_lookup( case_table, up );
+	if ( caseid==TAGATOM_NOTFOUND ) {
+		casenode = tagatom_newnode( up, ncaseids );
+		if ( !casenode ) {
+			atom = TAGATOM_MEMERR;
+			goto out;
+		}
+		caseid = ncaseids;
+	}
+
+	node = tagatom_newnode( tag, atom );
+	if ( !node ) {
+		if ( casenode ) tagatom_freenode( casenode );
+		atom = TAGATOM_MEMERR;
+		goto out;
+	}
+
+	e = &( blocks[ atom / TAGATOM_BLOCKSIZE ][ atom % TAGATOM_BLOCKSIZE ] );
+	str_init( &(e->name) );
+	str_strcpyc( &(e->name), tag );
+	if ( str_memerr( &(e->name) ) ) {
+		str_free( &(e->name) );
+		tagatom_freenode( node );
+		if ( casenode ) tagatom_freenode( casenode );
+		atom = TAGATOM_MEMERR;
+		goto out;
+	}
+	e->caseid = caseid;
+
+	if ( casenode ) {
+		tagatom_publish( case_table, casenode );
+		ncaseids++;
+	}
+	tagatom_publish( exact_table, node );
+	natoms++;
+
+out:
+	if ( up!=buf ) free( up );
+	return atom;
+}
+
+/* tagatom_intern()
+ *
+ * returns the atom of 'tag', adding it if needed, or TAGATOM_MEMERR
+ */
+int
+tagatom_intern( const char *tag )
+{
+	int atom;
+
+	atom = tagatom_lookup( exact_table, tag );
+	if ( atom!=TAGATOM_NOTFOUND ) return atom;
+
+#ifdef _OPENMP
+#pragma omp critical ( tagatom )
+#endif
+	atom = tagatom_add( tag );
+
+	return atom;
+}
+
+/* tagatom_find()
+ *
+ * returns the atom of 'tag' or TAGATOM_NOTFOUND if it hasn't been interned;
+ * in the latter case no fields entry can have this tag
+ */
+int
+tagatom_find( const char *tag )
+{
+	return tagatom_lookup( exact_table, tag );
+}
+
+/* tagatom_findcase()
+ *
+ * returns the case id of 'tag', i.e. that of the atoms of the tags equal to
+ * it ignoring case, or TAGATOM_NOTFOUND if there are no such atoms
+ */
+int
+tagatom_findcase( const char *tag )
+{
+	char buf[ TAGATOM_BUFSIZE ], *up;
+	int caseid;
+
+	up = tagatom_upper( tag, buf );
+	if ( !up ) return TAGATOM_NOTFOUND;
+
+	caseid = tagatom_lookup( case_table, up );
+
+	if ( up!=buf ) free( up );
+	return caseid;
+}
+
+str *
+tagatom_str( int atom )
+{
+	return &( blocks[ atom / TAGATOM_BLOCKSIZE ][ atom % TAGATOM_BLOCKSIZE ].name );
+}
+
+int
+tagatom_case( int atom )
+{
+	return blocks[ atom / TAGATOM_BLOCKSIZE ][ atom % TAGATOM_BLOCKSIZE ].caseid;
+}
+
+static void
+tagatom_freetable( tagatom_node **table )
+{
+	tagatom_node *node, *next;
+	int i;
+
+	for ( i=0; i<TAGATOM_NBUCKETS; ++i ) {
+		node = table[i];
+		while ( node ) {
+			next = node->next;
+			tagatom_freenode( node );
+			node = next;
+		}
+		table[i] = NULL;
+	}
+}
+
+/* tagatom_free()
+ *
+ * empties the table; no fields with interned tags may exist and no other
+ * thread may use it, so call only when the package is unloaded
+ */
+void
+tagatom_free( void )
+{
+	int i, j, n;
+
+	tagatom_freetable( exact_table );
+	tagatom_freetable( case_table );
+
+	for ( i=0; i<TAGATOM_MAXBLOCKS && blocks[i]; ++i ) {
+		n = natoms - i * TAGATOM_BLOCKSIZE;
+		if ( n > TAGATOM_BLOCKSIZE ) n = TAGATOM_BLOCKSIZE;
+		for ( j=0; j<n; ++j )
+			str_free( &( blocks[i][j].name ) );
+		free( blocks[i] );
+		blocks[i] = NULL;
+	}
+
+	natoms = ncaseids = 0;
+}
@@ -0,0 +1,24 @@
+/*
+ * tagatom.h
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * Source code released under the GPL version 2
+ *
+ */
+#ifndef TAGATOM_H
+#define TAGATOM_H
+
+#include "str.h"
+
+#define TAGATOM_NOTFOUND (-1)
+#define TAGATOM_MEMERR   (-2)
+
+int  tagatom_intern( const char *tag );
+int  tagatom_find( const char *tag );
+int  tagatom_findcase( const char *tag );
+str *tagatom_str( int atom );
+int  tagatom_case( int atom );
+void tagatom_free( void );
+
+#endif
@@ -14,9 +14,6 @@
 #include "tomods.h"
 #include "args.h"
 
-extern int convert_latex_escapes_only;
-extern int export_tex_chars_only;
-
 static void
 args_tomods_help( char *progname, char *help1, char *help2 )
 {
@@ -65,6 +62,8 @@ tomods_processargs( int *argc, char *argv[], param *p,
 	int i, j, subtract, status;
 
 	process_charsets( argc, argv, p );
+	process_nthreads( argc, argv, p );
+	process_mapfiles( argc, argv, p );
 
         i = 0;
 	while ( i<*argc ) {
@@ -111,8 +110,8 @@ tomods_processargs( int *argc, char *argv[], param *p,
 			p->latexin = 0;
 			subtract = 1;
 		} else if ( args_match( argv[i], "--convert_latex_escapes", "" ) ) { // Georgi 2024-10-17
-			convert_latex_escapes_only = 1;               // see also bib2be.c
-			export_tex_chars_only = 1;  // ????? 
+			p->ctx->latex_escapes_only = 1;               // see also bib2be.c
+			p->ctx->tex_chars_only = 1;  // ????? 
 			p->latexin = 0;
 			subtract = 1;
 		} else if ( args_match( argv[i], "-nt", "--nosplit-title" ) ){
@@ -12,347 +12,267 @@
 #include "utf8.h"
 #include "unicode.h"
 
-typedef struct {
-	unsigned int value;
-	unsigned short info;
-} unicodeinfo_t;
-
-static unicodeinfo_t unicodeinfo[] = {
-	{  48, UNICODE_NUMBER }, /* 0 */
-	{  49, UNICODE_NUMBER }, /* 1 */
-	{  50, UNICODE_NUMBER }, /* 2 */
-	{  51, UNICODE_NUMBER }, /* 3 */
-	{  52, UNICODE_NUMBER }, /* 4 */
-	{  53, UNICODE_NUMBER }, /* 5 */
-	{  54, UNICODE_NUMBER }, /* 6 */
-	{  55, UNICODE_NUMBER }, /* 7 */
-	{  56, UNICODE_NUMBER }, /* 8 */
-	{  57, UNICODE_NUMBER }, /* 9 */
-	{  65, UNICODE_UPPER }, /* Latin Capital A */
-	{  66, UNICODE_UPPER }, /* Latin Capital B */
-	{  67, UNICODE_UPPER }, /* Latin Capital C */
-	{  68, UNICODE_UPPER }, /* Latin Capital D */
-	{  69, UNICODE_UPPER }, /* Latin Capital E */
-	{  70, UNICODE_UPPER }, /* Latin Capital F */
-	{  71, UNICODE_UPPER }, /* Latin Capital G */
-	{  72, UNICODE_UPPER }, /* Latin Capital H */
-	{  73, UNICODE_UPPER }, /* Latin Capital I */
-	{  74, UNICODE_UPPER }, /* Latin Capital J */
-	{  75, UNICODE_UPPER }, /* Latin Capital K */
-	{  76, UNICODE_UPPER }, /* Latin Capital L */
-	{  77, UNICODE_UPPER }, /* Latin Capital M */
-	{  78, UNICODE_UPPER }, /* Latin Capital N */
-	{  79, UNICODE_UPPER }, /* Latin Capital O */
-	{  80, UNICODE_UPPER }, /* Latin Capital P */
-	{  81, UNICODE_UPPER }, /* Latin Capital Q */
-	{  82, UNICODE_UPPER }, /* Latin Capital R */
-	{  83, UNICODE_UPPER }, /* Latin Capital S */
-	{  84, UNICODE_UPPER }, /* Latin Capital T */
-	{  85, UNICODE_UPPER }, /* Latin Capital U */
-	{  86, UNICODE_UPPER }, /* Latin Capital V */
-	{  87, UNICODE_UPPER }, /* Latin Capital W */
-	{  88, UNICODE_UPPER }, /* Latin Capital X */
-	{  89, UNICODE_UPPER }, /* Latin Capital Y */
-	{  90, UNICODE_UPPER }, /* Latin Capital Z */
-	{  97, UNICODE_LOWER }, /* Latin Small   a */
-	{  98, UNICODE_LOWER }, /* Latin Small   b */
-	{  99, UNICODE_LOWER }, /* Latin Small   c */
-	{ 100, UNICODE_LOWER }, /* Latin Small   d */
-	{ 101, UNICODE_LOWER }, /* Latin Small   e */
-	{ 102, UNICODE_LOWER }, /* Latin Small   f */
-	{ 103, UNICODE_LOWER }, /* Latin Small   g */
-	{ 104, UNICODE_LOWER }, /* Latin Small   h */
-	{ 105, UNICODE_LOWER }, /* Latin Small   i */
-	{ 106, UNICODE_LOWER }, /* Latin Small   j */
-	{ 107, UNICODE_LOWER }, /* Latin Small   k */
-	{ 108, UNICODE_LOWER }, /* Latin Small   l */
-	{ 109, UNICODE_LOWER }, /* Latin Small   m */
-	{ 110, UNICODE_LOWER }, /* Latin Small   n */
-	{ 111, UNICODE_LOWER }, /* Latin Small   o */
-	{ 112, UNICODE_LOWER }, /* Latin Small   p */
-	{ 113, UNICODE_LOWER }, /* Latin Small   q */
-	{ 114, UNICODE_LOWER }, /* Latin Small   r */
-	{ 115, UNICODE_LOWER }, /* Latin Small   s */
-	{ 116, UNICODE_LOWER }, /* Latin Small   t */
-	{ 117, UNICODE_LOWER }, /* Latin Small   u */
-	{ 118, UNICODE_LOWER }, /* Latin Small   v */
-	{ 119, UNICODE_LOWER }, /* Latin Small   w */
-	{ 120, UNICODE_LOWER }, /* Latin Small   x */
-	{ 121, UNICODE_LOWER }, /* Latin Small   y */
-	{ 122, UNICODE_LOWER }, /* Latin Small   z */
-	{ 192, UNICODE_UPPER }, /* Latin Capital A with grave */
-	{ 193, UNICODE_UPPER }, /* Latin Capital A with acute */
-	{ 194, UNICODE_UPPER }, /* Latin Capital A with circumflex */
-	{ 195, UNICODE_UPPER }, /* Latin Capital A with tilde */
-	{ 196, UNICODE_UPPER }, /* Latin Capital A with diuresis */
-	{ 197, UNICODE_UPPER }, /* Latin Capital A with ring above */
-	{ 198, UNICODE_UPPER }, /* Latin Capital AE */
-	{ 199, UNICODE_UPPER }, /* Latin Capital C with cedilla */
-	{ 200, UNICODE_UPPER }, /* Latin Capital E with grave */
-	{ 201, UNICODE_UPPER }, /* Latin Capital E with acute */
-	{ 202, UNICODE_UPPER }, /* Latin Capital E with circumflex */
-	{ 203, UNICODE_UPPER }, /* Latin Capital E with diuresis */
-	{ 204, UNICODE_UPPER }, /* Latin Capital I with grave */
-	{ 205, UNICODE_UPPER }, /* Latin Capital I with acute */
-	{ 206, UNICODE_UPPER }, /* Latin Capital I with circumflex */
-	{ 207, UNICODE_UPPER }, /* Latin Capital I with diuresis */
-	{ 208, UNICODE_UPPER }, /* Latin Capital ETH */
-	{ 209, UNICODE_UPPER }, /* Latin Capital N with tilde */
-	{ 210, UNICODE_UPPER }, /* Latin Capital O with grave */
-	{ 211, UNICODE_UPPER }, /* Latin Capital O with acute */
-	{ 212, UNICODE_UPPER }, /* Latin Capital O with circumflex */
-	{ 213, UNICODE_UPPER }, /* Latin Capital O with tilde */
-	{ 214, UNICODE_UPPER }, /* Latin Captial O with diaeresis */
-	{ 216, UNICODE_UPPER }, /* Latin Capital O with stroke */
-	{ 217, UNICODE_UPPER }, /* Latin Capital U with grave */
-	{ 218, UNICODE_UPPER }, /* Latin Capital U with acute */
-	{ 219, UNICODE_UPPER }, /* Latin Capital U with circumflex */
-	{ 220, UNICODE_UPPER }, /* Latin Capital U with diaeresis */
-	{ 221, UNICODE_UPPER }, /* Latin Capital Y with acute */
-	{ 222, UNICODE_UPPER }, /* Latin Capital THORN */
-	{ 223, UNICODE_LOWER }, /* German sz ligature */
-	{ 224, UNICODE_LOWER }, /* Latin Small   a with grave */
-	{ 225, UNICODE_LOWER }, /* Latin Small   a with acute */
-	{ 226, UNICODE_LOWER }, /* Latin Small   a with circumflex */
-	{ 227, UNICODE_LOWER }, /* Latin Small   a with tilde */
-	{ 228, UNICODE_LOWER }, /* Latin Small   a with diuresis */
-	{ 229, UNICODE_LOWER }, /* Latin Small   a with ring above */
-	{ 230, UNICODE_LOWER }, /* Latin Small   ae */
-	{ 231, UNICODE_LOWER }, /* Latin Small   c with cedilla */
-	{ 232, UNICODE_LOWER }, /* Latin Small   e with grave */
-	{ 233, UNICODE_LOWER }, /* Latin Small   e with acute */
-	{ 234, UNICODE_LOWER }, /* Latin Small   e with circumflex */
-	{ 235, UNICODE_LOWER }, /* Latin Small   e with diuresis */
-	{ 236, UNICODE_LOWER }, /* Latin Small   i with grave */
-	{ 237, UNICODE_LOWER }, /* Latin Small   i with acute */
-	{ 238, UNICODE_LOWER }, /* Latin Small   i with circumflex */
-	{ 239, UNICODE_LOWER }, /* Latin Small   i with diuresis */
-	{ 240, UNICODE_LOWER }, /* Latin Small   eth */
-	{ 241, UNICODE_LOWER }, /* Latin Small   n with tilde */
-	{ 242, UNICODE_LOWER }, /* Latin Small   o with grave */
-	{ 243, UNICODE_LOWER }, /* Latin Small   o with acute */
-	{ 244, UNICODE_LOWER }, /* Latin Small   o with circumflex */
-	{ 245, UNICODE_LOWER }, /* Latin Small   o with tilde */
-	{ 246, UNICODE_LOWER }, /* Latin Small   o with diaeresis */
-	{ 248, UNICODE_LOWER }, /* Latin Small   o with stroke */
-	{ 249, UNICODE_LOWER }, /* Latin Small   u with grave */
-	{ 250, UNICODE_LOWER }, /* Latin Small   u with acute */
-	{ 251, UNICODE_LOWER }, /* Latin Small   u with circumflex */
-	{ 252, UNICODE_LOWER }, /* Latin Small   u with diaeresis */
-	{ 253, UNICODE_LOWER }, /* Latin Small   y with acute */
-	{ 254, UNICODE_LOWER }, /* Latin Small   thorn */
-	{ 255, UNICODE_LOWER }, /* Latin Small   y with diaeresis */
-	{ 256, UNICODE_UPPER }, /* Latin Capital A with macron */
-	{ 257, UNICODE_LOWER }, /* Latin Small   a with macron */
-	{ 258, UNICODE_UPPER }, /* Latin Capital A with breve */
-	{ 259, UNICODE_LOWER }, /* Latin Small   a with breve */
-	{ 260, UNICODE_UPPER }, /* Latin Capital A with ogonek */
-	{ 261, UNICODE_LOWER }, /* Latin Small   a with ogonek */
-	{ 262, UNICODE_UPPER }, /* Latin Capital C with acute */
-	{ 263, UNICODE_LOWER }, /* Latin Small   c with acute */
-	{ 264, UNICODE_UPPER }, /* Latin Capital C with circumflex */
-	{ 265, UNICODE_LOWER }, /* Latin Small   c with circumflex */
-	{ 266, UNICODE_UPPER }, /* Latin Capital C with dot above */
-	{ 267, UNICODE_LOWER }, /* Latin Small   c with dot above */
-	{ 268, UNICODE_UPPER }, /* Latin Capital C with caron (hacek) */
-	{ 269, UNICODE_LOWER }, /* Latin Small   c with caron (hacek) */
-	{ 270, UNICODE_UPPER }, /* Latin Capital D with caron (hacek) */
-	{ 271, UNICODE_LOWER }, /* Latin Small   d with caron (hacek) */
-	{ 272, UNICODE_UPPER }, /* Latin Capital D with stroke */
-	{ 273, UNICODE_LOWER }, /* Latin Small   d with stroke */
-	{ 274, UNICODE_UPPER }, /* Latin Capital E with macron */
-	{ 275, UNICODE_LOWER }, /* Latin Small   e with macron */
-	{ 276, UNICODE_UPPER }, /* Latin Capital E with breve */
-	{ 277, UNICODE_LOWER }, /* Latin Small   e with breve */
-	{ 278, UNICODE_UPPER }, /* Latin Capital E with dot above */
-	{ 279, UNICODE_LOWER }, /* Latin Small   e with dot above */
-	{ 280, UNICODE_UPPER }, /* Latin Capital E with ogonek */
-	{ 281, UNICODE_LOWER }, /* Latin Small   e with ogonek */
-	{ 282, UNICODE_UPPER }, /* Latin Capital E with caron (hacek) */
-	{ 283, UNICODE_LOWER }, /* Latin Small   e with caron */
-	{ 284, UNICODE_UPPER }, /* Latin Capital G with circumflex */
-	{ 285, UNICODE_LOWER }, /* Latin Small   g with circumflex */
-	{ 286, UNICODE_UPPER }, /* Latin Capital G with breve */
-	{ 287, UNICODE_LOWER }, /* Latin Small   g with breve */
-	{ 288, UNICODE_UPPER }, /* Latin Capital G with dot above */
-	{ 289, UNICODE_LOWER }, /* Latin Small   g with dot above */
-	{ 290, UNICODE_UPPER }, /* Latin Capital G with cedilla */
-	{ 291, UNICODE_LOWER }, /* Latin Small   g with cedilla */
-	{ 292, UNICODE_UPPER }, /* Latin Capital H with circumflex */
-	{ 293, UNICODE_LOWER }, /* Latin Small   h with circumflex */
-	{ 294, UNICODE_UPPER }, /* Latin Capital H with stroke */
-	{ 295, UNICODE_LOWER }, /* Latin Small   h with stroke */
-	{ 296, UNICODE_UPPER }, /* Latin Capital I with tilde */
-	{ 297, UNICODE_LOWER }, /* Latin Small   i with tilde */
-	{ 298, UNICODE_UPPER }, /* Latin Capital I with macron */
-	{ 299, UNICODE_LOWER }, /* Latin Small   i with macron */
-	{ 300, UNICODE_UPPER }, /* Latin Capital I with breve */
-	{ 301, UNICODE_LOWER }, /* Latin Small   i with breve */
-	{ 302, UNICODE_UPPER }, /* Latin Capital I with ogonek */
-	{ 303, UNICODE_LOWER }, /* Latin Small   i with ogonek */
-	{ 304, UNICODE_UPPER }, /* Latin Capital I with dot above */
-	{ 305, UNICODE_LOWER }, /* Latin Small   i without dot above */
-	{ 306, UNICODE_UPPER }, /* Latin Capital IJ */
-	{ 307, UNICODE_LOWER }, /* Latin Small IJ */
-	{ 308, UNICODE_UPPER }, /* Latin Capital J with circumflex */
-	{ 309, UNICODE_LOWER }, /* Latin Small   j with circumflex */
-	{ 310, UNICODE_UPPER }, /* Latin Capital K with cedilla */
-	{ 311, UNICODE_LOWER }, /* Latin Small   j with cedilla */
-	{ 312, UNICODE_LOWER }, /* Latin Small   kra */
-	{ 313, UNICODE_UPPER }, /* Latin Capital L with acute */
-	{ 314, UNICODE_LOWER }, /* Latin Small   l with acute */
-	{ 315, UNICODE_UPPER }, /* Latin Capital L with cedilla */
-	{ 316, UNICODE_LOWER }, /* Latin Small   l with cedilla */
-	{ 317, UNICODE_UPPER }, /* Latin Capital L with caron */
-	{ 318, UNICODE_LOWER }, /* Latin Small   l with caron */
-	{ 319, UNICODE_UPPER }, /* Latin Capital L with middle dot */
-	{ 320, UNICODE_LOWER }, /* Latin Small   l with middle dot */
-	{ 321, UNICODE_UPPER }, /* Latin Capital L with stroke */
-	{ 322, UNICODE_LOWER }, /* Latin Small   l with stroke */
-	{ 323, UNICODE_UPPER }, /* Latin Capital N with acute */
-	{ 324, UNICODE_LOWER }, /* Latin Small   n with acute */
-	{ 325, UNICODE_UPPER }, /* Latin Capital N with cedilla */
-	{ 326, UNICODE_LOWER }, /* Latin Small   n with cedilla */
-	{ 327, UNICODE_UPPER }, /* Latin Capital N with caron */
-	{ 328, UNICODE_LOWER }, /* Latin Small   n with caron */
-	{ 329, UNICODE_LOWER }, /* Latin Small   n preceeded by apostrophe */
-	{ 330, UNICODE_UPPER }, /* Latin Capital Eng */
-	{ 331, UNICODE_LOWER }, /* Latin Small   eng */
-	{ 332, UNICODE_UPPER }, /* Latin Capital O with macron */
-	{ 333, UNICODE_LOWER }, /* Latin Small   o with macron */
-	{ 334, UNICODE_UPPER }, /* Latin Capital O with breve */
-	{ 335, UNICODE_LOWER }, /* Latin Small   o with breve */
-	{ 336, UNICODE_UPPER }, /* Latin Capital O with double acute */
-	{ 337, UNICODE_LOWER }, /* Latin Small   o with double acute */
-	{ 338, UNICODE_UPPER }, /* Latin Capital OE */
-	{ 339, UNICODE_LOWER }, /* Latin Small   oe */
-	{ 340, UNICODE_UPPER }, /* Latin Capital R with acute */
-	{ 341, UNICODE_LOWER }, /* Latin Small   r with acute */
-	{ 342, UNICODE_UPPER }, /* Latin Capital R with cedilla */
-	{ 343, UNICODE_LOWER }, /* Latin Small   r with cedilla */
-	{ 344, UNICODE_UPPER }, /* Latin Capital R with caron */
-	{ 345, UNICODE_LOWER }, /* Latin Small   r with caron */
-	{ 346, UNICODE_UPPER }, /* Latin Capital S with acute */
-	{ 347, UNICODE_LOWER }, /* Latin Small   s with acute */
-	{ 348, UNICODE_UPPER }, /* Latin Capital S with circumflex */
-	{ 349, UNICODE_LOWER }, /* Latin Small   s with circumflex */
-	{ 350, UNICODE_UPPER }, /* Latin Capital S with cedilla */
-	{ 351, UNICODE_LOWER }, /* Latin Small   s with cedilla */
-	{ 352, UNICODE_UPPER }, /* Latin Capital S with caron */
-	{ 353, UNICODE_LOWER }, /* Latin Small   s with caron */
-	{ 354, UNICODE_UPPER }, /* Latin Capital T with cedilla */
-	{ 355, UNICODE_LOWER }, /* Latin Small   t with cedilla */
-	{ 356, UNICODE_UPPER }, /* Latin Capital T with caron */
-	{ 357, UNICODE_LOWER }, /* Latin Small   t with caron */
-	{ 358, UNICODE_UPPER }, /* Latin Capital T with stroke */
-	{ 359, UNICODE_LOWER }, /* Latin Small   t with stroke */
-	{ 360, UNICODE_UPPER }, /* Latin Capital U with tilde */
-	{ 361, UNICODE_LOWER }, /* Latin Small   u with tilde */
-	{ 362, UNICODE_UPPER }, /* Latin Capital U with macron */
-	{ 363, UNICODE_LOWER }, /* Latin Small   u with macron */
-	{ 364, UNICODE_UPPER }, /* Latin Capital U with breve */
-	{ 365, UNICODE_LOWER }, /* Latin Small   u with breve */
-	{ 366, UNICODE_UPPER }, /* Latin Capital U with ring above */
-	{ 367, UNICODE_LOWER }, /* Latin Small   u with ring above */
-	{ 368, UNICODE_UPPER }, /* Latin Capital U with double acute */
-	{ 369, UNICODE_LOWER }, /* Latin Small   u with double acute */
-	{ 370, UNICODE_UPPER }, /* Latin Capital U with ogonek */
-	{ 371, UNICODE_LOWER }, /* Latin Small   u with ogonek */
-	{ 372, UNICODE_UPPER }, /* Latin Capital W with circumflex */
-	{ 373, UNICODE_LOWER }, /* Latin Small   w with circumflex */
-	{ 374, UNICODE_UPPER }, /* Latin Capital Y with circumflex */
-	{ 375, UNICODE_LOWER }, /* Latin Small   y with circumflex */
-	{ 376, UNICODE_UPPER }, /* Latin Capital Y with diaeresis */
-	{ 377, UNICODE_UPPER }, /* Latin Capital Z with acute */
-	{ 378, UNICODE_LOWER }, /* Latin Small   z with acute */
-	{ 379, UNICODE_UPPER }, /* Latin Capital Z with dot above */
-	{ 380, UNICODE_LOWER }, /* Latin Small   z with dot above */
-	{ 381, UNICODE_UPPER }, /* Latin Capital Z with caron */
-	{ 382, UNICODE_LOWER }, /* Latin Small   z with caron */
-	{ 383, UNICODE_LOWER }, /* Latin Small   long S */
+/* Georgi: classes of the characters of the BMP, in two stages:
+ *
+ * unicode_stage1[] gives the block of each UNICODE_BLOCKSIZE characters and
+ * unicode_stage2[] the classes in the block, 2 bits per character (see
+ * unicode_classes[]). Blocks with the same classes are stored once. This
+ * replaces a list of 268 Latin characters, which classified all other
+ * letters (Greek, Cyrillic, ...) as UNICODE_SYMBOL. Letters without case
+ * (e.g. CJK) and characters outside the BMP are still UNICODE_SYMBOL.
+ */
+#define UNICODE_BLOCKSIZE (256)
 
-	{ 461, UNICODE_UPPER }, /* Latin Capital A with caron (hacek) */
-	{ 462, UNICODE_LOWER }, /* Latin Small   a with caron (hacek) */
-	{ 463, UNICODE_UPPER }, /* Latin Capital I with caron (hacek) */
-	{ 464, UNICODE_LOWER }, /* Latin Small   i with caron (hacek) */
-	{ 465, UNICODE_UPPER }, /* Latin Capital O with caron (hacek) */
-	{ 466, UNICODE_LOWER }, /* Latin Small   o with caron (hacek) */
-	{ 467, UNICODE_UPPER }, /* Latin Capital U with caron (hacek) */
-	{ 468, UNICODE_LOWER }, /* Latin Small   u with caron (hacek) */
+/* generated by data-raw/unicode_table.py from Unicode 14.0.0 */
+#define UNICODE_NBLOCKS (34)
 
-	{ 486, UNICODE_UPPER }, /* Latin Capital G with caron */
-	{ 487, UNICODE_LOWER }, /* Latin Small   g with caron */
-	{ 488, UNICODE_UPPER }, /* Latin Capital J with caron */
-	{ 489, UNICODE_LOWER }, /* Latin Small   j with caron */
-	{ 490, UNICODE_UPPER }, /* Latin Capital O with caron */
-	{ 491, UNICODE_LOWER }, /* Latin Small   o with caron */
+static const unsigned char unicode_stage1[ 0x10000 / UNICODE_BLOCKSIZE ] = {
+	  0,   1,   2,   3,   4,   5,   6,   7,   8,   9,   9,   9,   9,   9,  10,  11,
+	 12,   8,   8,  13,   8,   8,   8,  14,  15,  16,  17,  18,  19,  20,  21,  22,
+	  8,  23,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,  24,  25,   8,   8,
+	  8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,
+	  8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,
+	  8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,
+	  8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,
+	  8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,
+	  8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,
+	  8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,
+	  8,   8,   8,   8,   8,   8,  26,  27,  28,  29,  30,  31,   8,   8,   8,   8,
+	  8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,
+	  8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,
+	  8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,
+	  8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,
+	  8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,  32,   8,   8,   8,  33,
+};
 
-	{ 500, UNICODE_UPPER }, /* Latin Capital G with acute */
-	{ 501, UNICODE_LOWER }, /* Latin Small   g with caron */
+static const unsigned char unicode_stage2[ UNICODE_NBLOCKS ][ UNICODE_BLOCKSIZE / 4 ] = {
+	{ /* 0 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00,
+		0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0xa8, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x2a, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x55, 0x95, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x2a, 0xaa, 0xaa,
+	},
+	{ /* 1 */
+		0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x66, 0x66,
+		0x66, 0x66, 0x9a, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x65, 0xa6,
+		0x96, 0x59, 0x56, 0x5a, 0x65, 0x59, 0xa9, 0x65, 0x99, 0x59, 0xa6, 0x59, 0x56, 0x66, 0x29, 0xa9,
+		0x00, 0x65, 0x59, 0x66, 0x66, 0x66, 0x66, 0x9a, 0x99, 0x99, 0x99, 0x99, 0x96, 0x59, 0x99, 0x99,
+	},
+	{ /* 2 */
+		0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0xaa, 0x5a, 0x96,
+		0x66, 0x95, 0x99, 0x99, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 3 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x99, 0x90, 0x80, 0x4a,
+		0x00, 0x10, 0x15, 0x51, 0x56, 0x55, 0x55, 0x55, 0x45, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0x6a, 0x5a, 0xa9, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0xaa, 0x49, 0x96, 0x56,
+	},
+	{ /* 4 */
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+		0x09, 0x00, 0x90, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+		0x65, 0x66, 0x66, 0xa6, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	},
+	{ /* 5 */
+		0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x54, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x00, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 6 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00,
+	},
+	{ /* 7 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 8 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 9 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 10 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 11 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 12 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x45, 0x00, 0x04, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x2a, 0xa8,
+	},
+	{ /* 13 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0xaa, 0x0a,
+	},
+	{ /* 14 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 15 */
+		0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 16 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0xf0, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 17 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0xff, 0xff, 0x0f, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 18 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 19 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0xff, 0xff, 0x0f, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0xaa, 0xaa, 0x02, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x54,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 20 */
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xaa, 0xaa, 0xaa, 0xa8, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x2a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 21 */
+		0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+		0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+		0x99, 0x99, 0x99, 0x99, 0x99, 0xa9, 0xaa, 0x9a, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+		0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	},
+	{ /* 22 */
+		0xaa, 0xaa, 0x55, 0x55, 0xaa, 0x0a, 0x55, 0x05, 0xaa, 0xaa, 0x55, 0x55, 0xaa, 0xaa, 0x55, 0x55,
+		0xaa, 0x0a, 0x55, 0x05, 0xaa, 0xaa, 0x44, 0x44, 0xaa, 0xaa, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0x0a,
+		0xaa, 0xaa, 0x55, 0x55, 0xaa, 0xaa, 0x55, 0x55, 0xaa, 0xaa, 0x55, 0x55, 0xaa, 0xa2, 0x55, 0x21,
+		0xa0, 0xa2, 0x55, 0x01, 0xaa, 0xa0, 0x55, 0x00, 0xaa, 0xaa, 0x55, 0x01, 0xa0, 0xa2, 0x55, 0x01,
+	},
+	{ /* 23 */
+		0x10, 0x40, 0x60, 0xa5, 0x95, 0x04, 0x54, 0x05, 0x00, 0x11, 0x51, 0x85, 0x55, 0x02, 0x08, 0x5a,
+		0x00, 0xa4, 0x0a, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x40, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 24 */
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x59, 0x69, 0x66, 0x56, 0x99, 0xa6, 0xaa, 0x50,
+		0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+		0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x02, 0x40, 0x26, 0x90, 0x00, 0x00, 0x00,
+	},
+	{ /* 25 */
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x8a, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 26 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x09, 0x00, 0x00, 0x00, 0x00,
+		0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 27 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x90, 0x99, 0x99, 0x99, 0x9a, 0x99, 0x99, 0x99,
+		0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0xa8, 0xaa, 0x66, 0x96,
+		0x99, 0x99, 0x40, 0x26, 0x99, 0x9a, 0x99, 0x99, 0x99, 0x99, 0x59, 0x95, 0x55, 0x99, 0x99, 0x99,
+		0x99, 0x55, 0x26, 0x00, 0x89, 0x98, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x24, 0x20, 0x00,
+	},
+	{ /* 28 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 29 */
+		0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00,
+	},
+	{ /* 30 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 31 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x2a, 0x00, 0xaa, 0xaa, 0x02, 0x00, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00,
+	},
+	{ /* 32 */
+		0xaa, 0x2a, 0x00, 0x00, 0x80, 0xaa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{ /* 33 */
+		0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x00, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00,
+		0xa8, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x2a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
 };
+/* end of generated part */
 
-static int nunicodeinfo = sizeof( unicodeinfo ) / sizeof( unicodeinfo[0] );
+static const unsigned short unicode_classes[4] = {
+	UNICODE_SYMBOL, UNICODE_UPPER, UNICODE_LOWER, UNICODE_NUMBER
+};
 
-static int
-unicode_find( unsigned int unicode_character )
+static unsigned short
+unicode_class( unsigned int unicode_character )
 {
-	int min = 0, max = nunicodeinfo, mid;
-	// REprintf("nunicodeinfo = %d\n", nunicodeinfo);
-	//
-    
-	while ( min < max ) {
-		mid = ( min + max ) / 2;
-		if ( unicodeinfo[mid].value < unicode_character )
-			min = mid + 1;
-		else
-			max = mid;
-	}
-	//	REprintf("nunicodeinfo = %d,\tunicode_character = %d,\tmin = %d,\tmax = %d\n", nunicodeinfo, unicode_character, min, max);
-	//
-        // Georgi: this addresses the following in v1.2
-        //
-        // TODO:  cp1251 chars are mostly around 1080,  while nunicodeinfo = 268
-        //        There may be a bug, maybe for cp1251 another table should be used?
-        // 
-        //     > ## Can't have files with different encodings in the package, so below
-        //     > ## first convert a UTF-8 file to something else.
-        //     > ##
-        //     > ## input here contains cyrillic (UTF-8) output to Windows Cyrillic,
-        //     > ## notice the "no_latex" option
-        //     > a <- bibConvert(fn_cyr_utf8, bib, encoding = c("utf8", "cp1251"), tex
-        //    = "no_latex")
-        //    unicode.c:302:36: runtime error: index 268 out of bounds for type
-        //    'unicodeinfo_t [268]'
-        //         #0 0x7ff1f5e003a3 in unicode_find
-        //    /data/gannet/ripley/R/packages/incoming/rbibutils.Rcheck/00_pkg_src/rbibutils/src/unicode.c:302
-        //    ...
-        //    unicode.c:302:41: runtime error: load of address 0x7ff1f63860e0 with
-        //    insufficient space for an object of type 'unsigned int'
-        //    ...
-        //    =================================================================
-        //    ==3935511==ERROR: AddressSanitizer: global-buffer-overflow on address
-        //    0x7ff1f63860e0 at pc 0x7ff1f5e002ae bp 0x7fff9a67dde0 sp 0x7fff9a67ddd0
-        //    READ of size 4 at 0x7ff1f63860e0 thread T0
-        //         #0 0x7ff1f5e002ad in unicode_find
-        //    /data/gannet/ripley/R/packages/incoming/rbibutils.Rcheck/00_pkg_src/rbibutils/src/unicode.c:302
-	//
-	// check min < nunicodeinfo in case min = nunicodeinfo
-	//    was: if ( ( max==min ) && ( unicodeinfo[min].value == unicode_character ) )
-	if( ( min < nunicodeinfo ) && ( max==min ) && ( unicodeinfo[min].value == unicode_character ) )
-		return min;
-	else
-		return -1;
+	unsigned int b, i;
+	if ( unicode_character >= 0x10000 ) return UNICODE_SYMBOL;
+	b = unicode_stage1[ unicode_character / UNICODE_BLOCKSIZE ];
+	i = unicode_character % UNICODE_BLOCKSIZE;
+	return unicode_classes[ ( unicode_stage2[b][i/4] >> ( 2 * ( i%4 ) ) ) & 3 ];
 }
 
 unsigned short
 unicode_utf8_classify( char *p )
 {
 	unsigned int unicode_character, pos = 0;
-	int n;
 	unicode_character = utf8_decode( p, &pos );
-	n = unicode_find( unicode_character );
-	if ( n==-1 ) return UNICODE_SYMBOL;
-	else return unicodeinfo[n].info;
+	return unicode_class( unicode_character );
 }
 
 unsigned short
@@ -360,12 +280,9 @@ unicode_utf8_classify_str( str *s )
 {
 	unsigned int unicode_character, pos = 0;
 	unsigned short value = 0;
-	int n;
 	while ( pos < s->len ) {
 		unicode_character = utf8_decode( str_cstr( s ), &pos );
-		n = unicode_find( unicode_character );
-		if ( n==-1 ) value |= UNICODE_SYMBOL;
-		else value |= unicodeinfo[n].info;
+		value |= unicode_class( unicode_character );
 	}
 	return value;
 }
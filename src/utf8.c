@@ -92,38 +92,121 @@ utf8_encode_str( unsigned int value, char outstr[7] )
 	outstr[n] = '\0';
 }
 
+/* Georgi: number of bytes of the character at s, 0 if it is not a valid,
+ * shortest form UTF-8 character of U+0000..U+10FFFF (Unicode, Table 3-7)
+ * other than a surrogate. A character cut short by the terminating '\0' is
+ * not valid, so s is not read beyond it.
+ */
+int
+utf8_charlen( const char *s )
+{
+	const unsigned char *u = ( const unsigned char * ) s;
+	unsigned char lo = 0x80, hi = 0xBF;
+	int i, n;
+
+	if ( u[0] < 0x80 ) return 1;
+	else if ( u[0] < 0xC2 ) return 0;
+	else if ( u[0] < 0xE0 ) n = 2;
+	else if ( u[0] < 0xF0 ) {
+		n = 3;
+		if ( u[0]==0xE0 ) lo = 0xA0;       /* overlong */
+		else if ( u[0]==0xED ) hi = 0x9F;  /* surrogates */
+	} else if ( u[0] < 0xF5 ) {
+		n = 4;
+		if ( u[0]==0xF0 ) lo = 0x90;       /* overlong */
+		else if ( u[0]==0xF4 ) hi = 0x8F;  /* above U+10FFFF */
+	} else return 0;
+
+	if ( u[1] < lo || u[1] > hi ) return 0;
+	for ( i=2; i<n; ++i )
+		if ( ( u[i] & 0xC0 ) != 0x80 ) return 0;
+
+	return n;
+}
+
+/* Georgi: length of the longest prefix of s[0..len-1] made of valid UTF-8
+ * characters other than '\0' (len if that is all of it), see utf8_charlen().
+ * Runs of ASCII are skipped eight bytes at a time. s has to be '\0'
+ * terminated (s[len]=='\0').
+ */
+unsigned long
+utf8_validate( const char *s, unsigned long len )
+{
+	const unsigned long long high = 0x8080808080808080ULL;
+	const unsigned long long ones = 0x0101010101010101ULL;
+	unsigned long long w;
+	unsigned long i = 0;
+	int n;
+
+	while ( i < len ) {
+		if ( i + 8 <= len ) {
+			memcpy( &w, s + i, 8 );
+			/* no byte >= 128 and no '\0' */
+			if ( !( w & high ) && !( ( w - ones ) & ~w & high ) ) {
+				i += 8;
+				continue;
+			}
+		}
+		n = utf8_charlen( s + i );
+		if ( n==0 || s[i]=='\0' ) break;
+		i += n;
+	}
+
+	return i;
+}
+
+/* The continuation bytes are checked, so that a character cut short (e.g. by
+ * the terminating '\0') gives '?' and the next character starts at the byte
+ * that is not a continuation byte.
+ */
 unsigned int
 utf8_decode( const char *s, unsigned int *pi )
 {
 	unsigned int c;
-	int i = *pi;
+	int i = *pi, n, k;
+
+	if ((s[i] & 128)== 0 ) n = 1;
+	else if ((s[i] & 224)== 192 ) n = 2;      /* 110xxxxx & 111xxxxx == 110xxxxx */
+	else if ((s[i] & 240)== 224 ) n = 3;      /* 1110xxxx & 1111xxxx == 1110xxxx */
+	else if ((s[i] & 248)== 240 ) n = 4;      /* 11110xxx & 11111xxx == 11110xxx */
+	else if ((s[i] & 252)== 248 ) n = 5;      /* 111110xx & 111111xx == 111110xx */
+	else if ((s[i] & 254)== 252 ) n = 6;      /* 1111110x & 1111111x == 1111110x */
+	else n = 0;
+
+	for ( k=1; k<n; ++k ) {
+		if ( ( s[i+k] & 192 ) != 128 ) {
+			n = 0;
+			break;
+		}
+	}
+
 	/* one digit utf-8 */
-	if ((s[i] & 128)== 0 ) {
+	if ( n==1 ) {
 		c = (unsigned int) s[i];
 		i += 1;
-	} else if ((s[i] & 224)== 192 ) { /* 110xxxxx & 111xxxxx == 110xxxxx */
+	} else if ( n==2 ) {
 		c = (( (unsigned int) s[i] & 31 ) << 6) +
 			( (unsigned int) s[i+1] & 63 );
 		i += 2;
-	} else if ((s[i] & 240)== 224 ) { /* 1110xxxx & 1111xxxx == 1110xxxx */
+	} else if ( n==3 ) {
 		c = ( ( (unsigned int) s[i] & 15 ) << 12 ) + 
 			( ( (unsigned int) s[i+1] & 63 ) << 6 ) +
 		 	( (unsigned int) s[i+2] & 63 );
 		i += 3;
-	} else if ((s[i] & 248)== 240 ) { /* 11110xxx & 11111xxx == 11110xxx */
+	} else if ( n==4 ) {
 		c =  ( ( (unsigned int) s[i] & 7 ) << 18 ) +
 			( ( (unsigned int) s[i+1] & 63 ) << 12 ) +
 			( ( (unsigned int) s[i+2] & 63 ) << 6 ) +
 			( (unsigned int) s[i+3] & 63 );
 		i+= 4;
-	} else if ((s[i] & 252)== 248 ) { /* 111110xx & 111111xx == 111110xx */
+	} else if ( n==5 ) {
 		c = ( ( (unsigned int) s[i] & 3 ) << 24 ) +
 			( ( (unsigned int) s[i+1] & 63 ) << 18 ) +
 			( ( (unsigned int) s[i+2] & 63 ) << 12 ) +
 			( ( (unsigned int) s[i+3] & 63 ) << 6 ) +
 			( (unsigned int) s[i+4] & 63 );
 		i += 5;
-	} else if ((s[i] & 254)== 252 ) { /* 1111110x & 1111111x == 1111110x */
+	} else if ( n==6 ) {
 		c = ( ( (unsigned int) s[i] & 1 ) << 30 ) + 
 			( ( (unsigned int) s[i+1] & 63 ) << 24 ) +
 			( ( (unsigned int) s[i+2] & 63 ) << 18 ) +
@@ -14,6 +14,8 @@
 int          utf8_encode( unsigned int value, unsigned char out[6] );
 void         utf8_encode_str( unsigned int value, char outstr[7] );
 unsigned int utf8_decode( const char *s, unsigned int *pi );
+int          utf8_charlen( const char *s );
+unsigned long utf8_validate( const char *s, unsigned long len );
 void         utf8_writebom( FILE *outptr );
 int          utf8_is_bom( const char *p );
 int          utf8_is_emdash( const char *p );
@@ -14,9 +14,10 @@
 #include "fields.h"
 #include "xml.h"
 #include "xml_encoding.h"
+#include "xml_split.h"
 #include "bibformats.h"
 
-static int wordin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset );
+static int wordin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm );
 static int wordin_processf( fields *wordin, const char *data, const char *filename, long nref, param *p );
 
 
@@ -63,49 +64,13 @@ wordin_initparams( param *pm, const char *progname )
  PUBLIC: int wordin_readf()
 *****************************************************/
 
-static char *
-wordin_findstartwrapper( char *buf, int *ntype )
-{
-	return xml_find_start( buf, "b:Source" );
-}
-
-static char *
-wordin_findendwrapper( char *buf, int ntype )
-{
-	return xml_find_end( buf, "b:Source" );
-}
+static char *wordin_tags[] = { "b:Source" };
 
 static int
-wordin_readf( FILE *fp, char *buf, int bufsize, int *bufpos, str *line, str *reference, int *fcharset )
+wordin_readf( freader *fr, str *line, str *reference, int *fcharset, param *pm )
 {
-	str tmp;
-	char *startptr = NULL, *endptr;
-	int haveref = 0, inref = 0, file_charset = CHARSET_UNKNOWN, m, type = 1;
-	str_init( &tmp );
-	while ( !haveref && str_fget( fp, buf, bufsize, bufpos, line ) ) {
-		if ( str_cstr( line ) ) {
-			m = xml_getencoding( line );
-			if ( m!=CHARSET_UNKNOWN ) file_charset = m;
-		}
-		if ( str_cstr( line ) ) {
-			startptr = wordin_findstartwrapper( str_cstr( line ), &type );
-		}
-		if ( startptr || inref ) {
-			if ( inref ) str_strcat( &tmp, line );
-			else {
-				str_strcatc( &tmp, startptr );
-				inref = 1;
-			}
-			endptr = wordin_findendwrapper( str_cstr( &tmp ), type );
-			if ( endptr ) {
-				str_segcpy( reference, str_cstr( &tmp ), endptr );
-				haveref = 1;
-			}
-		}
-	}
-	str_free( &tmp );
-	*fcharset = file_charset;
-	return haveref;
+	int ntag;
+	return xml_split_record( fr, wordin_tags, 1, XML_SPLIT_JOINLINES, reference, &ntag, fcharset );
 }
 
 /*****************************************************
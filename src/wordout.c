@@ -428,7 +428,7 @@ output_name_type( fields *info, FILE *outptr, int level, char *map[], int nmap,
 	nfields = fields_num( info );
 	for ( j=0; j<nmap; ++j ) {
 		for ( i=0; i<nfields; ++i ) {
-			code = extract_name_and_info( &ntag, &(info->tag[i]) );
+			code = extract_name_and_info( &ntag, fields_tag( info, i, FIELDS_STRP_NOUSE ) );
 			if ( strcasecmp( str_cstr( &ntag ), map[j] ) ) continue;
 			if ( n==0 )
 				fprintf( outptr, "<%s><b:NameList>\n", tag );
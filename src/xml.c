@@ -16,8 +16,6 @@
 #include "strsearch.h"
 #include "xml.h"
 
-char *xml_pns = NULL;
-
 void
 xml_init( xml *node )
 {
@@ -25,15 +23,32 @@ xml_init( xml *node )
 	str_init( &(node->value) );
 	slist_init( &(node->attributes) );
 	slist_init( &(node->attribute_values) );
-	node->down = NULL;
-	node->next = NULL;
+	node->down    = NULL;
+	node->next    = NULL;
+	node->pns     = NULL;
+	node->mem     = NULL;
+	node->inarena = 0;
+	node->lname   = -1;
 }
 
+/* xml_new()
+ *
+ * Georgi: the nodes made by xml_parse() are taken from the arena of the
+ * node it was called for, so a record is parsed without a malloc() for each
+ * node and freed in one go; from the heap if there is no arena (mem==NULL)
+ */
 static xml *
-xml_new( void )
+xml_new( arena *mem )
 {
-	xml *node = ( xml * ) malloc( sizeof( xml ) );
-	if ( node ) xml_init( node );
+	xml *node;
+
+	if ( mem ) node = ( xml * ) arena_alloc( mem, sizeof( xml ) );
+	else       node = ( xml * ) malloc( sizeof( xml ) );
+	if ( node ) {
+		xml_init( node );
+		node->mem     = mem;
+		node->inarena = ( mem!=NULL );
+	}
 	return node;
 }
 
@@ -41,7 +56,21 @@ static void
 xml_delete( xml *node )
 {
 	xml_free( node );
-	free( node );
+	if ( !node->inarena ) free( node );
+}
+
+/* the array of an attribute list in the arena (see xml_setattributes())
+ * is left to the arena, its strings are freed in case one was changed and
+ * so moved to the heap
+ */
+static void
+xml_free_attributes( slist *a )
+{
+	slist_index i;
+
+	for ( i=0; i<a->n; ++i )
+		str_free( &(a->strs[i]) );
+	slist_init( a );
 }
 
 void
@@ -49,10 +78,55 @@ xml_free( xml *node )
 {
 	str_free( &(node->tag) );
 	str_free( &(node->value) );
-	slist_free( &(node->attributes) );
-	slist_free( &(node->attribute_values) );
+	if ( node->inarena ) {
+		xml_free_attributes( &(node->attributes) );
+		xml_free_attributes( &(node->attribute_values) );
+	} else {
+		slist_free( &(node->attributes) );
+		slist_free( &(node->attribute_values) );
+	}
 	if ( node->down ) xml_delete( node->down );
 	if ( node->next ) xml_delete( node->next );
+	if ( node->mem && !node->inarena ) {
+		arena_delete( node->mem );
+		node->mem = NULL;
+	}
+}
+
+/* xml_setstr()
+ *
+ * copy p[0..q-p) without the characters equal to 'skip' (if not '\0') to
+ * s, into the arena mem if not too short for the small buffer of s
+ */
+static void
+xml_setstr( arena *mem, str *s, const char *p, const char *q, char skip )
+{
+	const char *r;
+	char *buf = NULL;
+	str tmp;
+
+	if ( skip && ( r = memchr( p, skip, q - p ) ) ) {
+		/* the usual case: the closing quote ends the value */
+		if ( r==q-1 ) q--;
+		else {
+			str_init( &tmp );
+			for ( ; p<q; ++p )
+				if ( *p!=skip ) str_addchar( &tmp, *p );
+			if ( tmp.len ) xml_setstr( mem, s, tmp.data, tmp.data + tmp.len, '\0' );
+			else str_segtoarena( s, p, p, NULL );
+			str_free( &tmp );
+			return;
+		}
+	}
+
+	if ( (unsigned long) ( q - p ) + 1 > STR_SMALLSIZE ) {
+		if ( mem ) buf = ( char * ) arena_alloc( mem, q - p + 1 );
+		if ( !buf ) {
+			str_segcpy( s, (char *) p, (char *) q );
+			return;
+		}
+	}
+	str_segtoarena( s, p, q, buf );
 }
 
 enum {
@@ -82,46 +156,127 @@ xml_is_terminator( const char *p, int *type )
 	return 0;
 }
 
+/* the attributes of the tag being processed, as spans of the input; the
+ * characters of a value equal to its 'quote' are not part of it
+ */
+typedef struct xml_attrib {
+	const char *name, *name_end;
+	const char *value, *value_end;
+	char quote;
+} xml_attrib;
+
+typedef struct xml_attribs {
+	xml_attrib *a;
+	int n, max;
+} xml_attribs;
+
+static void
+xml_add_attribute( xml_attribs *attribs, const char *name, const char *name_end,
+		const char *value, const char *value_end, char quote )
+{
+	xml_attrib *more;
+	int alloc;
+
+	if ( attribs->n==attribs->max ) {
+		alloc = ( attribs->max ) ? attribs->max * 2 : 8;
+		more = ( xml_attrib * ) realloc( attribs->a, sizeof( xml_attrib ) * alloc );
+		if ( !more ) return;
+		attribs->a   = more;
+		attribs->max = alloc;
+	}
+
+	attribs->a[attribs->n].name      = name;
+	attribs->a[attribs->n].name_end  = name_end;
+	attribs->a[attribs->n].value     = value;
+	attribs->a[attribs->n].value_end = value_end;
+	attribs->a[attribs->n].quote     = quote;
+	attribs->n++;
+}
+
+/* as slist_addc() would leave a->sorted (empty strings sort first) */
 static int
-xml_add_attribute( xml *node, char *attribute, char *attribute_value  )
+xml_attributes_sorted( slist *a )
 {
-	int status;
-
-	if ( attribute )
-		status = slist_addc( &(node->attributes), attribute );
-	else
-		status = slist_addc( &(node->attributes), "" );
-	if ( status!=SLIST_OK ) return 0;
-
-	if ( attribute_value )
-		status = slist_addc( &(node->attribute_values), attribute_value );
-	else
-		status = slist_addc( &(node->attribute_values), "" );
-	if ( status!=SLIST_OK ) {
-		(void) slist_remove( &(node->attributes), node->attributes.n-1 );
-		return 0;
+	slist_index i;
+	str *s1, *s2;
+
+	for ( i=1; i<a->n; ++i ) {
+		s1 = &(a->strs[i-1]);
+		s2 = &(a->strs[i]);
+		if ( !s2->len ) {
+			if ( s1->len ) return 0;
+		} else if ( s1->len && strcmp( s1->data, s2->data ) > 0 ) return 0;
 	}
 	return 1;
 }
 
+/* xml_setattributes()
+ *
+ * Georgi: copy the attributes found by xml_processattrib() to node; for a
+ * node in the arena both lists are put in one array from the arena, else
+ * they are added as by slist_addc()
+ */
+static void
+xml_setattributes( xml *node, xml_attribs *attribs )
+{
+	xml_attrib *at;
+	str *strs, name, value;
+	int i, n = attribs->n;
+
+	if ( n==0 ) return;
+
+	if ( node->inarena ) {
+		strs = ( str * ) arena_alloc( node->mem, sizeof( str ) * 2 * n );
+		if ( !strs ) return;
+		for ( i=0; i<n; ++i ) {
+			at = &(attribs->a[i]);
+			str_init( &(strs[i]) );
+			str_init( &(strs[n+i]) );
+			xml_setstr( node->mem, &(strs[i]), at->name, at->name_end, '\0' );
+			xml_setstr( node->mem, &(strs[n+i]), at->value, at->value_end, at->quote );
+		}
+		node->attributes.strs = strs;
+		node->attributes.n = node->attributes.max = n;
+		node->attributes.sorted = xml_attributes_sorted( &(node->attributes) );
+		node->attribute_values.strs = strs + n;
+		node->attribute_values.n = node->attribute_values.max = n;
+		node->attribute_values.sorted = xml_attributes_sorted( &(node->attribute_values) );
+		return;
+	}
+
+	strs_init( &name, &value, NULL );
+	for ( i=0; i<n; ++i ) {
+		at = &(attribs->a[i]);
+		xml_setstr( NULL, &name, at->name, at->name_end, '\0' );
+		xml_setstr( NULL, &value, at->value, at->value_end, at->quote );
+		if ( slist_add( &(node->attributes), &name )!=SLIST_OK ) break;
+		if ( slist_add( &(node->attribute_values), &value )!=SLIST_OK ) {
+			(void) slist_remove( &(node->attributes), node->attributes.n-1 );
+			break;
+		}
+	}
+	strs_free( &name, &value, NULL );
+}
+
+/* xml_processattrib()
+ *
+ * the attributes are recorded in attribs, if not NULL
+ */
 static const char *
-xml_processattrib( const char *p, xml *node, int *type )
+xml_processattrib( const char *p, xml_attribs *attribs, int *type )
 {
 	char quote_character = '\"';
 	int inquotes = 0;
-	str aname, aval;
-
-	str_init( &aname );
-	str_init( &aval );
+	const char *name, *name_end, *value;
 
 	while ( *p && !xml_is_terminator( p, type ) ) {
 
 		/* get attribute name */
 		while ( *p==' ' || *p=='\t' ) p++;
-		while ( *p && !strchr( "= \t", *p ) && !xml_is_terminator( p, type ) ){
-			str_addchar( &aname, *p );
+		name = p;
+		while ( *p && !strchr( "= \t", *p ) && !xml_is_terminator( p, type ) )
 			p++;
-		}
+		name_end = p;
 
 		/* equals sign */
 		while ( *p==' ' || *p=='\t' ) p++;
@@ -134,25 +289,36 @@ xml_processattrib( const char *p, xml *node, int *type )
 			inquotes=1;
 			p++;
 		}
+		value = p;
 		while ( *p && ((!xml_is_terminator(p,type) && !strchr("= \t", *p ))||inquotes)){
 			if ( *p==quote_character ) inquotes=0;
-			else str_addchar( &aval, *p );
 			p++;
 		}
-		if ( str_has_value( &aname ) ) {
-			xml_add_attribute( node, str_cstr( &aname ), str_cstr( &aval ) );
-		}
-
-		str_empty( &aname );
-		str_empty( &aval );
+		if ( attribs && name_end > name )
+			xml_add_attribute( attribs, name, name_end, value, p, quote_character );
 	}
 
-	str_free( &aname );
-	str_free( &aval );
-
 	return p;
 }
 
+/* xml_setlname()
+ *
+ * Georgi: resolve the namespace prefix once, when the tag is read, so
+ * xml_tag_matches() need not build "pns:tag" for each comparison
+ */
+static void
+xml_setlname( xml *node )
+{
+	unsigned long n;
+
+	node->lname = -1;
+	if ( !node->pns ) return;
+	n = strlen( node->pns );
+	if ( node->tag.len > n && node->tag.data[n]==':' &&
+			!strncasecmp( node->tag.data, node->pns, n ) )
+		node->lname = n + 1;
+}
+
 /*
  * xml_processtag
  *
@@ -163,13 +329,16 @@ xml_processattrib( const char *p, xml *node, int *type )
  * 	XML_OPEN         <A>
  * 	XML_CLOSE        </A>
  * 	XML_OPENCLOSE    <A/>
+ *
+ * Georgi: node is NULL for XML_COMMENT and XML_CLOSE, which make no nodes
  */
 static const char *
-xml_processtag( const char *p, xml *node, int *type )
+xml_processtag( const char *p, xml *node, xml_attribs *attribs, int *type )
 {
-	str tag;
+	const char *tag = p, *tag_end = p;
 
-	str_init( &tag );
+	attribs->n = 0;
+	if ( !node ) attribs = NULL;
 
 	if ( *p=='!' ) {
 		*type = XML_COMMENT;
@@ -178,77 +347,81 @@ xml_processtag( const char *p, xml *node, int *type )
 	else if ( *p=='?' ) {
 		*type = XML_DESCRIPTOR;
 		p++; /* skip '?' */
-		while ( *p && !strchr( " \t", *p ) && !xml_is_terminator(p,type) )
-			str_addchar( &tag, *p++ );
+		tag = p;
+		while ( *p && !strchr( " \t", *p ) && !xml_is_terminator(p,type) ) p++;
+		tag_end = p;
 		if ( *p==' ' || *p=='\t' )
-			p = xml_processattrib( p, node, type );
+			p = xml_processattrib( p, attribs, type );
 	}
 	else if ( *p=='/' ) {
 		*type = XML_CLOSE;
-		while ( *p && !strchr( " \t", *p ) && !xml_is_terminator(p,type) )
-			str_addchar( &tag, *p++ );
+		while ( *p && !strchr( " \t", *p ) && !xml_is_terminator(p,type) ) p++;
 		if ( *p==' ' || *p=='\t' ) 
-			p = xml_processattrib( p, node, type );
+			p = xml_processattrib( p, attribs, type );
 	}
 	else {
 		*type = XML_OPEN;
-		while ( *p && !strchr( " \t", *p ) && !xml_is_terminator(p,type) )
-			str_addchar( &tag, *p++ );
+		while ( *p && !strchr( " \t", *p ) && !xml_is_terminator(p,type) ) p++;
+		tag_end = p;
 		if ( *p==' ' || *p=='\t' ) 
-			p = xml_processattrib( p, node, type );
+			p = xml_processattrib( p, attribs, type );
 	}
 	while ( *p && *p!='>' ) p++;
 	if ( *p=='>' ) p++;
 
-	str_strcpy( &(node->tag), &tag );
-
-	str_free( &tag );
+	if ( node ) {
+		if ( tag_end > tag ) xml_setstr( node->mem, &(node->tag), tag, tag_end, '\0' );
+		xml_setlname( node );
+		if ( attribs ) xml_setattributes( node, attribs );
+	}
 
 	return p;
 }
 
-static void
-xml_appendnode( xml *onode, xml *nnode )
-{
-	if ( !onode->down ) onode->down = nnode;
-	else {
-		xml *p = onode->down;
-		while ( p->next ) p = p->next;
-		p->next = nnode;
-	}
-}
-
-const char *
-xml_parse( const char *p, xml *onode )
+static const char *
+xml_parse_node( const char *p, xml *onode, xml_attribs *attribs )
 {
 	int type, is_style = 0;
-	xml *nnode;
+	xml *nnode, *last;
+	const char *q;
 
-	while ( *p ) {
+	/* retain white space for <style> tags in endnote xml */
+	if ( str_cstr( &(onode->tag) ) &&
+		!strcasecmp( str_cstr( &(onode->tag) ),"style") ) is_style=1;
 
-		/* retain white space for <style> tags in endnote xml */
-		if ( str_cstr( &(onode->tag) ) &&
-			!strcasecmp( str_cstr( &(onode->tag) ),"style") ) is_style=1;
+	/* Georgi: append to the list of children in constant time */
+	last = onode->down;
+	while ( last && last->next ) last = last->next;
 
-		while ( *p && *p!='<' ) {
-			if ( onode->value.len>0 || is_style || !is_ws( *p ) )
-				str_addchar( &(onode->value), *p );
-			p++;
+	while ( *p ) {
+
+		q = strchr( p, '<' );
+		if ( !q ) q = p + strlen( p );
+		if ( onode->value.len==0 && !is_style )
+			while ( p<q && is_ws( *p ) ) p++;
+		if ( p<q ) {
+			if ( onode->value.len==0 ) xml_setstr( onode->mem, &(onode->value), p, q, '\0' );
+			else str_segcat( &(onode->value), (char *) p, (char *) q );
+			p = q;
 		}
 
 		if ( *p=='<' ) {
-			nnode = xml_new();
-			p = xml_processtag( p+1, nnode, &type );
+			if ( p[1]=='!' || p[1]=='/' ) nnode = NULL;
+			else {
+				nnode = xml_new( onode->mem );
+				if ( !nnode ) goto out;
+				nnode->pns = onode->pns;
+			}
+			p = xml_processtag( p+1, nnode, attribs, &type );
 			if ( type==XML_OPEN || type==XML_OPENCLOSE || type==XML_DESCRIPTOR ) {
-				xml_appendnode( onode, nnode );
+				if ( last ) last->next = nnode;
+				else onode->down = nnode;
+				last = nnode;
 				if ( type==XML_OPEN )
-					p = xml_parse( p, nnode );
+					p = xml_parse_node( p, nnode, attribs );
 			} else if ( type==XML_CLOSE ) {
 				/*check to see if it's closing for this one*/
-				xml_delete( nnode );
 				goto out; /* assume it's right for now */
-			} else {
-				xml_delete( nnode );
 			}
 		}
 
@@ -257,6 +430,135 @@ out:
 	return p;
 }
 
+/* xml_parse()
+ *
+ * Georgi: the nodes made for the elements in p, with their tags, values and
+ * attribute lists, are allocated from an arena owned by onode, freed by
+ * xml_free( onode )
+ */
+const char *
+xml_parse( const char *p, xml *onode )
+{
+	xml_attribs attribs;
+
+	if ( !onode->mem ) onode->mem = arena_new();
+
+	attribs.a   = NULL;
+	attribs.n   = 0;
+	attribs.max = 0;
+
+	p = xml_parse_node( p, onode, &attribs );
+
+	free( attribs.a );
+
+	return p;
+}
+
+/* xml_sax_parse()
+ *
+ * Georgi: parse p without building the tree. h->start() is called when an
+ * element starts, h->end() when it ends, with the element as a node
+ * without children: its tag and attributes in start(), also its value (as
+ * xml_parse() would give it) in end(). depth is 1 for the elements at the
+ * top. The nodes are reused, a handler must copy what it needs to keep.
+ * A handler returning non-zero stops the parse, which returns that value;
+ * returns -1 if out of memory, else 0.
+ */
+int
+xml_sax_parse( const char *p, xml_sax *h )
+{
+	int type, depth = 0, max = 0, status = 0, *is_style = NULL, *more_style;
+	xml_attribs attribs;
+	xml **stack = NULL, **more, *node;
+	const char *q;
+
+	attribs.a   = NULL;
+	attribs.n   = 0;
+	attribs.max = 0;
+
+	while ( *p ) {
+
+		q = strchr( p, '<' );
+		if ( !q ) q = p + strlen( p );
+		if ( depth ) {
+			node = stack[depth-1];
+			if ( node->value.len==0 && !is_style[depth-1] )
+				while ( p<q && is_ws( *p ) ) p++;
+			if ( p<q ) {
+				if ( node->value.len==0 ) xml_setstr( NULL, &(node->value), p, q, '\0' );
+				else str_segcat( &(node->value), (char *) p, (char *) q );
+			}
+		}
+		p = q;
+		if ( *p!='<' ) break;
+
+		if ( p[1]=='!' || p[1]=='/' ) {
+			p = xml_processtag( p+1, NULL, &attribs, &type );
+			if ( type!=XML_CLOSE ) continue;
+			/* as in xml_parse(), assume it closes the current element */
+			if ( depth==0 ) break;
+			status = h->end( stack[depth-1], depth, h->data );
+			depth--;
+			if ( status ) goto out;
+			continue;
+		}
+
+		if ( depth==max ) {
+			status = -1;
+			more = ( xml ** ) realloc( stack, sizeof( xml * ) * ( max + 16 ) );
+			if ( !more ) goto out;
+			stack = more;
+			more_style = ( int * ) realloc( is_style, sizeof( int ) * ( max + 16 ) );
+			if ( !more_style ) goto out;
+			status = 0;
+			is_style = more_style;
+			while ( max < depth + 16 ) stack[max++] = NULL;
+		}
+		if ( !stack[depth] ) {
+			stack[depth] = xml_new( NULL );
+			if ( !stack[depth] ) {
+				status = -1;
+				goto out;
+			}
+		}
+		node = stack[depth];
+		str_empty( &(node->tag) );
+		str_empty( &(node->value) );
+		slist_empty( &(node->attributes) );
+		slist_empty( &(node->attribute_values) );
+
+		p = xml_processtag( p+1, node, &attribs, &type );
+
+		/* retain white space for <style> tags in endnote xml */
+		is_style[depth] = ( node->tag.len && !strcasecmp( str_cstr( &(node->tag) ), "style" ) );
+
+		depth++;
+		status = h->start( node, depth, h->data );
+		if ( status ) goto out;
+		if ( type!=XML_OPEN ) {
+			status = h->end( node, depth, h->data );
+			depth--;
+			if ( status ) goto out;
+		}
+	}
+
+	/* elements not closed end with the input */
+	while ( depth ) {
+		status = h->end( stack[depth-1], depth, h->data );
+		depth--;
+		if ( status ) goto out;
+	}
+
+out:
+	for ( depth=0; depth<max; ++depth )
+		if ( stack[depth] ) xml_delete( stack[depth] );
+	free( stack );
+	free( is_style );
+	free( attribs.a );
+
+	return status;
+}
+
 void
 xml_draw( xml *node, int n )
 {
@@ -306,10 +608,7 @@ xml_find_end( char *buffer, char *tag )
 	str endtag;
 	char *p;
 
-	if ( xml_pns )
-		str_initstrsc( &endtag, "</", xml_pns, ":", tag, ">", NULL );
-	else
-		str_initstrsc( &endtag, "</", tag, ">", NULL );
+	str_initstrsc( &endtag, "</", tag, ">", NULL );
 
 	p = strsearch( buffer, str_cstr( &endtag ) );
 	if ( p && *p ) {
@@ -328,24 +627,18 @@ xml_tag_matches_simple( xml* node, const char *tag )
 	if ( strcasecmp( str_cstr( &(node->tag) ), tag ) ) return 0;
 	return 1;
 }
+/* Georgi: the prefix was checked by xml_setlname(), compare the local name */
 static int
 xml_tag_matches_pns( xml* node, const char *tag )
 {
-	int found = 0;
-	str pnstag;
-
-	str_initstrsc( &pnstag, xml_pns, ":", tag, NULL );
-	if ( node->tag.len==pnstag.len &&
-			!strcasecmp( str_cstr( &(node->tag) ), str_cstr( &pnstag ) ) )
-		found = 1;
-	str_free( &pnstag );
-
-	return found;
+	if ( node->lname < 0 ) return 0;
+	if ( strcasecmp( node->tag.data + node->lname, tag ) ) return 0;
+	return 1;
 }
 int
 xml_tag_matches( xml *node, const char *tag )
 {
-	if ( xml_pns ) return xml_tag_matches_pns   ( node, tag );
+	if ( node->pns ) return xml_tag_matches_pns   ( node, tag );
 	else           return xml_tag_matches_simple( node, tag );
 }
 
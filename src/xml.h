@@ -11,6 +11,7 @@
 
 #include "slist.h"
 #include "str.h"
+#include "arena.h"
 
 typedef struct xml {
 	str tag;
@@ -19,8 +20,23 @@ typedef struct xml {
 	slist attribute_values;
 	struct xml *down;
 	struct xml *next;
+	const char *pns; /* namespace prefix for xml_tag_matches(), inherited
+	                    by the nodes created by xml_parse() (Georgi: this
+	                    replaces the global xml_pns) */
+	arena *mem;      /* Georgi: the arena of the nodes made by xml_parse(),
+	                    owned by the node passed to it */
+	int inarena;     /* Georgi: the node and its attribute lists are in mem */
+	int lname;       /* Georgi: offset of the local name in tag if tag has
+	                    the prefix pns, else -1; set by the parser */
 } xml;
 
+/* Georgi: the handlers of xml_sax_parse() */
+typedef struct xml_sax {
+	int (*start)( xml *node, int depth, void *data );
+	int (*end)  ( xml *node, int depth, void *data );
+	void *data;
+} xml_sax;
+
 void   xml_init                 ( xml *node );
 void   xml_free                 ( xml *node );
 int    xml_has_value            ( xml *node );
@@ -36,8 +52,7 @@ char * xml_find_end             ( char *buffer, char *tag );
 int    xml_tag_has_attribute    ( xml *node, const char *tag, const char *attribute, const char *attribute_value );
 int    xml_has_attribute        ( xml *node, const char *attribute, const char *attribute_value );
 const char * xml_parse                ( const char *p, xml *onode );
-
-extern char * xml_pns; /* global Namespace */
+int    xml_sax_parse            ( const char *p, xml_sax *h );
 
 #endif
 
@@ -21,14 +21,7 @@
 #include "bibformats.h"
 #include "args.h"
 #include "bibprog.h"
-
-extern int convert_latex_escapes_only;
-extern int export_tex_chars_only;
-
-extern void bibdirectin_more_cleanf( void );
-
-char **journals;
-int njournals;
+#include "bibentrysexp.h"
 
 void
 help_xml2bibtex( char *progname )
@@ -291,6 +284,11 @@ process_args( int *argc, char *argv[], param *p, const char *progname[] )
 	  	} else if ( args_match( argv[i], "-nl", "--no-latex" ) ) {
 	  		p->latexout = 0;
 	  		subtract = 1;
+	  	} else if ( args_match( argv[i], "--export_tex_chars", "" ) ) {
+	  		// 2026-10-17 new: any2xml_main() with --convert_latex_escapes used
+	  		//     to leave this on (in a global variable) for xml2any_main()
+	  		p->ctx->tex_chars_only = 1;
+	  		subtract = 1;
 	  	} else if ( args_match( argv[i], "-nb", "--no-bom" ) ) {
 	  		p->utf8bom = 0;
 	  		subtract = 1;
@@ -318,8 +316,8 @@ process_args( int *argc, char *argv[], param *p, const char *progname[] )
 	  while ( i<*argc ) {
 	  	subtract = 0;
 		if ( args_match( argv[i], "--journals", "" ) ) {
-		  njournals = *argc - i - 1;
-		  journals = argv + i + 1;
+		  p->ctx->njournals = *argc - i - 1;
+		  p->ctx->journals = argv + i + 1;
 		  break;
 	  	} else if ( args_match( argv[i], "-h", "--help" )) {
 		        help_xml2ads( p->progname );
@@ -412,6 +410,13 @@ xml2any_main( int *argc, char *argv[], char *outfile[], double *nref )
         const char *progname = argv[0];
 
       	param p;
+	bibl_context ctx;
+
+	bibl_initcontext( &ctx );
+	p.ctx = &ctx;
+	p.nthreads = 1;
+	p.mapfiles = 0;
+	p.direct = 0;
 	modsin_initparams( &p, progname );
 
 	if(strcmp(progname, "xml2bib") == 0){
@@ -452,8 +457,8 @@ xml2any_main( int *argc, char *argv[], char *outfile[], double *nref )
 	  // !!! :TODO: !!! temporary fix to prevent exportint '\' as
 	  // '\backslash', '{' as '\{', '}' as '\}' and use a few other fixes
 	  // for latex escape characters, initially done for 'direct'
-	  convert_latex_escapes_only = 1;
-	  export_tex_chars_only = 1;
+	  ctx.latex_escapes_only = 1;
+	  ctx.tex_chars_only = 1;
 	  
 	}else {
 	  bibl_freeparams( &p );
@@ -461,11 +466,53 @@ xml2any_main( int *argc, char *argv[], char *outfile[], double *nref )
 	}
 	
 	process_charsets( argc, argv, &p );
+	process_nthreads( argc, argv, &p );
+	process_mapfiles( argc, argv, &p );
 
 	process_args( argc, argv, &p, &progname );         // process_args( &argc, argv, &p );
 
 	*nref = bibprog( argc[0], argv, &p, outfile );   // bibprog( argc, argv, &p );
 
 	bibl_freeparams( &p );
-	bibdirectin_more_cleanf(); // 2024-10-13 new; patch after fixing  \ => {\backslash} etc.
+	bibl_freecontext( &ctx );
+}
+
+// 2026-10-17 new: xml2bibentry returning the bibentry() calls as an expression
+//     vector (see bibentrysexp.c), instead of writing them to a file
+SEXP
+xml2any_bibentry( SEXP argvin )
+{
+	int argc;
+	char **argv = bibentry_sexp_argv( argvin, &argc );
+	const char *progname = argv[0];
+	param p;
+	bibl_context ctx;
+	SEXP res;
+
+	if ( strcmp( progname, "xml2bibentry" ) != 0 )
+		error("xml2any_bibentry: expected xml2bibentry, got %s", progname);
+
+	bibl_initcontext( &ctx );
+	p.ctx = &ctx;
+	p.nthreads = 1;
+	p.mapfiles = 0;
+	p.direct = 0;
+	modsin_initparams( &p, progname );
+	bibentryout_initparams( &p, progname );
+	// see the corresponding comment in xml2any_main()
+	ctx.latex_escapes_only = 1;
+	ctx.tex_chars_only = 1;
+
+	process_charsets( &argc, argv, &p );
+	process_nthreads( &argc, argv, &p );
+	process_mapfiles( &argc, argv, &p );
+	process_args( &argc, argv, &p, &progname );
+
+	PROTECT( res = bibprog_bibentry( argc, argv, &p ) );
+
+	bibl_freeparams( &p );
+	bibl_freecontext( &ctx );
+
+	UNPROTECT( 1 );
+	return res;
 }
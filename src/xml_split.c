@@ -0,0 +1,125 @@
+/*
+ * xml_split.c
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * Source code released under the GPL version 2
+ *
+ * Splits XML input into records (e.g. <mods>...</mods>) for the readf()
+ * functions of the XML formats. The lines are appended to a buffer and
+ * each search for the start or end tag continues where the previous one
+ * stopped (less the length of the tag, which may be split between lines),
+ * so a record is split in time linear in its size, not quadratic as when
+ * the whole buffer was searched after each line.
+ *
+ * The text after the end tag is pushed back to the reader and starts the
+ * next record.
+ *
+ */
+#include <string.h>
+#include "strsearch.h"
+#include "xml.h"
+#include "xml_encoding.h"
+#include "charsets.h"
+#include "xml_split.h"
+
+#define XML_SPLIT_PIECE (8192)
+
+/* xml_split_record()
+ *
+ * Reads the next record, starting with one of the tags[0..ntags) and ending
+ * with the matching end tag, into 'reference'. The tags are tried in order,
+ * as by xml_find_start(), so the first one found anywhere wins; *ntag is set
+ * to its index.
+ *
+ * The encoding declaration (<?xml ... encoding="..."?>) is looked for in
+ * the text before the record (so in practice once per file, at the top)
+ * and returned in *fcharset, CHARSET_UNKNOWN if none.
+ *
+ * In mode XML_SPLIT_JOINLINES the lines are joined without their ends, as
+ * they were by the str_fget() loops of the readers, in XML_SPLIT_KEEPEOL
+ * they are kept.
+ *
+ * returns 1 if a record was found, 0 at end of file
+ */
+int
+xml_split_record( freader *fr, char *tags[], int ntags, int mode, str *reference, int *ntag, int *fcharset )
+{
+	unsigned long from = 0, lastlen, taglen, overlap = 0;
+	long start = -1;
+	int i, found = 0, tag = -1;
+	const char *line;
+	unsigned long n, neol;
+	char *p = NULL;
+	str buf, prefix, endtag;
+
+	*fcharset = CHARSET_UNKNOWN;
+	str_empty( reference );
+
+	/* a tag split between lines starts at most this far before the new line */
+	for ( i=0; i<ntags; ++i ) {
+		taglen = strlen( tags[i] ) + 3;
+		if ( taglen > overlap ) overlap = taglen;
+	}
+
+	strs_init( &buf, &prefix, &endtag, NULL );
+
+	while ( 1 ) {
+
+		if ( !freader_nextline( fr, &line, &n, &neol ) ) break;
+
+		/* take a long line (e.g. a file on one line) in pieces, so the
+		 * rest of it is not copied for each record */
+		if ( n > XML_SPLIT_PIECE ) {
+			freader_unread( fr, XML_SPLIT_PIECE );
+			n    = XML_SPLIT_PIECE;
+			neol = 0;
+		}
+		if ( mode!=XML_SPLIT_KEEPEOL ) neol = 0;
+		if ( n + neol==0 ) continue;
+
+		lastlen = buf.len;
+		str_segcat( &buf, (char *) line, (char *) line + n + neol );
+
+		if ( start < 0 ) {
+			for ( i=0; i<ntags && !p; ++i ) {
+				p = xml_find_start( buf.data + from, tags[i] );
+				if ( p ) tag = i;
+			}
+			if ( !p ) {
+				from = ( buf.len > overlap ) ? buf.len - overlap : 0;
+				continue;
+			}
+			start = p - buf.data;
+			from  = start + 1;
+			/* the end tag is looked for after each line, build it once */
+			str_mergestrs( &endtag, "</", tags[tag], ">", NULL );
+			if ( str_memerr( &endtag ) ) break;
+		}
+
+		/* as xml_find_end(), which builds the end tag for each call */
+		p = strsearch( buf.data + from, str_cstr( &endtag ) );
+		if ( p ) {
+			p += endtag.len;
+			found = 1;
+			break;
+		}
+		if ( buf.len > from + overlap ) from = buf.len - overlap;
+	}
+
+	if ( found ) {
+		/* the end tag is in the last line (piece), the rest of it is for the next record */
+		freader_unread( fr, ( p - buf.data ) - lastlen );
+
+		if ( start > 0 ) {
+			str_segcpy( &prefix, buf.data, buf.data + start );
+			*fcharset = xml_getencoding( &prefix );
+		}
+		str_segcpy( reference, buf.data + start, p );
+		*ntag = tag;
+	}
+
+	strs_free( &buf, &prefix, &endtag, NULL );
+
+	return found;
+}
@@ -0,0 +1,20 @@
+/*
+ * xml_split.h
+ *
+ * Copyright (c) Georgi N. Boshnakov 2026
+ *
+ * Source code released under the GPL version 2
+ *
+ */
+#ifndef XML_SPLIT_H
+#define XML_SPLIT_H
+
+#include "str.h"
+#include "freader.h"
+
+#define XML_SPLIT_JOINLINES (0) /* the lines of a record are joined without their ends */
+#define XML_SPLIT_KEEPEOL   (1) /* the ends of lines are kept */
+
+int xml_split_record( freader *fr, char *tags[], int ntags, int mode, str *reference, int *ntag, int *fcharset );
+
+#endif